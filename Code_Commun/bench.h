@@ -0,0 +1,55 @@
+#ifndef BENCH_H_INCLUDED
+#define BENCH_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file bench.h
+	\brief Marqueurs pour le banc de mesure en simulation (tools/bench)
+
+	Compilé avec -DBENCH, BENCH_MARK(id) écrit id dans GPIOR0. Ce registre d'usage
+	général n'est relié à aucune broche: l'écriture ne change rien au comportement du
+	programme, mais le simulateur la voit passer et note le cycle où elle a lieu.
+
+	Sans BENCH, la macro ne génère aucun code.
+
+	Ce fichier est aussi lu par le banc de mesure (programme Linux): il ne doit inclure
+	aucun fichier propre à l'AVR. GPIOR0 doit être défini par <avr/io.h> dans le fichier
+	qui utilise la macro.
+*/
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+typedef enum{
+
+	BENCH_MARK_NONE = 0,
+	BENCH_MARK_LOOP,		/* début d'un tour de la boucle principale */
+	BENCH_MARK_FRAME		/* trame reçue (grue) ou envoyée (manette) */
+
+}bench_mark_e;
+
+#ifdef BENCH
+#define BENCH_MARK(id)	(GPIOR0 = (id))
+#else
+#define BENCH_MARK(id)	((void)0)
+#endif
+
+#endif /* BENCH_H_INCLUDED */
@@ -0,0 +1,82 @@
+#ifndef BOARD_H_INCLUDED
+#define BOARD_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file board.h
+	\brief Configuration de la carte pour les pilotes communs
+
+	Les pilotes de Code_Commun sont compilés dans les deux projets. Chaque projet fournit
+	son board_config.h, trouvé par le chemin d'inclusion du projet, qui choisit:
+
+	- les pilotes compilés: BOARD_HAS_PWM0, BOARD_HAS_PWM2 (0 ou 1);
+	- les options des pilotes: BOARD_HAS_PROFILE (zones de profile.h dans uart.c et
+	  lcd.c), BOARD_UART_EOL_TIME (uart_get_eol_time()), BOARD_UART_BUS (caractères de 9
+	  bits et adresses sur UART_0, voir uart.h), BOARD_ADC_NOISE_REDUCTION;
+	- le brochage: BOARD_ADC_PINS et les broches BOARD_LCD_*;
+	- la taille des tampons de l'UART: UART_n_RX_BUFFER_SIZE et UART_n_TX_BUFFER_SIZE.
+
+	Pendant une conversion, adc_read() endort le processeur en mode SLEEP_MODE_IDLE, ou
+	en mode SLEEP_MODE_ADC (réduction du bruit de l'ADC) avec BOARD_ADC_NOISE_REDUCTION à
+	1. Ce dernier mode arrête aussi l'horloge des entrées/sorties: le compteur 1 perd la
+	durée de la conversion (environ 200 µs, donc la base de temps retarde), et un octet
+	en cours d'envoi sur un UART est corrompu.
+
+	Ce fichier vérifie que tout est défini et remplace les macros du profilage par des
+	macros vides sur une carte qui n'en a pas.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include "board_config.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#if !defined(BOARD_HAS_PWM0) || !defined(BOARD_HAS_PWM2)
+#error "Les pilotes de la carte ne sont pas choisis (board_config.h)"
+#endif
+
+#if !defined(BOARD_HAS_PROFILE) || !defined(BOARD_UART_EOL_TIME) || !defined(BOARD_UART_BUS) || \
+	!defined(BOARD_ADC_NOISE_REDUCTION)
+#error "Les options des pilotes ne sont pas choisies (board_config.h)"
+#endif
+
+#if !defined(BOARD_ADC_PINS) || !defined(BOARD_LCD_DATA_PORT) || !defined(BOARD_LCD_CTRL_PORT)
+#error "Le brochage de la carte n'est pas défini (board_config.h)"
+#endif
+
+#if !defined(UART_0_RX_BUFFER_SIZE) || !defined(UART_0_TX_BUFFER_SIZE) || \
+	!defined(UART_1_RX_BUFFER_SIZE) || !defined(UART_1_TX_BUFFER_SIZE)
+#error "La taille des tampons de l'UART n'est pas définie (board_config.h)"
+#endif
+
+#if BOARD_HAS_PROFILE
+#include "profile.h"
+#else
+#define PROFILE_BEGIN(zone)			do{}while(0)
+#define PROFILE_END(zone)			do{}while(0)
+#endif
+
+#endif /* BOARD_H_INCLUDED */
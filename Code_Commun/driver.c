@@ -35,19 +35,35 @@ Includes
 ---------------------------------------------------------------------------- */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "driver.h"
+#include "idle.h"
+
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Mode de veille pendant une conversion (voir BOARD_ADC_NOISE_REDUCTION dans board.h) */
+#if BOARD_ADC_NOISE_REDUCTION
+#define ADC_SLEEP_MODE	SLEEP_MODE_ADC
+#else
+#define ADC_SLEEP_MODE	SLEEP_MODE_IDLE
+#endif
 
 
 /* ----------------------------------------------------------------------------
 Function definition
 ---------------------------------------------------------------------------- */
 
+/* Fin de conversion: ne sert qu'à réveiller le processeur dans adc_read() */
+EMPTY_INTERRUPT(ADC_vect);
+
+
 void adc_init(void){
 
-	// 1-Configuration des broches du port A à mettre en entrée
-	DDRA = clear_bit(DDRA, PA0);  //Décommenter pour utiliser
-	DDRA = clear_bit(DDRA, PA1);  //Décommenter pour utiliser
-	DDRA = clear_bit(DDRA, PA2); //Décommenter pour utiliser
+	// 1-Configuration des broches du port A à mettre en entrée (board_config.h)
+	DDRA = clear_bits(DDRA, BOARD_ADC_PINS);
 	
 	
 	// 2-Sélectionner la référence de tension: la tension d'alimentation
@@ -59,8 +75,9 @@ void adc_init(void){
 	ADMUX = set_bit(ADMUX, ADLAR);
 	
 	// 4-Choisir le facteur de division de l'horloge
-	// ( L'horloge l'ADC ne doit pas dépasser 200kHz. Avec une horloge de 8MHZ, ça
-	// prend une division d'horloge de min 40. Donc 64 ou 128) */
+	// ( L'horloge l'ADC doit rester entre 50 et 200kHz pour 10 bits. Avec une horloge de
+	// 8MHZ, ça prend une division d'horloge de min 40. Donc 64 ou 128) */
+	_Static_assert((F_CPU / 128 >= 50000UL) && (F_CPU / 128 <= 200000UL), "La division par 128 sort l'horloge de l'ADC de 50 à 200 kHz à F_CPU");
 	ADCSRA = set_bit(ADCSRA, ADPS2);
 	ADCSRA = set_bit(ADCSRA, ADPS1);
 	ADCSRA = set_bit(ADCSRA, ADPS0);
@@ -78,12 +95,33 @@ uint8_t adc_read(uint8_t canal){
 	// 2-Démarrage d'une conversion
 	ADCSRA = set_bit(ADCSRA, ADSC);
 
-	// 3-Attente de la fin de conversion
+	// 3-Attente de la fin de conversion, en veille si les interruptions sont actives:
+	// l'interruption de fin de conversion réveille le processeur
+	if (read_bit(SREG, SREG_I)){
+
+		ADCSRA = set_bit(ADCSRA, ADIE);
+
+		while (read_bit(ADCSRA, ADSC) == 1){
+
+			cli();
+
+			if (read_bit(ADCSRA, ADSC) == 1){
+
+				idle_sleep(ADC_SLEEP_MODE);
+			}
+
+			sei();
+		}
+
+		ADCSRA = clear_bit(ADCSRA, ADIE);
+	}
+
 	while (read_bit(ADCSRA, ADSC) ==1);
 	// 4-Lecture et renvoi du résultat
 	return ADCH;
 }
 
+#if BOARD_HAS_PWM0
 void pwm0_init(void){
 
 	// 1-Configuration des broches de sortie (PB4 et PB3)
@@ -124,45 +162,80 @@ void pwm0_set_PB4(uint8_t duty){
 	OCR0B = duty;
 }
 
-void pwm1_init(uint16_t top){	
-	
-	// broches de PWM en sortie
-	DDRD = set_bit(DDRD, PD4);
-	DDRD = set_bit(DDRD, PD5);
+void pwm0_set_frequency(pwm_frequency_e frequency){
+
+	// Mode du compteur: Fast PWM (WGM01:0 = 11) ou PWM phase correct (WGM01:0 = 01)
+	if((frequency == PWM_FREQUENCY_FAST_1) || (frequency == PWM_FREQUENCY_FAST_8)){
+
+		TCCR0A = set_bit(TCCR0A, WGM01);
+	}
+
+	else{
+
+		TCCR0A = clear_bit(TCCR0A, WGM01);
+	}
+
+	TCCR0A = set_bit(TCCR0A, WGM00);
+
+	// Facteur de division: 1 (CS02:0 = 001) ou 8 (CS02:0 = 010)
+	if((frequency == PWM_FREQUENCY_FAST_1) || (frequency == PWM_FREQUENCY_PHASE_1)){
+
+		TCCR0B = write_bits(TCCR0B, 0b00000111, 0b00000001);
+	}
+
+	else{
+
+		TCCR0B = write_bits(TCCR0B, 0b00000111, 0b00000010);
+	}
+}
+
+
+void pwm0_connect_PB3(bool connect){
+
+	// COM0A1:0 = 10 (non inversé) ou 00 (broche pilotée par PORTB, laissée à 0)
+	PORTB = clear_bit(PORTB, PB3);
+	TCCR0A = write_bit(TCCR0A, COM0A1, connect ? 1 : 0);
+}
+
+
+void pwm0_connect_PB4(bool connect){
+
+	// COM0B1:0 = 10 (non inversé) ou 00 (broche pilotée par PORTB, laissée à 0)
+	PORTB = clear_bit(PORTB, PB4);
+	TCCR0A = write_bit(TCCR0A, COM0B1, connect ? 1 : 0);
+}
+#endif /* BOARD_HAS_PWM0 */
+
+void pwm1_init(void){
 	
-	//Clear OCnA/OCnB on Compare Match, set OCnA/OCnB at BOTTOM (non-inverting mode)
-	TCCR1A=set_bit(TCCR1A,COM1A1);
+	// OC1A et OC1B déconnectés: le servomoteur de la grue branche OC1A lui-même (voir servo.c)
+	TCCR1A=clear_bit(TCCR1A,COM1A1);
 	TCCR1A=clear_bit(TCCR1A,COM1A0);
-	TCCR1A=set_bit(TCCR1A,COM1B1);
+	TCCR1A=clear_bit(TCCR1A,COM1B1);
 	TCCR1A=clear_bit(TCCR1A,COM1B0);
 	
-	// Fast PWM mode (avec valeur TOP fixé par ICR1)
-	TCCR1B=set_bit(TCCR1B,WGM13);
-	TCCR1B=set_bit(TCCR1B,WGM12);
-	TCCR1A=set_bit(TCCR1A,WGM11);
+	// Mode normal: le compteur tourne librement de 0 à 0xFFFF, OCR1x sans double tampon
+	TCCR1B=clear_bit(TCCR1B,WGM13);
+	TCCR1B=clear_bit(TCCR1B,WGM12);
+	TCCR1A=clear_bit(TCCR1A,WGM11);
 	TCCR1A=clear_bit(TCCR1A,WGM10);
 
 	// valeur initiale du compteur à 0
 	TCNT1=0;
 
-	// fixer la valeur maximale (TOP) du compteur 2	
-	ICR1 = top;			
+	// premier tick de 1 ms sur la comparaison B
+	OCR1B = PWM1_TICK_PAS;
+	TIFR1 = set_bit(0, OCF1B);
+	TIMSK1 = set_bit(TIMSK1, OCIE1B);
 	
-	// activer l'horloge avec facteur de division par 8
+	// activer l'horloge avec facteur de division par 8 (1 µs par pas à 8 MHz)
+	_Static_assert(PWM1_DIVISION == 8, "CS12:0 = 010 divise par 8");
 	TCCR1B=clear_bit(TCCR1B,CS12);
 	TCCR1B=set_bit(TCCR1B,CS11);
 	TCCR1B=clear_bit(TCCR1B,CS10);
-	
-	TIMSK1 = set_bit(TIMSK1, TOIE1);
-}
-
-void pwm1_set_PD5(uint16_t limit){
-	OCR1A = limit;
-}
-void pwm1_set_PD4(uint16_t limit){
-	OCR1B = limit;
 }
 
+#if BOARD_HAS_PWM2
 void pwm2_init(){
 	// broches de PWM en sortie
 	DDRD = set_bit(DDRD, PD6);
@@ -199,4 +272,46 @@ void pwm2_set_PD6(uint8_t limit){
 	OCR2B = limit;
 }
 
+void pwm2_set_frequency(pwm_frequency_e frequency){
+
+	// Mode du compteur: Fast PWM (WGM21:0 = 11) ou PWM phase correct (WGM21:0 = 01)
+	if((frequency == PWM_FREQUENCY_FAST_1) || (frequency == PWM_FREQUENCY_FAST_8)){
+
+		TCCR2A = set_bit(TCCR2A, WGM21);
+	}
+
+	else{
+
+		TCCR2A = clear_bit(TCCR2A, WGM21);
+	}
+
+	TCCR2A = set_bit(TCCR2A, WGM20);
+
+	// Facteur de division: 1 (CS22:0 = 001) ou 8 (CS22:0 = 010)
+	if((frequency == PWM_FREQUENCY_FAST_1) || (frequency == PWM_FREQUENCY_PHASE_1)){
+
+		TCCR2B = write_bits(TCCR2B, 0b00000111, 0b00000001);
+	}
+
+	else{
+
+		TCCR2B = write_bits(TCCR2B, 0b00000111, 0b00000010);
+	}
+}
+
+
+void pwm2_connect_PD6(bool connect){
+
+	// COM2B1:0 = 10 (non inversé) ou 00 (broche pilotée par PORTD, laissée à 0)
+	PORTD = clear_bit(PORTD, PD6);
+	TCCR2A = write_bit(TCCR2A, COM2B1, connect ? 1 : 0);
+}
 
+
+void pwm2_connect_PD7(bool connect){
+
+	// COM2A1:0 = 10 (non inversé) ou 00 (broche pilotée par PORTD, laissée à 0)
+	PORTD = clear_bit(PORTD, PD7);
+	TCCR2A = write_bit(TCCR2A, COM2A1, connect ? 1 : 0);
+}
+#endif /* BOARD_HAS_PWM2 */
@@ -30,8 +30,70 @@
 Includes
 ---------------------------------------------------------------------------- */
 
+#include "board.h"
 #include "utils.h"
 
+/* ----------------------------------------------------------------------------
+Defines
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Période du tick généré par la comparaison B du compteur 1, en µs
+*/
+#define PWM1_TICK_US	1000
+
+/**
+    \brief Facteur de division du compteur 1 et nombre de ses pas par milliseconde
+
+	Un pas dure 1 µs à 8 MHz. Les échéances du compteur 1 se calculent avec PWM1_US(), et
+	une différence de TCNT1 se ramène en µs avec PWM1_PAS_EN_US(): les deux ne font rien
+	quand un pas vaut 1 µs.
+*/
+#define PWM1_DIVISION		8
+#define PWM1_PAS_PAR_MS		(F_CPU / PWM1_DIVISION / 1000UL)
+
+#if PWM1_PAS_PAR_MS == 1000
+#define PWM1_US(us)			(us)
+#define PWM1_PAS_EN_US(pas)	(pas)
+#else
+#define PWM1_US(us)			((uint16_t)((uint32_t)(us) * PWM1_PAS_PAR_MS / 1000UL))
+#define PWM1_PAS_EN_US(pas)	((uint16_t)((uint32_t)(pas) * 1000UL / PWM1_PAS_PAR_MS))
+#endif
+
+/* Période du tick en pas du compteur 1 */
+#define PWM1_TICK_PAS		PWM1_US(PWM1_TICK_US)
+
+_Static_assert(F_CPU % (PWM1_DIVISION * 1000UL) == 0, "Le tick de 1 ms doit être un nombre entier de pas du compteur 1 à F_CPU");
+_Static_assert(PWM1_PAS_PAR_MS * PWM1_TICK_US / 1000UL < 0x8000, "Le tick doit tenir dans la moitié du cercle de 16 bits du compteur 1 à F_CPU");
+
+/**
+    \brief Modes et facteurs de division MLI des compteurs 8 bits 0 et 2
+
+	Les deux compteurs ont les mêmes codes de division pour 1 et 8, et un TOP de 0xFF
+	puisque leurs deux unités de comparaison sont des sorties MLI: la fréquence suit
+	F_CPU. PWM_FREQUENCY_HZ() donne la fréquence d'un réglage, PWM_FREQUENCY_MIN() le
+	réglage le plus lent qui atteint une fréquence voulue. Les fréquences indiquées sont
+	pour une horloge de 8 MHz.
+*/
+typedef enum{
+
+	PWM_FREQUENCY_FAST_1 = 0,	/* Fast PWM, division par 1 : F_CPU / 256, 31,4 kHz, inaudible */
+	PWM_FREQUENCY_PHASE_1,		/* PWM phase correct, division par 1 : F_CPU / 510, 15,7 kHz */
+	PWM_FREQUENCY_FAST_8,		/* Fast PWM, division par 8 : F_CPU / 2048, 3,9 kHz */
+	PWM_FREQUENCY_PHASE_8		/* PWM phase correct, division par 8 : F_CPU / 4080, 1,96 kHz */
+
+}pwm_frequency_e;
+
+#define PWM_FREQUENCY_HZ(frequency)	((frequency) == PWM_FREQUENCY_FAST_1 ? F_CPU / 256UL :		\
+									(frequency) == PWM_FREQUENCY_PHASE_1 ? F_CPU / 510UL :		\
+									(frequency) == PWM_FREQUENCY_FAST_8 ? F_CPU / 2048UL : F_CPU / 4080UL)
+
+/* Réglage le plus lent d'au moins hz, PWM_FREQUENCY_FAST_1 si aucun ne l'atteint */
+#define PWM_FREQUENCY_MIN(hz)		(PWM_FREQUENCY_HZ(PWM_FREQUENCY_PHASE_8) >= (hz) ? PWM_FREQUENCY_PHASE_8 :	\
+									PWM_FREQUENCY_HZ(PWM_FREQUENCY_FAST_8) >= (hz) ? PWM_FREQUENCY_FAST_8 :		\
+									PWM_FREQUENCY_HZ(PWM_FREQUENCY_PHASE_1) >= (hz) ? PWM_FREQUENCY_PHASE_1 :	\
+									PWM_FREQUENCY_FAST_1)
+
 /* ----------------------------------------------------------------------------
 Prototypes
 ---------------------------------------------------------------------------- */
@@ -40,7 +102,8 @@ Prototypes
     \brief Initialise le module de l'ADC
     \return rien.
 
-	Le module de l'ADC utilise le PORT A. 
+	Le module de l'ADC utilise le PORT A. Les broches BOARD_ADC_PINS (board_config.h) sont
+	mises en entrée.
 
 			    +---- ----+
 			  --| 1  U 40 |-- ADC 0
@@ -79,9 +142,13 @@ void adc_init(void);
 	prend un certain temps à s'effectuer et la fonction attend la fin de la conversion avant de
 	retourner. C'est une mauvaise idée d'appeler cette fonction dans une boucle avec des temps
 	critiques.
+
+	Si les interruptions sont actives, le processeur dort pendant la conversion (voir idle.h
+	et BOARD_ADC_NOISE_REDUCTION dans board.h), sinon il attend en boucle.
 */
 uint8_t adc_read(uint8_t channel);
 
+#if BOARD_HAS_PWM0
 /**
     \brief  Fait l'initialisation des registres nécéssaires à la génération de modulation de largeur d'impulsion (PWM)
     \return rien.
@@ -158,83 +225,59 @@ void pwm0_set_PB3(uint8_t duty);
 void pwm0_set_PB4(uint8_t duty);
 
 /**
-    \brief  Fait l'initialisation des registres nécéssaires à la génération de modulation de largeur d'impulsion (PWM)
-	\param[in]	top Une valeur entre 0 et 65535 qui détermine la valeur maximale du compteur
+    \brief Change le mode et le facteur de division du compteur 0
+	\param[in]	frequency La fréquence MLI voulue pour PB3 et PB4
     \return rien.
 
-	Cette fonction détermine le fonctionnement du compteur 1 (16 bits) de l'ATmega324A pour générer des signaux MLI 
-	sur les broches PD4 et PD5. En jouant sur la valeur top, on peut ajuster la période du signal MLI.
+	Les deux sorties du compteur 0 partagent forcément la même fréquence.
 */
-void pwm1_init(uint16_t top);
+void pwm0_set_frequency(pwm_frequency_e frequency);
 
 /**
-    \brief Détermine le rapport cyclique du PWM à la sortie PD4 (broche 21 du DIP)
-	\param[in]	duty Une valeur entre 0 et 65535
+    \brief Branche ou débranche la sortie MLI de PB3
+	\param[in]	connect TRUE pour sortir la MLI, FALSE pour forcer la broche à 0
     \return rien.
 
-	Le rapport cyclique dépend de la valeur top fixée à l'initialisation et de la valeur duty de cette fonction. 
-	RC=duty/top
-	Exe.: si top vaut 100, et duty vaut 50, le rapport cyclique est de 50%.
-
-			    +---- ----+
-			  --| 1  U 40 |--
-			  --| 2    39 |--
-			  --| 3    38 |--
-			  --| 4    37 |--
-			  --| 5    36 |--
-			  --| 6    35 |--
-			  --| 7    34 |--
-			  --| 8    33 |--
-			  --| 9    32 |--
-			  --| 10   31 |--
-			  --| 11   30 |--
-			  --| 12   29 |--
-			  --| 13   28 |--
-			  --| 14   27 |--
-			  --| 15   26 |--
-			  --| 16   25 |--
-			  --| 17   24 |--
-	      PD4 --| 18   23 |--
-			  --| 19   22 |--
-			  --| 20   21 |-- 
-			    +---------+
+	Débrancher la sortie la met à 0 immédiatement, sans attendre la fin de la période en
+	cours, et élimine l'impulsion d'un pas que le mode Fast PWM produit même avec un duty de 0.
 */
-void pwm1_set_PD4(uint16_t duty);
+void pwm0_connect_PB3(bool connect);
 
 /**
-    \brief Détermine le rapport cyclique du PWM à la sortie PD5 (broche 21 du DIP)
-	\param[in]	duty Une valeur entre 0 et 65535
+    \brief Branche ou débranche la sortie MLI de PB4
+	\param[in]	connect TRUE pour sortir la MLI, FALSE pour forcer la broche à 0
     \return rien.
+*/
+void pwm0_connect_PB4(bool connect);
+#endif /* BOARD_HAS_PWM0 */
 
-	Le rapport cyclique dépend de la valeur top fixée à l'initialisation et de la valeur duty de cette fonction. 
-	RC=duty/top
-	Exe.: si top vaut 100, et duty vaut 50, le rapport cyclique est de 50%.
+/**
+    \brief  Fait l'initialisation du compteur 1 comme base de temps libre
+    \return rien.
 
-			    +---- ----+
-			  --| 1  U 40 |--
-			  --| 2    39 |--
-			  --| 3    38 |--
-			  --| 4    37 |--
-			  --| 5    36 |--
-			  --| 6    35 |--
-			  --| 7    34 |--
-			  --| 8    33 |--
-			  --| 9    32 |--
-			  --| 10   31 |--
-			  --| 11   30 |--
-			  --| 12   29 |--
-			  --| 13   28 |--
-			  --| 14   27 |--
-			  --| 15   26 |--
-			  --| 16   25 |--
-			  --| 17   24 |--
-	          --| 18   23 |--
-		  PD5 --| 19   22 |--
-			  --| 20   21 |--
-			    +---------+
+	Le compteur 1 (16 bits) tourne librement de 0 à 0xFFFF (mode normal) avec un facteur de
+	division de PWM1_DIVISION, donc un pas de 1 µs à 8 MHz. Il n'y a pas de valeur TOP: les
+	deux unités de comparaison sont libres de programmer leur prochaine échéance n'importe où
+	sur le cercle de 65536 pas, sans le double tampon des modes MLI qui retarde les écritures
+	dans OCR1x à la fin de la période.
+
+	- Comparaison B : tick de PWM1_TICK_US (1 ms). L'interruption TIMER1_COMPB_vect est
+	  activée ici et doit avancer OCR1B de PWM1_TICK_PAS à chaque appel.
+	- Comparaison A : libre pour la carte. Sur la grue, elle est réservée au servomoteur sur
+	  PD5 (voir servo.h), qui génère une trame de 20 ms en faisant basculer OC1A par le
+	  matériel. Sur la manette, OC1A reste déconnectée: PD5 est l'entrée du bouton
+	  d'automation.
+
+	Comme le tick et le servomoteur ont chacun leur unité de comparaison, changer la période
+	ou la position du servomoteur ne touche plus au compte du temps.
+
+	Tous les accès 16 bits aux registres du compteur 1 (TCNT1, OCR1A, OCR1B) passent par le
+	registre TEMP partagé. Un accès fait hors interruption doit donc être protégé par un
+	ATOMIC_BLOCK puisque les interruptions du compteur 1 écrivent aussi dans ces registres.
 */
-void pwm1_set_PD5(uint16_t duty);
+void pwm1_init(void);
 
+#if BOARD_HAS_PWM2
 /**
     \brief  Fait l'initialisation des registres nécéssaires à la génération de modulation de largeur d'impulsion (PWM)
     \return rien.
@@ -310,6 +353,28 @@ void pwm2_set_PD7(uint8_t duty);
 */
 void pwm2_set_PD6(uint8_t duty);
 
+/**
+    \brief Change le mode et le facteur de division du compteur 2
+	\param[in]	frequency La fréquence MLI voulue pour PD6 et PD7
+    \return rien.
+*/
+void pwm2_set_frequency(pwm_frequency_e frequency);
+
+/**
+    \brief Branche ou débranche la sortie MLI de PD6
+	\param[in]	connect TRUE pour sortir la MLI, FALSE pour forcer la broche à 0
+    \return rien.
+*/
+void pwm2_connect_PD6(bool connect);
+
+/**
+    \brief Branche ou débranche la sortie MLI de PD7
+	\param[in]	connect TRUE pour sortir la MLI, FALSE pour forcer la broche à 0
+    \return rien.
+*/
+void pwm2_connect_PD7(bool connect);
+#endif /* BOARD_HAS_PWM2 */
+
 /**
     \brief Initialise le contrôle des moteurs
     \return rien.
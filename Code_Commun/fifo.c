@@ -39,10 +39,10 @@ Includes
 Global functions
 ******************************************************************************/
 
-void fifo_init(fifo_t* fifo, uint8_t* ptr_buffer, uint8_t buffer_size){
+void fifo_init(fifo_t* fifo, uint8_t* ptr_buffer, uint16_t buffer_size){
 
     fifo->ptr = ptr_buffer;
-    fifo->size = buffer_size;
+    fifo->mask = buffer_size - 1;
     fifo->in_offset = 0;
     fifo->out_offset = 0;
     fifo->is_empty = TRUE;
@@ -52,7 +52,6 @@ void fifo_init(fifo_t* fifo, uint8_t* ptr_buffer, uint8_t buffer_size){
 
 
 void fifo_push(fifo_t* fifo, uint8_t value){
-	char str[20];
 	//lcd_write_char(value);
     /* Si le buffer est plein il n'est pas question de rien "pusher" */
     if(fifo->is_full == FALSE){
@@ -61,15 +60,7 @@ void fifo_push(fifo_t* fifo, uint8_t value){
 
         fifo->is_empty = FALSE;
 
-        if(fifo->in_offset == fifo->size - 1){
-
-            fifo->in_offset = 0;
-        }
-
-        else{
-
-            fifo->in_offset++;
-        }
+        fifo->in_offset = (fifo->in_offset + 1) & fifo->mask;
 		//lcd_write_char(value);
 		/* gestion du nombre de lignes */
 		if(value==FIFO_LINE_SEPERATOR){
@@ -100,15 +91,7 @@ uint8_t fifo_pop(fifo_t* fifo){
 
         fifo->is_full = FALSE;
 
-        if(fifo->out_offset == fifo->size - 1){
-
-            fifo->out_offset = 0;
-        }
-
-        else{
-
-            fifo->out_offset++;
-        }
+        fifo->out_offset = (fifo->out_offset + 1) & fifo->mask;
 		
 		/* gestion du nombre de lignes */
 		if(value==FIFO_LINE_SEPERATOR){
@@ -142,6 +125,7 @@ void fifo_clean(fifo_t* fifo){
 	fifo->in_offset = fifo->out_offset;
 	fifo->is_full = FALSE;
 	fifo->is_empty = TRUE;
+	fifo->nb_line = 0;
 }
 
 
@@ -42,7 +42,7 @@ Defines et typedef
 typedef struct{
 
     uint8_t*    ptr;
-    uint8_t     size;
+    uint8_t     mask;       //taille - 1 (la taille est une puissance de 2)
     uint8_t     in_offset;
     uint8_t     out_offset;
     bool        is_empty;
@@ -53,6 +53,21 @@ typedef struct{
 
 #define FIFO_LINE_SEPERATOR	'\n'
 
+/**
+    \brief Taille maximale d'un fifo: les index et nb_line sont sur 8 bits
+
+	Un fifo plein de FIFO_LINE_SEPERATOR compte FIFO_MAX_SIZE lignes: à 256, nb_line
+	reviendrait à 0 et la resynchronisation de uart.c jetterait des lignes complètes.
+*/
+#define FIFO_MAX_SIZE		128
+
+_Static_assert(FIFO_MAX_SIZE <= UINT8_MAX, "nb_line (uint8_t) doit compter FIFO_MAX_SIZE lignes");
+
+/**
+    \brief Vrai si size est une taille de fifo permise: une puissance de 2 jusqu'à FIFO_MAX_SIZE
+*/
+#define FIFO_SIZE_IS_VALID(size)	(((size) > 0) && ((size) <= FIFO_MAX_SIZE) && (((size) & ((size) - 1)) == 0))
+
 /******************************************************************************
 Prototypes
 ******************************************************************************/
@@ -61,10 +76,12 @@ Prototypes
     \brief Fait l'initialisation de la structure pour le FIFO
 	\param fifo Un pointeur sur une structure FIFO vide
 	\param ptr_buffer Un pointeur sur une tableau de bytes
-	\param buffer_size La grosseur du tableau de bytes
-    \return TRUE si il est vide, FALSE s'il contient 1 byte ou plus
+	\param buffer_size La grosseur du tableau de bytes, qui doit respecter FIFO_SIZE_IS_VALID()
+    \return rien.
+
+	Avec une taille en puissance de 2, le retour au début du tableau est un simple masque.
 */
-void fifo_init(fifo_t* fifo, uint8_t* ptr_buffer, uint8_t buffer_size);
+void fifo_init(fifo_t* fifo, uint8_t* ptr_buffer, uint16_t buffer_size);
 void fifo_push(fifo_t* fifo, uint8_t value);
 uint8_t fifo_pop(fifo_t* fifo);
 void fifo_clean(fifo_t* fifo);
@@ -0,0 +1,141 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file idle.c
+	\brief Veille du processeur entre deux interruptions et estimation de l'énergie
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "driver.h"
+#include "idle.h"
+#include "timebase.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* Fenêtre en cours, seulement touchée par le programme principal */
+static uint32_t window_start = 0;
+static uint32_t window_sleep_us = 0;
+static uint16_t window_wakeups = 0;
+
+/* Dernière fenêtre complète */
+static idle_stats_t last = {0, 0, 0};
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static uint16_t sleep_permille(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void idle_sleep(uint8_t mode){
+
+	// Les interruptions sont désactivées: la lecture 16 bits de TCNT1 est sûre
+	uint16_t debut = TCNT1;
+
+	set_sleep_mode(mode);
+	sleep_enable();
+
+	// L'instruction qui suit SEI est toujours exécutée avant une interruption en attente
+	sei();
+	sleep_cpu();
+
+	sleep_disable();
+	cli();
+
+	if(mode == SLEEP_MODE_IDLE){
+
+		window_sleep_us += PWM1_PAS_EN_US((uint16_t)(TCNT1 - debut));
+	}
+
+	window_wakeups++;
+
+	uint32_t ecoule = timebase_elapsed_ms(window_start);
+
+	if(ecoule >= IDLE_WINDOW_MS){
+
+		last.window_ms = (ecoule > 0xFFFF) ? 0xFFFF : ecoule;
+		last.sleep_us = window_sleep_us;
+		last.wakeups = window_wakeups;
+
+		window_start += ecoule;
+		window_sleep_us = 0;
+		window_wakeups = 0;
+	}
+}
+
+
+void idle_get_stats(idle_stats_t* stats){
+
+	*stats = last;
+}
+
+
+uint16_t idle_current_ua(void){
+
+	uint32_t veille = sleep_permille();
+
+	return ((uint32_t)IDLE_ACTIVE_UA * (1000 - veille) + (uint32_t)IDLE_SLEEP_UA * veille) / 1000;
+}
+
+
+bool idle_command(const char* ligne, uint8_t longueur){
+
+	char texte[48];
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'E')){
+
+		return FALSE;
+	}
+
+	sprintf(texte, "veille=%u reveils=%u courant=%u\n", sleep_permille(), last.wakeups,
+		idle_current_ua());
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Part de la dernière fenêtre passée en veille, en millièmes */
+static uint16_t sleep_permille(void){
+
+	if(last.window_ms == 0){
+
+		return 0;
+	}
+
+	// µs de veille par ms de fenêtre
+	uint32_t veille = last.sleep_us / last.window_ms;
+
+	return (veille > 1000) ? 1000 : veille;
+}
@@ -0,0 +1,124 @@
+#ifndef IDLE_H_INCLUDED
+#define IDLE_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file idle.h
+	\brief Veille du processeur entre deux interruptions et estimation de l'énergie
+
+	Quand la boucle principale n'a plus rien à faire, elle endort le processeur jusqu'à
+	la prochaine interruption, en désactivant les interruptions le temps de vérifier
+	qu'aucun travail n'est arrivé:
+
+		cli();
+		if(!uart_rx_buffer_nb_line(UART_0)){
+
+			idle_sleep(SLEEP_MODE_IDLE);
+		}
+		sei();
+
+	idle_sleep() réactive les interruptions juste avant l'instruction SLEEP: une
+	interruption arrivée entre la vérification et la veille réveille donc le processeur
+	aussitôt au lieu d'être oubliée.
+
+	En mode SLEEP_MODE_IDLE, seul le processeur s'arrête: les compteurs, les UART et
+	l'ADC continuent. Le tick de 1 ms (voir pwm1_init()) réveille le processeur au moins
+	une fois par milliseconde: une minuterie logicielle est traitée au plus 1 ms après
+	son échéance, et une ligne reçue dès l'interruption de son '\n'.
+
+	Le temps passé en veille est mesuré avec TCNT1 (ramené en µs) et cumulé sur des fenêtres de
+	IDLE_WINDOW_MS. Le temps de l'interruption qui réveille le processeur est compté
+	en veille. En mode SLEEP_MODE_ADC, le compteur 1 est arrêté et le temps en veille
+	n'est pas mesuré.
+
+	La commande ?E reçue sur UART_0 renvoie la dernière fenêtre complète:
+
+		veille=<pour mille> reveils=<nombre> courant=<µA>
+
+	Le courant est une estimation pour le microcontrôleur seul, à partir des valeurs
+	typiques IDLE_ACTIVE_UA et IDLE_SLEEP_UA de la fiche technique.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/sleep.h>
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define IDLE_WINDOW_MS		1000
+
+/**
+    \brief Courants typiques de l'ATmega324A à 8 MHz et 5 V, en µA
+
+	Processeur actif, et en mode SLEEP_MODE_IDLE. Les périphériques actifs et les
+	broches chargées s'y ajoutent.
+*/
+#define IDLE_ACTIVE_UA		5000
+#define IDLE_SLEEP_UA		1400
+
+typedef struct{
+
+	uint16_t window_ms;		/* durée de la fenêtre */
+	uint32_t sleep_us;		/* temps en veille pendant la fenêtre */
+	uint16_t wakeups;		/* nombre de veilles */
+
+}idle_stats_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Endort le processeur jusqu'à la prochaine interruption
+	\param[in]	mode SLEEP_MODE_IDLE, ou SLEEP_MODE_ADC pendant une conversion
+    \return rien.
+
+	À appeler avec les interruptions désactivées. La fonction retourne avec les
+	interruptions désactivées, après l'exécution de l'interruption qui l'a réveillée.
+*/
+void idle_sleep(uint8_t mode);
+
+/**
+    \brief Copie les mesures de la dernière fenêtre complète
+	\param[out]	stats Les mesures
+    \return rien.
+*/
+void idle_get_stats(idle_stats_t* stats);
+
+/**
+    \brief Estime le courant moyen de la dernière fenêtre complète
+    \return le courant en µA
+*/
+uint16_t idle_current_ua(void);
+
+/**
+    \brief Traite la commande ?E
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool idle_command(const char* ligne, uint8_t longueur);
+
+#endif /* IDLE_H_INCLUDED */
@@ -32,6 +32,7 @@ Includes
 #include <avr/io.h>
 #include <util/delay_basic.h>  //Pour une raison obsucre <util/delay.h> boguais
 #include "lcd.h"
+#include "timebase.h"
 
 
 /******************************************************************************
@@ -64,6 +65,38 @@ Defines
 
 #define BLANK_CHAR (' ')
 
+/* Attentes de l'initialisation, en arrière-plan ou non, en ms. La fiche technique demande
+15 ms après la mise sous tension et 4,1 ms après le premier function set; l'effacement
+garde la marge trouvée par essai erreur (voir hd44780_clear_display()). */
+#define LCD_MISE_SOUS_TENSION_MS	40
+#define LCD_FONCTION_MS				5
+#define LCD_EFFACE_MS				5
+
+/* Maintien du bus autour de chaque front de E, en µs (37 µs au minimum pour une commande) */
+#define LCD_IMPULSION_US			250
+
+/* Passages de _delay_loop_2() pour une attente en µs, arrondis vers le haut: 4 cycles
+d'horloge par passage */
+#define BOUCLES_US(us)				(((uint32_t)(us) * (F_CPU / 1000UL) + 3999UL) / 4000UL)
+
+_Static_assert((BOUCLES_US(LCD_IMPULSION_US) > 0) && (BOUCLES_US(LCD_IMPULSION_US) <= 0xFFFF), "LCD_IMPULSION_US ne tient pas dans un appel de _delay_loop_2() à F_CPU");
+_Static_assert(BOUCLES_US(1000) <= 0xFFFF, "attendre_ms() ne tient pas 1 ms dans un appel de _delay_loop_2() à F_CPU");
+_Static_assert(BOUCLES_US(LCD_EFFACE_MS * 1000UL) <= 0xFFFF, "LCD_EFFACE_MS ne tient pas dans un appel de _delay_loop_2() à F_CPU");
+
+typedef enum{
+
+	ETAPE_ARRET = 0,		/* ni lcd_init(), ni lcd_begin() */
+	ETAPE_FONCTION_1,		/* premier function set, après la mise sous tension */
+	ETAPE_FONCTION_2,		/* second function set, puis celui de la largeur du bus */
+	ETAPE_FONCTION_SET,
+	ETAPE_ENTRY_MODE,
+	ETAPE_DISPLAY_CONTROL,
+	ETAPE_CLEAR,
+	ETAPE_FIN_CLEAR,		/* attente de l'effacement */
+	ETAPE_PRET
+
+}etape_e;
+
 
 /******************************************************************************
 Static variables
@@ -73,6 +106,11 @@ Static variables
 static uint8_t local_index;
 static bool clear_required_flag;
 
+/* Initialisation en arrière-plan */
+static etape_e etape = ETAPE_ARRET;
+static uint32_t etape_ms;
+static uint8_t attente_ms;
+
 
 /******************************************************************************
 Static prototypes
@@ -80,9 +118,12 @@ Static prototypes
 
 /* hd44780 */
 static void clock_data(char data);
+static void pulse(void);
+static void attendre_ms(uint8_t ms);
 
 
 /* lcd */
+static void etape_suivante(uint8_t attente);
 bool shift_local_index(bool foward);
 uint8_t index_to_col(uint8_t index);
 uint8_t index_to_row(uint8_t index);
@@ -104,30 +145,27 @@ void hd44780_init(bool increment, bool cursor, bool blink){
 
 
     DATA_PORT = (0b00110000 >> BUS_SHIFT) & BUS_MASK; //Function set (Interface is 8 bits long)
-    _delay_loop_2(0xFFFF);     //13.1ms (idéalement 15ms, mais pas possible)
+    attendre_ms(LCD_MISE_SOUS_TENSION_MS);
     FALLING_EDGE();
-    //_delay_loop_2(20000);    //4ms
-    _delay_loop_2(0xFFFF);     //13.1ms (idéalement 15ms, mais pas possible)
+    attendre_ms(LCD_FONCTION_MS);
     RISING_EDGE();
 
     DATA_PORT = (0b00110000 >> BUS_SHIFT) & BUS_MASK; //Function set (Interface is 8 bits long)
-    //_delay_loop_2(20500);    //4.1ms
-    _delay_loop_2(0xFFFF);     //13.1ms (idéalement 15ms, mais pas possible)
+    attendre_ms(LCD_FONCTION_MS);
     FALLING_EDGE();
-    //_delay_loop_2(20000);    //4ms
-    _delay_loop_2(0xFFFF);     //13.1ms (idéalement 15ms, mais pas possible)
+    attendre_ms(LCD_FONCTION_MS);
     RISING_EDGE();
 
     DATA_PORT = (0b00110000 >> BUS_SHIFT) & BUS_MASK; //Function set (Interface is 8 bits long)
-    _delay_loop_2(500);     //100us
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
     FALLING_EDGE();
-    _delay_loop_2(500);     //100us
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
     RISING_EDGE();
 
     DATA_PORT = (FUNCTION_SET >> BUS_SHIFT) & BUS_MASK;
-    _delay_loop_2(500);     //100us
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
     FALLING_EDGE();
-    _delay_loop_2(500);     //100us
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
     RISING_EDGE();
 
     clock_data(FUNCTION_SET);
@@ -148,8 +186,7 @@ void hd44780_clear_display(){
 	// par essai erreur. Une bonne solution pour régler le problème sera de relire le busy
 	// flag
 	//TODO
-	//_delay_ms(2);
-	_delay_loop_2(10000);
+	_delay_loop_2(BOUCLES_US(LCD_EFFACE_MS * 1000UL));
 
     DATA_MODE();
 }
@@ -400,19 +437,131 @@ void lcd_init(void){
 
     local_index = 0;
 	clear_required_flag = FALSE;
+	etape = ETAPE_PRET;
+}
+
+
+void lcd_begin(void){
+
+    local_index = 0;
+	clear_required_flag = FALSE;
+
+    // Mêmes ports et même séquence que hd44780_init(), les longues attentes en moins
+    CTRL_PORT = clear_bit(CTRL_PORT, RS_PIN);   //command mode
+    CTRL_PORT = clear_bit(CTRL_PORT, RW_PIN);   //write mode
+
+    DATA_DDR = BUS_MASK;
+    CTRL_DDR = set_bits(CTRL_DDR, (1 << E_PIN) | (1 << RW_PIN) | (1 << RS_PIN));
+
+    DATA_PORT = (0b00110000 >> BUS_SHIFT) & BUS_MASK; //Function set (Interface is 8 bits long)
+    FALLING_EDGE();
+
+    etape = ETAPE_ARRET;
+    etape_suivante(LCD_MISE_SOUS_TENSION_MS);
+}
+
+
+bool lcd_process(void){
+
+    if(etape == ETAPE_PRET){
+
+        return TRUE;
+    }
+
+    if((etape == ETAPE_ARRET) || (timebase_elapsed_ms(etape_ms) < attente_ms)){
+
+        return FALSE;
+    }
+
+    // Une étape par appel: aucune ne bloque plus de 1 ms
+    switch(etape){
+    case ETAPE_FONCTION_1:
+
+        pulse();
+        etape_suivante(LCD_FONCTION_MS);
+        break;
+
+    case ETAPE_FONCTION_2:
+
+        pulse();
+
+        DATA_PORT = (FUNCTION_SET >> BUS_SHIFT) & BUS_MASK;
+        pulse();
+        RISING_EDGE();
+
+        etape_suivante(0);
+        break;
+
+    case ETAPE_FONCTION_SET:
+
+        clock_data(FUNCTION_SET);
+        etape_suivante(0);
+        break;
+
+    case ETAPE_ENTRY_MODE:
+
+        hd44780_set_entry_mode(TRUE);
+        etape_suivante(0);
+        break;
+
+    case ETAPE_DISPLAY_CONTROL:
+
+        hd44780_set_display_control(TRUE, TRUE, FALSE);
+        etape_suivante(0);
+        break;
+
+    case ETAPE_CLEAR:
+
+        COMMAND_MODE();
+        clock_data(0b00000001);     //Clear Display
+        etape_suivante(LCD_EFFACE_MS);
+        break;
+
+    case ETAPE_FIN_CLEAR:
+
+        DATA_MODE();
+        etape_suivante(0);
+        break;
+
+    default:
+
+        break;
+    }
+
+    return (etape == ETAPE_PRET);
+}
+
+
+bool lcd_is_ready(void){
+
+    return (etape == ETAPE_PRET);
 }
 
 
 void lcd_clear_display(){
 
+    if(etape != ETAPE_PRET){
+
+        return;
+    }
+
+    PROFILE_BEGIN(PROFILE_ZONE_LCD);
+
     hd44780_clear_display();
 
     local_index = 0;
+
+    PROFILE_END(PROFILE_ZONE_LCD);
 }
 
 
 void lcd_set_cursor_position(uint8_t col, uint8_t row){
 
+    if(etape != ETAPE_PRET){
+
+        return;
+    }
+
     if((col >= 0) && (col < LCD_NB_COL) && (row >= 0) && (row < LCD_NB_ROW)){
 
         hd44780_set_cursor_position(col, row);
@@ -424,6 +573,11 @@ void lcd_set_cursor_position(uint8_t col, uint8_t row){
 
 void lcd_shift_cursor(lcd_shift_e shift){
 
+    if(etape != ETAPE_PRET){
+
+        return;
+    }
+
     switch(shift){
     case LCD_SHIFT_RIGHT:
 
@@ -510,6 +664,11 @@ void lcd_write_char(char character){
 
     bool unsynced;
 
+    if(etape != ETAPE_PRET){
+
+        return;
+    }
+
 	// Si il s'agit d'un des 32 premier caractères ascii, on s'attend à un contrôle
 	// plutôt que l'affichage d'un caractère
 	if(character < ' '){
@@ -549,12 +708,21 @@ void lcd_write_string(const char* string){
 
     uint8_t index = 0;
 
+    if(etape != ETAPE_PRET){
+
+        return;
+    }
+
+    PROFILE_BEGIN(PROFILE_ZONE_LCD);
+
     while(string[index] != '\0'){
 
         lcd_write_char(string[index]);
 
         index++;
     }
+
+    PROFILE_END(PROFILE_ZONE_LCD);
 }
 
 
@@ -567,38 +735,61 @@ void clock_data(char data){
 
     DATA_PORT = (data >> BUS_SHIFT) & BUS_MASK;
 
-    //_delay_us(50);
-    //_delay_loop_2(250);
-    _delay_loop_2(500);
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
 
     FALLING_EDGE();
 
-    //_delay_us(50);
-    //_delay_loop_2(250);
-    _delay_loop_2(500);
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
 
     RISING_EDGE();
 
 #ifdef HD44780_BUS_4_BITS
     DATA_PORT = (data << (4 - BUS_SHIFT)) & BUS_MASK;
 
-    //_delay_us(50);
-    //_delay_loop_2(250);
-    _delay_loop_2(500);
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
 
     FALLING_EDGE();
 
-    //_delay_us(50);
-    //_delay_loop_2(250);
-    _delay_loop_2(500);
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
 
     RISING_EDGE();
 #endif // HD44780_BUS_4_BITS
 }
 
 
+/* Front montant puis descendant de E: le HD44780 lit le bus sur le front descendant */
+static void pulse(void){
+
+    RISING_EDGE();
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
+    FALLING_EDGE();
+    _delay_loop_2(BOUCLES_US(LCD_IMPULSION_US));
+}
+
+
+/* Attente bloquante de ms millisecondes, à toute fréquence d'horloge */
+static void attendre_ms(uint8_t ms){
+
+    while(ms-- > 0){
+
+        _delay_loop_2(BOUCLES_US(1000));
+    }
+}
+
+
 /* lcd */
 
+/* Passe à l'étape suivante de l'initialisation, dans au moins attente ms */
+static void etape_suivante(uint8_t attente){
+
+    etape++;
+    etape_ms = timebase_millis();
+
+    // Le tick de 1 ms peut tomber juste après la lecture: une ms de plus
+    attente_ms = (attente != 0) ? attente + 1 : 0;
+}
+
+
 uint8_t index_to_col(uint8_t index){
 
     return index % LCD_NB_COL;
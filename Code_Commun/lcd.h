@@ -80,6 +80,7 @@
 Includes
 ---------------------------------------------------------------------------- */
 
+#include "board.h"
 #include "utils.h"
 
 
@@ -87,40 +88,44 @@ Includes
 Defines et typedef
 ---------------------------------------------------------------------------- */
 
+/*
+	Le brochage du LCD vient de board_config.h.
+*/
+
 /**
     \brief Définit quel port est utilisé pour le data du LCD
 */
-#define DATA_PORT   PORTC
+#define DATA_PORT   BOARD_LCD_DATA_PORT
 
 /**
     \brief Définit le registre pour contrôler la direction du data du LCD
 */
-#define DATA_DDR    DDRC
+#define DATA_DDR    BOARD_LCD_DATA_DDR
 
 /**
     \brief Définit quel port est utilisé pour le contrôle du LCD
 */
-#define CTRL_PORT   PORTA
+#define CTRL_PORT   BOARD_LCD_CTRL_PORT
 
 /**
     \brief Définit le registre pour contrôler la direction du contrôle du LCD
 */
-#define CTRL_DDR    DDRA
+#define CTRL_DDR    BOARD_LCD_CTRL_DDR
 
 /**
     \brief Définit le numéro de la broche qui joue le rôle de enable
 */
-#define E_PIN       7
+#define E_PIN       BOARD_LCD_E_PIN
 
 /**
     \brief Définit le numéro de la broche qui joue le rôle de read/write
 */
-#define RW_PIN      6
+#define RW_PIN      BOARD_LCD_RW_PIN
 
 /**
     \brief Définit le numéro de la broche qui joue le rôle de register select
 */
-#define RS_PIN      5
+#define RS_PIN      BOARD_LCD_RS_PIN
 
 
 /**
@@ -257,10 +262,37 @@ void hd44780_write_cgram(uint8_t slot, const uint8_t* bitmap_array);
     \return Rien
 
 	Cette fonction doit préalablement être appelée avant d'utiliser les autres
-	fonctions du module.
+	fonctions du module. Elle bloque environ 60 ms: au démarrage d'une carte,
+	lcd_begin() fait la même initialisation en arrière-plan.
 */
 void lcd_init(void);
 
+/**
+    \brief Commence l'initialisation du LCD en arrière-plan
+    \return Rien
+
+	Les ports sont configurés tout de suite; la suite de l'initialisation est faite
+	par lcd_process(), sans attente de plus de 1 ms par appel. La base de temps
+	(timebase.h) doit tourner. D'ici la fin, les autres fonctions "lcd" ne font rien:
+	le premier affichage peut être perdu, mais rien n'attend le LCD.
+*/
+void lcd_begin(void);
+
+/**
+    \brief Avance l'initialisation commencée par lcd_begin()
+    \return TRUE quand le LCD est prêt
+
+	À appeler à chaque passage de la boucle principale. L'initialisation prend
+	environ 55 ms.
+*/
+bool lcd_process(void);
+
+/**
+    \brief Indique si le LCD est prêt
+    \return TRUE après lcd_init() ou la fin de l'initialisation de lcd_begin()
+*/
+bool lcd_is_ready(void);
+
 /**
     \brief Efface l'écran du LCD et retourne le curseur à la position 0,0.
 	Il n'est pas réellement possible "d'effacer" l'écran du LCD. Bien que
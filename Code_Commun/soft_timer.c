@@ -0,0 +1,193 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file soft_timer.c
+	\brief Minuteries logicielles à une seule échéance ou périodiques
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stddef.h>
+#include "soft_timer.h"
+#include "timebase.h"
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* Tête de la liste triée: son delta_ms est compté à partir de l'instant de référence */
+static soft_timer_t* head = NULL;
+
+/* Dernière lecture de timebase_millis() */
+static uint32_t last_ms = 0;
+
+/* Temps écoulé depuis l'instant de référence de la liste, pas encore retiré de la tête */
+static uint32_t lag_ms = 0;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void sync(void);
+static void insert(soft_timer_t* timer, uint32_t delta_ms);
+static void unlink(soft_timer_t* timer);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void soft_timer_init(soft_timer_t* timer, soft_timer_callback_t callback, void* arg){
+
+	timer->next = NULL;
+	timer->delta_ms = 0;
+	timer->period_ms = 0;
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->active = FALSE;
+}
+
+
+void soft_timer_start(soft_timer_t* timer, uint32_t delay_ms, uint32_t period_ms){
+
+	if(timer->active){
+
+		unlink(timer);
+	}
+
+	sync();
+
+	timer->period_ms = period_ms;
+
+	// Les écarts de la liste partent de l'instant de référence, pas de maintenant
+	insert(timer, lag_ms + delay_ms);
+}
+
+
+void soft_timer_stop(soft_timer_t* timer){
+
+	if(timer->active){
+
+		unlink(timer);
+	}
+}
+
+
+bool soft_timer_is_active(const soft_timer_t* timer){
+
+	return timer->active;
+}
+
+
+void soft_timer_process(void){
+
+	sync();
+
+	while((head != NULL) && (head->delta_ms <= lag_ms)){
+
+		soft_timer_t* timer = head;
+
+		// L'instant de référence avance jusqu'à l'échéance de la tête
+		lag_ms -= timer->delta_ms;
+		head = timer->next;
+
+		timer->next = NULL;
+		timer->active = FALSE;
+
+		// Réarmée avant l'appel pour que la fonction de rappel puisse l'arrêter
+		if(timer->period_ms != 0){
+
+			insert(timer, timer->period_ms);
+		}
+
+		timer->callback(timer->arg);
+
+		// La fonction de rappel a pu prendre du temps
+		sync();
+	}
+
+	// Ramène l'instant de référence à maintenant
+	if(head != NULL){
+
+		head->delta_ms -= lag_ms;
+	}
+
+	lag_ms = 0;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void sync(void){
+
+	uint32_t now = timebase_millis();
+
+	lag_ms += now - last_ms;
+	last_ms = now;
+}
+
+
+static void insert(soft_timer_t* timer, uint32_t delta_ms){
+
+	soft_timer_t** link = &head;
+
+	// Une minuterie passe après celles de même échéance: l'ordre d'armement est conservé
+	while((*link != NULL) && ((*link)->delta_ms <= delta_ms)){
+
+		delta_ms -= (*link)->delta_ms;
+		link = &(*link)->next;
+	}
+
+	if(*link != NULL){
+
+		(*link)->delta_ms -= delta_ms;
+	}
+
+	timer->delta_ms = delta_ms;
+	timer->next = *link;
+	timer->active = TRUE;
+	*link = timer;
+}
+
+
+static void unlink(soft_timer_t* timer){
+
+	soft_timer_t** link = &head;
+
+	while((*link != NULL) && (*link != timer)){
+
+		link = &(*link)->next;
+	}
+
+	if(*link != NULL){
+
+		// La suivante hérite de l'écart de celle qu'on retire
+		if(timer->next != NULL){
+
+			timer->next->delta_ms += timer->delta_ms;
+		}
+
+		*link = timer->next;
+	}
+
+	timer->next = NULL;
+	timer->active = FALSE;
+}
@@ -0,0 +1,137 @@
+#ifndef SOFT_TIMER_H_INCLUDED
+#define SOFT_TIMER_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file soft_timer.h
+	\brief Minuteries logicielles à une seule échéance ou périodiques
+
+	Remplace les _delay_ms() bloquants: au lieu d'attendre, on arme une minuterie et on
+	retourne à la boucle principale. Quand l'échéance arrive, soft_timer_process() appelle
+	la fonction de rappel de la minuterie.
+
+	Les minuteries armées sont gardées dans une liste triée par échéance où chaque élément
+	ne garde que l'écart (en ms) avec le précédent. soft_timer_process() n'a donc qu'à
+	regarder la tête de la liste, peu importe le nombre de minuteries.
+
+	Les structures soft_timer_t appartiennent à l'appelant (habituellement des variables
+	statiques), le module ne fait aucune allocation. Tout se passe dans le contexte du
+	programme principal: les fonctions de rappel peuvent appeler le LCD, l'UART ou réarmer
+	des minuteries, mais aucune fonction de ce module ne doit être appelée d'une interruption.
+
+	La base de temps est timebase_millis().
+
+	Exe.:
+
+		static soft_timer_t clignote;
+
+		static void clignote_cb(void* arg){ ... }
+
+		soft_timer_init(&clignote, clignote_cb, NULL);
+		soft_timer_start(&clignote, 500, 500);
+
+		while(1){
+			soft_timer_process();
+			...
+		}
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+typedef void (*soft_timer_callback_t)(void* arg);
+
+/**
+    \brief Une minuterie logicielle
+
+	Les champs sont privés au module, il faut passer par les fonctions.
+*/
+typedef struct soft_timer_s{
+
+	struct soft_timer_s* next;			/* minuterie suivante dans la liste */
+	uint32_t delta_ms;					/* écart avec l'échéance de la minuterie précédente */
+	uint32_t period_ms;					/* 0 pour une minuterie à une seule échéance */
+	soft_timer_callback_t callback;
+	void* arg;
+	bool active;
+
+}soft_timer_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Prépare une minuterie
+	\param[in]	timer La minuterie
+	\param[in]	callback La fonction à appeler à l'échéance
+	\param[in]	arg L'argument passé à la fonction de rappel
+    \return rien.
+
+	La minuterie n'est pas armée. Ne pas appeler sur une minuterie armée.
+*/
+void soft_timer_init(soft_timer_t* timer, soft_timer_callback_t callback, void* arg);
+
+/**
+    \brief Arme une minuterie
+	\param[in]	timer La minuterie
+	\param[in]	delay_ms Le délai avant la première échéance, en ms
+	\param[in]	period_ms La période des échéances suivantes, en ms. 0 pour une seule échéance.
+    \return rien.
+
+	Si la minuterie était déjà armée, elle est d'abord désarmée. Une minuterie périodique
+	ne dérive pas: chaque échéance est calculée à partir de la précédente et non du moment
+	où la fonction de rappel a été appelée.
+*/
+void soft_timer_start(soft_timer_t* timer, uint32_t delay_ms, uint32_t period_ms);
+
+/**
+    \brief Désarme une minuterie
+	\param[in]	timer La minuterie
+    \return rien.
+
+	Sans effet si la minuterie n'est pas armée.
+*/
+void soft_timer_stop(soft_timer_t* timer);
+
+/**
+    \brief Indique si une minuterie est armée
+	\param[in]	timer La minuterie
+    \return TRUE si la minuterie attend une échéance
+*/
+bool soft_timer_is_active(const soft_timer_t* timer);
+
+/**
+    \brief Appelle les fonctions de rappel des minuteries arrivées à échéance
+    \return rien.
+
+	À appeler à chaque tour de la boucle principale. Une échéance manquée n'est jamais
+	perdue, elle est seulement servie en retard.
+*/
+void soft_timer_process(void);
+
+#endif /* SOFT_TIMER_H_INCLUDED */
@@ -0,0 +1,104 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file timebase.c
+	\brief Base de temps monotone en millisecondes et en microsecondes
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "timebase.h"
+#include "driver.h"
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static volatile uint32_t millis = 0;
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void timebase_tick(void){
+
+	millis++;
+}
+
+
+uint32_t timebase_millis(void){
+
+	uint32_t ms;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		ms = millis;
+	}
+
+	return ms;
+}
+
+
+uint32_t timebase_micros(void){
+
+	uint32_t ms;
+	uint16_t us;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		ms = millis;
+
+		/*
+			OCR1B - PWM1_TICK_PAS est le compte du dernier tick traité. Si un tick est en
+			attente (OCF1B levé), millis n'est pas encore avancé et le calcul donne
+			simplement plus de 1000 µs: le résultat reste juste.
+		*/
+		us = TCNT1 - (OCR1B - PWM1_TICK_PAS);
+	}
+
+	return ms * 1000 + PWM1_PAS_EN_US(us);
+}
+
+
+uint32_t timebase_elapsed_ms(uint32_t since){
+
+	return timebase_millis() - since;
+}
+
+
+uint32_t timebase_elapsed_us(uint32_t since){
+
+	return timebase_micros() - since;
+}
+
+
+bool timebase_reached_ms(uint32_t deadline){
+
+	return (int32_t)(timebase_millis() - deadline) >= 0;
+}
+
+
+bool timebase_reached_us(uint32_t deadline){
+
+	return (int32_t)(timebase_micros() - deadline) >= 0;
+}
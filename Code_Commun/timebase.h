@@ -0,0 +1,103 @@
+#ifndef TIMEBASE_H_INCLUDED
+#define TIMEBASE_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file timebase.h
+	\brief Base de temps monotone en millisecondes et en microsecondes
+
+	Le compteur de millisecondes est de 32 bits: il ne revient à 0 qu'après environ
+	49 jours. Il est avancé par timebase_tick(), appelée à chaque tick de 1 ms de la
+	comparaison B du compteur 1 (voir pwm1_init()).
+
+	Le temps en microsecondes est formé du nombre de ticks multiplié par 1000, plus le
+	nombre de coups du compteur 1 (1 µs chacun) écoulés depuis le dernier tick. Il
+	revient à 0 après environ 71 minutes.
+
+	Les lectures sont faites en section critique: elles peuvent être appelées autant du
+	programme principal que d'une interruption. Pour comparer deux instants, toujours
+	passer par timebase_elapsed_ms() et timebase_reached_ms() (ou leurs équivalents en
+	µs), qui restent justes au retour à 0 du compteur.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Avance la base de temps d'une milliseconde
+    \return rien.
+
+	À appeler seulement de l'interruption du tick (TIMER1_COMPB_vect), après avoir
+	avancé OCR1B.
+*/
+void timebase_tick(void);
+
+/**
+    \brief Retourne le nombre de millisecondes depuis le démarrage
+    \return Le compteur de millisecondes
+*/
+uint32_t timebase_millis(void);
+
+/**
+    \brief Retourne le nombre de microsecondes depuis le démarrage
+    \return Le temps en µs, avec une résolution de 1 µs
+*/
+uint32_t timebase_micros(void);
+
+/**
+    \brief Calcule le temps écoulé depuis un instant lu avec timebase_millis()
+	\param[in]	since L'instant de départ, en ms
+    \return Le nombre de millisecondes écoulées
+*/
+uint32_t timebase_elapsed_ms(uint32_t since);
+
+/**
+    \brief Calcule le temps écoulé depuis un instant lu avec timebase_micros()
+	\param[in]	since L'instant de départ, en µs
+    \return Le nombre de microsecondes écoulées
+*/
+uint32_t timebase_elapsed_us(uint32_t since);
+
+/**
+    \brief Indique si une échéance en millisecondes est atteinte
+	\param[in]	deadline L'échéance, en ms (exe.: timebase_millis() + 500)
+    \return TRUE si l'échéance est atteinte ou dépassée
+
+	L'échéance doit être à moins de 2^31 ms (environ 24 jours) de l'instant présent.
+*/
+bool timebase_reached_ms(uint32_t deadline);
+
+/**
+    \brief Indique si une échéance en microsecondes est atteinte
+	\param[in]	deadline L'échéance, en µs (exe.: timebase_micros() + 250)
+    \return TRUE si l'échéance est atteinte ou dépassée
+
+	L'échéance doit être à moins de 2^31 µs (environ 35 minutes) de l'instant présent.
+*/
+bool timebase_reached_us(uint32_t deadline);
+
+#endif /* TIMEBASE_H_INCLUDED */
@@ -0,0 +1,152 @@
+#ifndef TRAME_H_INCLUDED
+#define TRAME_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file trame.h
+	\brief Format des trames entre la manette et la grue
+
+	Trame de commande, de la manette vers la grue:
+
+		y x g p a seq t0 t1 '\n'
+
+	Les cinq premiers octets sont les commandes; a est le mode de la grue (trame_mode_e).
+	seq est un numéro de trame de 7 bits et t0 t1 les 14 bits bas de timebase_millis()
+	de la manette, pris juste avant la lecture des commandes (7 bits bas dans t0, 7 bits
+	hauts dans t1). Ces trois octets ont le bit 7 à 1: ils ne peuvent jamais valoir '\n'.
+
+	Une trame de TRAME_LONGUEUR_SIMPLE octets (sans seq ni temps) d'une ancienne manette
+	reste acceptée par la grue.
+
+	Trame de télémétrie, de la grue vers la manette, à toutes les TRAME_BATT_PERIODE_MS:
+
+		'!' etat v0 v1 '\n'
+
+	etat est un trame_batterie_e et v0 v1 la tension filtrée de la batterie de la grue
+	en mV (14 bits, saturée à TRAME_BATT_MV_MAX), codés comme seq, t0 et t1. Les
+	réponses des commandes ?x, envoyées sur le même port, ne commencent jamais par '!'.
+
+	Bus de plusieurs grues (BOARD_UART_BUS à 1 sur les deux cartes, voir uart.h): chaque
+	grue a une adresse de 1 à TRAME_BUS_GRUES_MAX, gardée en EEPROM (commande ?N, voir
+	bus.h de la grue). La manette envoie chaque trame de commande précédée de l'adresse
+	d'une grue, à tour de rôle, une trame par créneau de TRAME_BUS_CRENEAU_MS(). Seule
+	la grue visée reçoit la trame: les autres n'ont aucune interruption de réception.
+	Liaison à 4 fils: la sortie de la manette va à toutes les grues, les sorties des
+	grues sont reliées à l'entrée de la manette. TXD0 d'une grue est une sortie
+	push-pull: une grue n'active son émetteur (TXEN0) que pendant sa réponse et le
+	coupe après le dernier caractère (uart.c). Au repos, sa broche TXD0 (PD1) est une
+	entrée avec pull-up: le fil commun reste au niveau haut (repos de l'UART) par ces
+	pull-ups internes, une pull-up externe (4,7 kohms) à l'entrée de la manette
+	renforce le repos sur un long câble. Deux grues ne tiennent la ligne ensemble que
+	si elles répondent à la même trame (UART_BROADCAST, ou deux grues de même
+	adresse): une résistance en série (1 kohm) sur chaque TXD0 limite alors le
+	courant du conflit.
+
+	Une grue ne répond qu'après une trame qui lui est adressée, au plus à toutes les
+	TRAME_BATT_PERIODE_MS, avec son adresse:
+
+		'!' etat v0 v1 adr '\n'
+
+	La réponse est plus courte que le créneau: elle est finie avant que la grue suivante
+	ne réponde à sa propre trame. Une trame sans adresse (UART_BROADCAST) est reçue par
+	toutes les grues; la manette n'en envoie pas.
+*/
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define TRAME_Y				0
+#define TRAME_X				1
+#define TRAME_G				2
+#define TRAME_P				3
+#define TRAME_A				4
+#define TRAME_SEQ			5
+#define TRAME_TEMPS_BAS		6
+#define TRAME_TEMPS_HAUT	7
+
+/* Longueurs, '\n' compris */
+#define TRAME_LONGUEUR			9
+#define TRAME_LONGUEUR_SIMPLE	6
+
+/* Modes de la grue, octet a */
+typedef enum{
+
+	TRAME_MODE_MANUEL = 0,		/* x, y, g commandent les axes */
+	TRAME_MODE_AUTO,			/* le plan de la grue commande les axes */
+	TRAME_MODE_CARTESIEN,		/* x, y déplacent la charge en ligne droite */
+
+	TRAME_MODE_NB
+
+}trame_mode_e;
+
+#define TRAME_MARQUE		0x80
+#define TRAME_SEQ_MASQUE	0x7F
+#define TRAME_TEMPS_MASQUE	0x3FFF
+
+/* Codage et décodage des champs de 7 et 14 bits */
+#define TRAME_CODE_7(v)				(TRAME_MARQUE | ((v) & 0x7F))
+#define TRAME_DECODE_7(octet)		((octet) & 0x7F)
+#define TRAME_DECODE_14(bas, haut)	((uint16_t)TRAME_DECODE_7(bas) | ((uint16_t)TRAME_DECODE_7(haut) << 7))
+
+/* Trame de télémétrie */
+#define TRAME_BATT_DEBUT		'!'
+#define TRAME_BATT_ETAT			1
+#define TRAME_BATT_MV_BAS		2
+#define TRAME_BATT_MV_HAUT		3
+#define TRAME_BATT_LONGUEUR		5
+
+#define TRAME_BATT_ADRESSE		4
+#define TRAME_BATT_LONGUEUR_BUS	6
+
+#define TRAME_BATT_PERIODE_MS	500
+#define TRAME_BATT_MV_MAX		0x3FFF
+
+typedef enum{
+
+	TRAME_BATTERIE_OK = 0,		/* moteurs compensés, sans limite */
+	TRAME_BATTERIE_FAIBLE,		/* rapport cyclique plafonné sur chaque axe */
+	TRAME_BATTERIE_VIDE,		/* moteurs arrêtés */
+	TRAME_BATTERIE_INCONNUE		/* manette: aucune télémétrie reçue récemment */
+
+}trame_batterie_e;
+
+/* Bus: adresse la plus haute, octets (adresse comprise) et bits (9 bits de données, départ
+   et arrêt) d'une trame */
+#define TRAME_BUS_GRUES_MAX		9
+#define TRAME_BUS_OCTETS		(1 + TRAME_LONGUEUR)
+#define TRAME_BUS_BITS			11
+
+/* Créneau d'une trame sur le bus, en ms: sa durée à bps bits par seconde arrondie
+   au-dessus, plus TRAME_BUS_MARGE_MS pour le retard de la réponse d'une grue */
+#define TRAME_BUS_MARGE_MS		2
+#define TRAME_BUS_CRENEAU_MS(bps)	((TRAME_BUS_OCTETS * TRAME_BUS_BITS * 1000UL + (bps) - 1) / (bps) + TRAME_BUS_MARGE_MS)
+
+_Static_assert(TRAME_BATT_LONGUEUR_BUS < TRAME_BUS_OCTETS, "La réponse d'une grue doit tenir dans le créneau de sa trame");
+
+/* Commandes au neutre: les axes en manuel s'arrêtent (voir command.h de la grue) */
+#define TRAME_NEUTRE_Y			140
+#define TRAME_NEUTRE_X			137
+#define TRAME_NEUTRE_G			128
+
+/* Symbole affiché après la tension, selon l'état: 12.1V, 10.9-, 9.8! ou --.-? */
+#define TRAME_BATT_SYMBOLE(etat)	("V-!?"[(etat) & 0x03])
+
+#endif /* TRAME_H_INCLUDED */
@@ -35,64 +35,117 @@ Includes and defines
 
 #include "uart.h"
 #include "fifo.h"
+#include "timebase.h"
 
 
 /******************************************************************************
 Static variables
 ******************************************************************************/
 
-static uint16_t baudrate_to_UBRR[] = {
-
-#if F_CPU == 8000000UL     /*Fosc = 8.0000MHz*/
-    207,    /* BAUDRATE_2400	Error : 0.2%  */
-    103,    /* BAUDRATE_4800 	Error : 0.2%  */
-    51,     /* BAUDRATE_9600 	Error : 0.2%  */
-    25,     /* BAUDRATE_19200 */
-    12,     /* BAUDRATE_38400 */
-    8,      /* BAUDRATE_57600 */
-    3,      /* BAUDRATE_115200 Error : 8.5% */
-    1,      /* BAUDRATE_230400 */
-    1,      /* BAUDRATE_250000 */
-
-#elif F_CPU == 16000000UL     /*Fosc = 16.0000MHz*/
-    416,    /* BAUDRATE_2400 */
-    207,    /* BAUDRATE_4800 */
-    103,    /* BAUDRATE_9600 */
-    51,     /* BAUDRATE_19200 */
-    25,     /* BAUDRATE_38400 */
-    16,     /* BAUDRATE_57600 */
-    8,      /* BAUDRATE_115200 */
-    3,      /* BAUDRATE_230400 */
-    3,      /* BAUDRATE_250000 */
-
-#elif F_CPU == 20000000UL   /*Fosc = 20.0000MHz*/
-    520,    /* BAUDRATE_2400 */
-    259,    /* BAUDRATE_4800 */
-    129,    /* BAUDRATE_9600 */
-    64,     /* BAUDRATE_19200 */
-    32,     /* BAUDRATE_38400 */
-    21,     /* BAUDRATE_57600 */
-    10,     /* BAUDRATE_115200 */
-    4,      /* BAUDRATE_230400 */
-    4,      /* BAUDRATE_250000 */
+/*
+	UBRR en mode normal (U2X à 0), arrondi au plus proche: F_CPU / (16 x débit) - 1. Le
+	débit réel est F_CPU / (16 x (UBRR + 1)); son écart au débit voulu est en pour mille.
+*/
+#define UBRR(bps)				((F_CPU + 8UL * (bps)) / (16UL * (bps)) - 1)
+#define UBRR_BPS(bps)			(F_CPU / (16UL * (UBRR(bps) + 1)))
+#define UBRR_ERREUR(bps)		(((UBRR_BPS(bps) > (bps)) ? UBRR_BPS(bps) - (bps) : (bps) - UBRR_BPS(bps)) * 1000UL / (bps))
+
+/* Écart toléré au débit par défaut, en pour mille: ±2 % pour des trames de 8 bits selon
+la fiche technique. Les autres débits ne sont vérifiés que par UBRR_ERREUR(); à 8 MHz,
+115200 et 230400 sont à 8,5 %. */
+#define UART_ERREUR_MAX			20
+
+_Static_assert(UBRR(2400) <= 0x0FFF, "UBRR est sur 12 bits: 2400 bauds n'est pas possible à F_CPU");
+_Static_assert(UBRR(250000) <= 0x0FFF, "F_CPU est trop lente pour 250000 bauds");
+_Static_assert(UBRR_ERREUR(UART_BAUDRATE_BPS(DEFAULT_BAUDRATE)) <= UART_ERREUR_MAX, "DEFAULT_BAUDRATE n'est pas atteignable à F_CPU");
+
+static const uint16_t baudrate_to_UBRR[] = {
+
+	[BAUDRATE_2400] = UBRR(2400),
+	[BAUDRATE_4800] = UBRR(4800),
+	[BAUDRATE_9600] = UBRR(9600),
+	[BAUDRATE_19200] = UBRR(19200),
+	[BAUDRATE_38400] = UBRR(38400),
+	[BAUDRATE_57600] = UBRR(57600),
+	[BAUDRATE_115200] = UBRR(115200),
+	[BAUDRATE_230400] = UBRR(230400),
+	[BAUDRATE_250000] = UBRR(250000),
+};
+
+/*
+	Un sens dont la taille est 0 n'a ni tampon, ni fifo, ni interruption. Les fonctions
+	appelées pour ce sens passent par no_fifo, un fifo d'un octet à la fois vide et
+	plein, que le matériel ne touche jamais: lire donne 0 et écrire est perdu. Il est
+	commun à tous les sens retirés: rien ne doit le remettre dans un état normal.
+*/
+#define UART_0_RX_ON	(UART_0_RX_BUFFER_SIZE > 0)
+#define UART_0_TX_ON	(UART_0_TX_BUFFER_SIZE > 0)
+#define UART_1_RX_ON	(UART_1_RX_BUFFER_SIZE > 0)
+#define UART_1_TX_ON	(UART_1_TX_BUFFER_SIZE > 0)
+
+_Static_assert(!UART_0_RX_ON || FIFO_SIZE_IS_VALID(UART_0_RX_BUFFER_SIZE), "UART_0_RX_BUFFER_SIZE: 0 ou une puissance de 2 jusqu'à FIFO_MAX_SIZE");
+_Static_assert(!UART_0_TX_ON || FIFO_SIZE_IS_VALID(UART_0_TX_BUFFER_SIZE), "UART_0_TX_BUFFER_SIZE: 0 ou une puissance de 2 jusqu'à FIFO_MAX_SIZE");
+_Static_assert(!UART_1_RX_ON || FIFO_SIZE_IS_VALID(UART_1_RX_BUFFER_SIZE), "UART_1_RX_BUFFER_SIZE: 0 ou une puissance de 2 jusqu'à FIFO_MAX_SIZE");
+_Static_assert(!UART_1_TX_ON || FIFO_SIZE_IS_VALID(UART_1_TX_BUFFER_SIZE), "UART_1_TX_BUFFER_SIZE: 0 ou une puissance de 2 jusqu'à FIFO_MAX_SIZE");
+
+#if BOARD_UART_BUS && !(UART_0_RX_ON && UART_0_TX_ON)
+#error "BOARD_UART_BUS: UART_0 doit recevoir et envoyer"
+#endif
 
+#if !(UART_0_RX_ON && UART_0_TX_ON && UART_1_RX_ON && UART_1_TX_ON)
+static uint8_t no_buffer[1];
+static fifo_t no_fifo = {no_buffer, 0, 0, 0, TRUE, TRUE, 0};
+#define IS_REMOVED(fifo)	((fifo) == &no_fifo)
 #else
-    #error The UBRR values are not defined for your CPU frequency
+#define IS_REMOVED(fifo)	FALSE
 #endif
-};
 
+#if UART_0_RX_ON
 static volatile uint8_t rx_buffer_0[UART_0_RX_BUFFER_SIZE];
-static volatile uint8_t tx_buffer_0[UART_0_TX_BUFFER_SIZE];
-static volatile uint8_t rx_buffer_1[UART_1_RX_BUFFER_SIZE];
-static volatile uint8_t tx_buffer_1[UART_1_TX_BUFFER_SIZE];
-
 static fifo_t rx_fifo_0;
+#define RX_FIFO_0	(&rx_fifo_0)
+#else
+#define RX_FIFO_0	(&no_fifo)
+#endif
+
+#if UART_0_TX_ON
+static volatile uint8_t tx_buffer_0[UART_0_TX_BUFFER_SIZE];
 static fifo_t tx_fifo_0;
+#define TX_FIFO_0	(&tx_fifo_0)
+#else
+#define TX_FIFO_0	(&no_fifo)
+#endif
+
+#if UART_1_RX_ON
+static volatile uint8_t rx_buffer_1[UART_1_RX_BUFFER_SIZE];
 static fifo_t rx_fifo_1;
+#define RX_FIFO_1	(&rx_fifo_1)
+#else
+#define RX_FIFO_1	(&no_fifo)
+#endif
+
+#if UART_1_TX_ON
+static volatile uint8_t tx_buffer_1[UART_1_TX_BUFFER_SIZE];
 static fifo_t tx_fifo_1;
+#define TX_FIFO_1	(&tx_fifo_1)
+#else
+#define TX_FIFO_1	(&no_fifo)
+#endif
+
+/* Fifo d'un port: une comparaison plutôt qu'un tableau, aucun port ne déborde */
+#define RX_FIFO(port)	(((port) == UART_0) ? RX_FIFO_0 : RX_FIFO_1)
+#define TX_FIFO(port)	(((port) == UART_0) ? TX_FIFO_0 : TX_FIFO_1)
+
+#if BOARD_UART_EOL_TIME
+/* Instant (timebase_micros()) de réception du dernier séparateur de ligne */
+static volatile uint32_t eol_time_list[2];
+#endif
 
-static fifo_t* rx_fifo_list[] = {&rx_fifo_0, &rx_fifo_1};
-static fifo_t* tx_fifo_list[] = {&tx_fifo_0, &tx_fifo_1};
+#if BOARD_UART_BUS
+/* Adresse de la carte sur le bus de UART_0, et ligne commencée mais pas terminée */
+static volatile uint8_t bus_address = UART_BROADCAST;
+static volatile bool bus_line_open = FALSE;
+#endif
 
 
 /******************************************************************************
@@ -105,58 +158,135 @@ static void disable_UDRE_interupt(uart_e port);
 static void enable_RX_interupt(uart_e port);
 static void disable_RX_interupt(uart_e port);
 
+#if UART_0_RX_ON
+static void rx_push_0(uint8_t byte);
+#endif
+#if BOARD_UART_BUS
+static void rx_address_0(uint8_t adresse);
+#endif
+
 
 /******************************************************************************
 Interupts
 ******************************************************************************/
 
+#if UART_0_TX_ON
 /**
     \brief interupt quand le data register (UDRE) est prêt à recevoir d'autres
     données pour UART 0
 */
 ISR(USART0_UDRE_vect){
 
+    PROFILE_BEGIN(PROFILE_ZONE_ISR_UART0_UDRE);
+
+#if BOARD_UART_BUS
+    // Une donnée: 9e bit à 0, uart_put_address() l'a laissé à 1 après l'adresse
+    UCSR0B = clear_bit(UCSR0B, TXB80);
+#endif
+
     UDR0 = fifo_pop(&tx_fifo_0);
 
     if(fifo_is_empty(&tx_fifo_0) == TRUE){
 
         disable_UDRE_interupt(UART_0);
+
+#if BOARD_UART_BUS
+        // Carte adressée: TXD0 est relâchée après ce caractère, l'arrêt de l'émetteur
+        // attend la fin de l'envoi (voir uart_set_address())
+        if(bus_address != UART_BROADCAST){
+
+            UCSR0B = clear_bit(UCSR0B, TXEN0);
+        }
+#endif
     }
+
+    PROFILE_END(PROFILE_ZONE_ISR_UART0_UDRE);
 }
+#endif
 
+#if UART_0_RX_ON
 /**
     \brief interupt quand le data register (UDR) a reçu une nouvelle donnée
     pour UART 0
 */
 ISR(USART0_RX_vect){
 
-    fifo_push(&rx_fifo_0, UDR0);
+    PROFILE_BEGIN(PROFILE_ZONE_ISR_UART0_RX);
+
+#if BOARD_UART_BUS
+    // Le 9e bit se lit avant UDR0
+    if(read_bit(UCSR0B, RXB80)){
+
+        rx_address_0(UDR0);
+    }
+
+    else{
+
+        uint8_t byte = UDR0;
+
+        bus_line_open = (byte != FIFO_LINE_SEPERATOR);
+        rx_push_0(byte);
+    }
+#else
+    rx_push_0(UDR0);
+#endif
+
+    PROFILE_END(PROFILE_ZONE_ISR_UART0_RX);
 }
+#endif
 
 
+#if UART_1_TX_ON
 /**
     \brief interupt quand le data register (UDRE) est prêt à recevoir d'autres
     données pour UART 1
 */
 ISR(USART1_UDRE_vect){
 
+    PROFILE_BEGIN(PROFILE_ZONE_ISR_UART1_UDRE);
+
     UDR1 = fifo_pop(&tx_fifo_1);
 
     if(fifo_is_empty(&tx_fifo_1)){
 
         disable_UDRE_interupt(UART_1);
     }
+
+    PROFILE_END(PROFILE_ZONE_ISR_UART1_UDRE);
 }
+#endif
 
 
+#if UART_1_RX_ON
 /**
     \brief interupt quand le data register (UDR) a reçu une nouvelle donnée
     pour UART 1
 */
 ISR(USART1_RX_vect){
 	
-    fifo_push(&rx_fifo_1, UDR1);
+    PROFILE_BEGIN(PROFILE_ZONE_ISR_UART1_RX);
+
+    uint8_t byte = UDR1;
+
+    // Tampon plein sans '\n': aucune ligne ne pourrait plus être lue. La ligne
+    // incomplète est jetée et la réception se resynchronise au prochain '\n'.
+    if(fifo_is_full(&rx_fifo_1) && (fifo_nb_line(&rx_fifo_1) == 0)){
+
+        fifo_clean(&rx_fifo_1);
+    }
+
+    fifo_push(&rx_fifo_1, byte);
+
+#if BOARD_UART_EOL_TIME
+    if(byte == FIFO_LINE_SEPERATOR){
+
+        eol_time_list[UART_1] = timebase_micros();
+    }
+#endif
+
+    PROFILE_END(PROFILE_ZONE_ISR_UART1_RX);
 }
+#endif
 
 /******************************************************************************
 Global functions
@@ -178,19 +308,23 @@ void uart_init(uart_e port){
                     (0 << UCPOL0));  /*0 when asynchronous mode is used*/
 
         /* enable RxD/TxD and ints */
-        UCSR0B = (  (1 << RXCIE0) |  /*RX Complete Interrupt Enable*/
+        UCSR0B = (  (UART_0_RX_ON << RXCIE0) |  /*RX Complete Interrupt Enable*/
                     (0 << TXCIE0) |  /*TX Complete Interrupt Enable */
                     (0 << UDRIE0) |  /*Data Register Empty Interrupt Enable */
-                    (1 << RXEN0) |   /*Receiver Enable*/
-                    (1 << TXEN0) |   /*Transmitter Enable*/
-                    (0 << UCSZ02));  /*Character Size : 8-bit*/
+                    (UART_0_RX_ON << RXEN0) |   /*Receiver Enable*/
+                    (UART_0_TX_ON << TXEN0) |   /*Transmitter Enable*/
+                    (BOARD_UART_BUS << UCSZ02));  /*Character Size : 8-bit, 9-bit sur un bus*/
 
         UCSR0A = (  (0 << U2X0) |    /*Double the USART Transmission Speed*/
                     (0 << MPCM0));   /*Multi-processor Communication Mode*/
 
         /*initialisation des fifos respectifs */
+#if UART_0_RX_ON
         fifo_init(&rx_fifo_0, (uint8_t*)rx_buffer_0, UART_0_RX_BUFFER_SIZE);
+#endif
+#if UART_0_TX_ON
         fifo_init(&tx_fifo_0, (uint8_t*)tx_buffer_0, UART_0_TX_BUFFER_SIZE);
+#endif
 
         break;
 
@@ -206,19 +340,23 @@ void uart_init(uart_e port){
                     (1 << UCSZ00) |  /*Character Size : 8-bit*/
                     (0 << UCPOL0));  /*0 when asynchronous mode is used*/
 
-        UCSR1B = (  (1 << RXCIE0) |  /*RX Complete Interrupt Enable*/
+        UCSR1B = (  (UART_1_RX_ON << RXCIE0) |  /*RX Complete Interrupt Enable*/
                     (0 << TXCIE0) |  /*TX Complete Interrupt Enable */
                     (0 << UDRIE0) |  /*Data Register Empty Interrupt Enable */
-                    (1 << RXEN0) |   /*Receiver Enable*/
-                    (1 << TXEN0) |   /*Transmitter Enable*/
+                    (UART_1_RX_ON << RXEN0) |   /*Receiver Enable*/
+                    (UART_1_TX_ON << TXEN0) |   /*Transmitter Enable*/
                     (0 << UCSZ02));  /*Character Size : 8-bit*/
 
         UCSR1A = (  (0 << U2X0) |    /*Double the USART Transmission Speed*/
                     (0 << MPCM0));   /*Multi-processor Communication Mode*/
 
         /*initialisation des fifos respectifs */
+#if UART_1_RX_ON
         fifo_init(&rx_fifo_1, (uint8_t*)rx_buffer_1, UART_1_RX_BUFFER_SIZE);
+#endif
+#if UART_1_TX_ON
         fifo_init(&tx_fifo_1, (uint8_t*)tx_buffer_1, UART_1_TX_BUFFER_SIZE);
+#endif
 
 
         break;
@@ -254,7 +392,7 @@ void uart_put_byte(uart_e port, uint8_t byte){
     //se produise pendant qu'on ajoute un caractère au buffer
     disable_UDRE_interupt(port);
 
-    fifo_push(tx_fifo_list[port], byte);
+    fifo_push(TX_FIFO(port), byte);
 
     // On active l'interrupt après avoir incrémenté le pointeur
     // d'entré pour éviter un dead lock assez casse-tête
@@ -268,20 +406,26 @@ void uart_put_string(uart_e port, char* string){
 
 	uint8_t i = 0;
 
+	// Sens retiré: rien ne viderait le fifo, l'attente ci-dessous serait infinie
+	if(IS_REMOVED(TX_FIFO(port))){
+
+		return;
+	}
+
 	while(string[i] != '\0'){
 
 		// On attend à l'infini qu'il y ait de la place dans le buffer. Je ne me
 		// souviens pas d'avoir écrit ça, et je ne trouve pas ça du très beau code.
 		//TODO évaluer la pertinance
-		while(fifo_is_full(tx_fifo_list[port])  == TRUE);
+		while(fifo_is_full(TX_FIFO(port))  == TRUE);
 
 		//on commence par désactiver l'interuption pour éviter que celle-ci
 		//se produise pendant qu'on ajoute un caractère au buffer
 		disable_UDRE_interupt(port);
 
-		while((string[i] != '\0') && (fifo_is_full(tx_fifo_list[port])  == FALSE)){
+		while((string[i] != '\0') && (fifo_is_full(TX_FIFO(port))  == FALSE)){
 
-			fifo_push(tx_fifo_list[port], string[i]);
+			fifo_push(TX_FIFO(port), string[i]);
 
 			i++;
 		}
@@ -300,7 +444,7 @@ uint8_t uart_get_byte(uart_e port){
 
     disable_RX_interupt(port);
 
-    byte = fifo_pop(rx_fifo_list[port]);
+    byte = fifo_pop(RX_FIFO(port));
 
     enable_RX_interupt(port);
 
@@ -365,7 +509,13 @@ int uart_get_line(uart_e port, char* out_buffer, uint8_t buffer_length){
 /*** uart_clean_rx_buffer ***/
 void uart_clean_rx_buffer(uart_e port){
 
-	fifo_clean(rx_fifo_list[port]);
+	// fifo_clean() le rendrait non plein: le prochain octet écrit serait gardé
+	if(IS_REMOVED(RX_FIFO(port))){
+
+		return;
+	}
+
+	fifo_clean(RX_FIFO(port));
 }
 
 /*** uart_flush ***/
@@ -377,21 +527,104 @@ void uart_flush(uart_e port){
 /*** is_rx_buffer_empty ***/
 bool uart_is_rx_buffer_empty(uart_e port){
 
-    return fifo_is_empty(rx_fifo_list[port]);
+    return fifo_is_empty(RX_FIFO(port));
 }
 
 /*** is_tx_buffer_empty ***/
 bool uart_is_tx_buffer_empty(uart_e port){
 
-    return fifo_is_empty(tx_fifo_list[port]);
+    return fifo_is_empty(TX_FIFO(port));
+}
+
+/*** is_tx_buffer_full ***/
+bool uart_is_tx_buffer_full(uart_e port){
+
+    return fifo_is_full(TX_FIFO(port));
 }
 
 /*** uart_rx_buffer_nb_line ***/
 
 int uart_rx_buffer_nb_line(uart_e port){
 
-	return fifo_nb_line(rx_fifo_list[port]);
+	return fifo_nb_line(RX_FIFO(port));
+}
+
+
+#if BOARD_UART_EOL_TIME
+/*** uart_get_eol_time ***/
+
+uint32_t uart_get_eol_time(uart_e port){
+
+	uint32_t time;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		time = eol_time_list[port];
+	}
+
+	return time;
+}
+#endif
+
+
+#if BOARD_UART_BUS
+/*** uart_set_address ***/
+
+void uart_set_address(uart_e port, uint8_t adresse){
+
+	if(port != UART_0){
+
+		return;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		bus_address = adresse;
+
+		// Rien n'est reçu avant la prochaine adresse, sauf pour UART_BROADCAST
+		UCSR0A = (adresse == UART_BROADCAST) ? 0 : (1 << MPCM0);
+
+		// Une carte adressée ne tient TXD0 que pendant ses envois: pull-up au repos, et
+		// émetteur arrêté tout de suite s'il n'a rien à envoyer (sinon par l'interruption
+		// UDRE, après le dernier octet)
+		if(adresse == UART_BROADCAST){
+
+			UCSR0B = set_bit(UCSR0B, TXEN0);
+		}
+
+		else{
+
+			PORTD = set_bit(PORTD, PD1);
+
+			if(fifo_is_empty(&tx_fifo_0) && !read_bit(UCSR0B, UDRIE0)){
+
+				UCSR0B = clear_bit(UCSR0B, TXEN0);
+			}
+		}
+	}
+}
+
+
+/*** uart_put_address ***/
+
+void uart_put_address(uart_e port, uint8_t adresse){
+
+	if(port != UART_0){
+
+		return;
+	}
+
+	while((fifo_is_empty(&tx_fifo_0) == FALSE) || !read_bit(UCSR0A, UDRE0));
+
+	// UDRE0 à 1 et le fifo vide: l'interruption UDRE est désactivée jusqu'au prochain
+	// octet, qui remettra le 9e bit à 0
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		UCSR0B = set_bit(UCSR0B, TXB80);
+		UDR0 = adresse;
+	}
 }
+#endif
 
 
 /******************************************************************************
@@ -403,12 +636,20 @@ static void enable_UDRE_interupt(uart_e port){
     switch(port){
     case UART_0:
 
+#if BOARD_UART_BUS
+        // TXD0 relâchée depuis le dernier envoi d'une carte adressée: l'émetteur la reprend
+        UCSR0B = set_bit(UCSR0B, TXEN0);
+#endif
+#if UART_0_TX_ON
         UCSR0B = set_bit(UCSR0B, UDRIE0);
+#endif
         break;
 
     case UART_1:
 
+#if UART_1_TX_ON
         UCSR1B = set_bit(UCSR1B, UDRIE1);
+#endif
         break;
     }
 }
@@ -433,12 +674,16 @@ static void enable_RX_interupt(uart_e port){
     switch(port){
     case UART_0:
 
+#if UART_0_RX_ON
         UCSR0B = set_bit(UCSR0B, RXCIE0);
+#endif
         break;
 
     case UART_1:
 
+#if UART_1_RX_ON
         UCSR1B = set_bit(UCSR1B, RXCIE1);
+#endif
         break;
     }
 }
@@ -458,3 +703,44 @@ static void disable_RX_interupt(uart_e port){
     }
 
 }
+
+
+#if UART_0_RX_ON
+/* Met un octet reçu sur UART_0 dans le tampon de réception */
+static void rx_push_0(uint8_t byte){
+
+    // Tampon plein sans '\n': aucune ligne ne pourrait plus être lue. La ligne
+    // incomplète est jetée et la réception se resynchronise au prochain '\n'.
+    if(fifo_is_full(&rx_fifo_0) && (fifo_nb_line(&rx_fifo_0) == 0)){
+
+        fifo_clean(&rx_fifo_0);
+    }
+
+    fifo_push(&rx_fifo_0, byte);
+
+#if BOARD_UART_EOL_TIME
+    if(byte == FIFO_LINE_SEPERATOR){
+
+        eol_time_list[UART_0] = timebase_micros();
+    }
+#endif
+}
+#endif
+
+
+#if BOARD_UART_BUS
+/* Adresse reçue sur UART_0: ouvre la réception si elle vise la carte, la ferme sinon */
+static void rx_address_0(uint8_t adresse){
+
+    bool pour_moi = (bus_address == UART_BROADCAST) || (adresse == bus_address) || (adresse == UART_BROADCAST);
+
+    // La ligne coupée par l'adresse ne doit pas se coller à la suivante
+    if(bus_line_open){
+
+        bus_line_open = FALSE;
+        rx_push_0(FIFO_LINE_SEPERATOR);
+    }
+
+    UCSR0A = pour_moi ? 0 : (1 << MPCM0);
+}
+#endif
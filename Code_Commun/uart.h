@@ -32,17 +32,19 @@
 Includes
 ******************************************************************************/
 
+#include "board.h"
 #include "utils.h"
 
 /******************************************************************************
 Defines
 ******************************************************************************/
 
-#define UART_0_RX_BUFFER_SIZE 150
-#define UART_0_TX_BUFFER_SIZE 150
-
-#define UART_1_RX_BUFFER_SIZE 16
-#define UART_1_TX_BUFFER_SIZE 16
+/*
+	La taille des tampons de chaque port et de chaque sens vient de board_config.h: une
+	puissance de 2 jusqu'à FIFO_MAX_SIZE (128), ou 0 pour retirer ce sens (tampon, fifo
+	et interruption ne sont pas compilés, le récepteur ou l'émetteur n'est pas activé
+	par uart_init()).
+*/
 
 typedef enum{
 
@@ -68,6 +70,26 @@ typedef enum{
 
 #define DEFAULT_BAUDRATE BAUDRATE_9600
 
+/* Débit de chaque baudrate_e, en bits par seconde */
+#define UART_BAUDRATE_BPS(baudrate)	((baudrate) == BAUDRATE_2400 ? 2400UL :		\
+									(baudrate) == BAUDRATE_4800 ? 4800UL :		\
+									(baudrate) == BAUDRATE_9600 ? 9600UL :		\
+									(baudrate) == BAUDRATE_19200 ? 19200UL :	\
+									(baudrate) == BAUDRATE_38400 ? 38400UL :	\
+									(baudrate) == BAUDRATE_57600 ? 57600UL :	\
+									(baudrate) == BAUDRATE_115200 ? 115200UL :	\
+									(baudrate) == BAUDRATE_230400 ? 230400UL : 250000UL)
+
+/*
+	Bus de plusieurs cartes sur UART_0 (BOARD_UART_BUS à 1, board_config.h): les
+	caractères ont 9 bits. Un caractère dont le 9e bit est à 1 est une adresse, les
+	autres sont des données. Une carte qui a une adresse (uart_set_address()) reste en
+	mode multiprocesseur (MPCM0) tant que l'adresse reçue n'est pas la sienne: l'USART
+	jette alors les données des autres cartes sans lever d'interruption. Les données qui
+	suivent UART_BROADCAST sont reçues par toutes les cartes.
+*/
+#define UART_BROADCAST	0
+
 /******************************************************************************
 Prototypes
 ******************************************************************************/
@@ -177,6 +199,11 @@ void uart_get_string(uart_e port, char* out_buffer, uint8_t buffer_length);
 
 	Pour garantir que cette situation ne se produira jamais, il suffit de passer un
 	buffer plus gros que UART_RX_BUFFER_SIZE
+
+	Si le buffer de réception se remplit sans contenir de '\n', la ligne incomplète est
+	jetée par l'interruption de réception: la ligne suivante peut être lue, la ligne
+	perdue arrive tronquée et doit être rejetée par l'appelant (voir command.h de la
+	grue).
 */
 int uart_get_line(uart_e port, char* out_buffer, uint8_t buffer_length);
 
@@ -211,6 +238,13 @@ bool uart_is_rx_buffer_empty(uart_e port);
 */
 bool uart_is_tx_buffer_empty(uart_e port);
 
+/**
+    \brief Indique si le buffer de transmission est plein.
+	\param port Le numéro du port du microcontrôleur (UART_0 ou UART_1)
+    \return TRUE si il est plein, FALSE s'il peut recevoir au moins 1 byte
+*/
+bool uart_is_tx_buffer_full(uart_e port);
+
 /**
     \brief Indique le nombre de ligne dans le buffer de réception.
 	\param port Le numéro du port du microcontrôleur (UART_0 ou UART_1)
@@ -218,4 +252,46 @@ bool uart_is_tx_buffer_empty(uart_e port);
 */
 int uart_rx_buffer_nb_line(uart_e port);
 
+#if BOARD_UART_EOL_TIME
+/**
+    \brief Indique quand le dernier séparateur de ligne a été reçu.
+	\param port Le numéro du port du microcontrôleur (UART_0 ou UART_1)
+    \return l'instant de réception, en µs (timebase_micros())
+
+	L'instant est pris dans l'interruption de réception: il ne comprend pas l'attente
+	avant l'appel à uart_get_line(). Si plusieurs lignes sont en attente, c'est
+	l'instant de la plus récente.
+
+	Seulement sur une carte avec BOARD_UART_EOL_TIME (board_config.h).
+*/
+uint32_t uart_get_eol_time(uart_e port);
+#endif
+
+#if BOARD_UART_BUS
+/**
+    \brief Ne reçoit plus que les données qui suivent son adresse sur le bus
+	\param port Le numéro du port du microcontrôleur (UART_0 seulement)
+	\param adresse L'adresse de la carte, UART_BROADCAST pour tout recevoir
+
+	Les adresses reçues ne sont jamais mises dans le tampon de réception. Une ligne
+	incomplète quand une adresse arrive est terminée par un '\n': elle arrive tronquée
+	et doit être rejetée par l'appelant, comme une ligne perdue (voir uart_get_line()).
+
+	Seulement sur une carte avec BOARD_UART_BUS (board_config.h).
+*/
+void uart_set_address(uart_e port, uint8_t adresse);
+
+/**
+    \brief Envoie une adresse: les octets envoyés ensuite vont à la carte qui l'a
+	\param port Le numéro du port du microcontrôleur (UART_0 seulement)
+	\param adresse L'adresse de la carte, UART_BROADCAST pour toutes
+
+	Attend que le buffer de transmission soit vide, puis écrit l'adresse directement
+	dans UDR0: le 9e bit ne peut changer qu'entre deux caractères.
+
+	Seulement sur une carte avec BOARD_UART_BUS (board_config.h).
+*/
+void uart_put_address(uart_e port, uint8_t adresse);
+#endif
+
 #endif // UART_H_INCLUDED
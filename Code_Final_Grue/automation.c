@@ -0,0 +1,374 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file automation.c
+	\brief Mode automatique: rejeu d'un plan de mouvements rangé en flash
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/pgmspace.h>
+#include "automation.h"
+#include "automation_plan.h"
+#include "autotune.h"
+#include "homing.h"
+#include "kinematics.h"
+#include "pid.h"
+#include "shaper.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+_Static_assert(AUTOMATION_PLAN_NB > 0, "le plan (automation_plan.h) est vide");
+_Static_assert(AUTOMATION_PLAN_NB < 256, "le plan (automation_plan.h) a trop de segments");
+
+/* Point le plus loin accepté par ?G, en mm */
+#define GOTO_MAX_MM		2000
+
+/* Vitesses à AUTOMATION_GOTO_DUTY, en °/s et mm/s (kinematics.h) */
+#define GOTO_FLECHE_V	((uint32_t)KINEMATICS_FLECHE_VMAX * (AUTOMATION_GOTO_DUTY - KINEMATICS_FLECHE_SEUIL) / 255)
+#define GOTO_CHARIOT_V	((uint32_t)KINEMATICS_CHARIOT_VMAX * (AUTOMATION_GOTO_DUTY - KINEMATICS_CHARIOT_SEUIL) / 255)
+
+_Static_assert((AUTOMATION_GOTO_DUTY > KINEMATICS_FLECHE_SEUIL) && (AUTOMATION_GOTO_DUTY > KINEMATICS_CHARIOT_SEUIL),
+	"AUTOMATION_GOTO_DUTY doit dépasser le seuil de frottement");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static uint8_t prochain = 0;			/* prochain segment à commencer */
+static uint8_t quille = 0;
+static bool en_cours[MOTOR_NB];			/* segment en cours de chaque axe */
+static uint8_t sens[MOTOR_NB];
+static uint32_t fin[MOTOR_NB];				/* ms depuis le passage en mode automatique */
+static uint16_t cible[MOTOR_NB];			/* 1/16 de degré ou mm, ou AUTOMATION_SANS_CIBLE */
+static uint32_t maintenant = 0;
+static bool mode_auto = FALSE;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void commencer(uint8_t axe, uint8_t sens_axe, uint8_t duty, uint32_t fin_ms, uint16_t cible_axe);
+static void deplacer(uint8_t axe, uint16_t depart, uint16_t but, uint16_t vitesse, uint16_t avance);
+static bool cible_atteinte(uint8_t axe, const kinematics_polar_t* position);
+static bool lire_coordonnee(const char* debut, const char* fin_texte, int16_t* valeur);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void automation_start(void){
+
+	prochain = 0;
+	quille = 0;
+	maintenant = 0;
+	mode_auto = FALSE;
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		en_cours[i] = FALSE;
+	}
+}
+
+
+void automation_stop(void){
+
+	mode_auto = FALSE;
+	autotune_stop();
+	pid_stop();
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		if(en_cours[i]){
+
+			motor_set_duty(i, 0);
+			en_cours[i] = FALSE;
+		}
+	}
+}
+
+
+uint8_t automation_process(uint32_t ecoule_ms){
+
+	// Sans zéro, les angles du plan ne veulent rien dire: il attend au début (homing.h)
+	if(!homing_is_done()){
+
+		automation_start();
+		return 0;
+	}
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+	maintenant = ecoule_ms;
+	mode_auto = TRUE;
+
+	// Segments qui commencent: lus de la flash, dans l'ordre du plan
+	while((prochain < AUTOMATION_PLAN_NB) &&
+		(pgm_read_word(&automation_plan[prochain].debut_ms) <= ecoule_ms)){
+
+		automation_step_t step;
+
+		memcpy_P(&step, &automation_plan[prochain], sizeof(step));
+		prochain++;
+
+		uint16_t c = step.cible;
+
+		if((c != AUTOMATION_SANS_CIBLE) && (step.axe == MOTOR_FLECHE)){
+
+			c *= KINEMATICS_DEGRE;
+		}
+
+		quille = step.quille;
+		commencer(step.axe, step.sens, step.duty, step.fin_ms, c);
+	}
+
+	// Segments qui finissent: à leur fin, ou à leur cible
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		if(en_cours[i] && ((ecoule_ms >= fin[i]) || cible_atteinte(i, &position))){
+
+			motor_set_duty(i, 0);
+			en_cours[i] = FALSE;
+		}
+	}
+
+	// Boucle de position de la flèche: automation_goto() et autotune.h
+	pid_process();
+
+	return quille;
+}
+
+
+bool automation_goto(int16_t x, int16_t y){
+
+	kinematics_polar_t but, position;
+
+	if(!kinematics_inverse(x, y, &but)){
+
+		return FALSE;
+	}
+
+	kinematics_get(&position);
+
+	// Le reste du plan est abandonné, la glissière arrêtée
+	prochain = AUTOMATION_PLAN_NB;
+	automation_stop();
+	mode_auto = TRUE;
+
+	// Flèche réglée (autotune.h): la boucle de position l'amène à sa cible
+	pid_gains_t gains;
+
+	if(pid_get_gains(&gains)){
+
+		pid_start(but.angle);
+	}
+
+	// Chaque axe part vers sa cible, sans traverser 0° pour la flèche. La mise en forme
+	// (shaper.h) arrête l'axe plus tard: la cible est avancée d'autant
+	uint32_t aire = shaper_get_stop_area(AUTOMATION_GOTO_DUTY, KINEMATICS_FLECHE_SEUIL);
+
+	if(!pid_is_active()){
+
+		deplacer(MOTOR_FLECHE, position.angle, but.angle, GOTO_FLECHE_V * KINEMATICS_DEGRE,
+			aire * KINEMATICS_FLECHE_VMAX * KINEMATICS_DEGRE / (255UL * 1000));
+	}
+
+	aire = shaper_get_stop_area(AUTOMATION_GOTO_DUTY, KINEMATICS_CHARIOT_SEUIL);
+
+	deplacer(MOTOR_CHARIOT, position.chariot_mm, but.chariot_mm, GOTO_CHARIOT_V,
+		aire * KINEMATICS_CHARIOT_VMAX / (255UL * 1000));
+
+	return TRUE;
+}
+
+
+bool automation_release(void){
+
+	if(!mode_auto){
+
+		return FALSE;
+	}
+
+	prochain = AUTOMATION_PLAN_NB;
+	automation_stop();
+	mode_auto = TRUE;
+
+	return TRUE;
+}
+
+
+bool automation_done(void){
+
+	if(pid_is_active()){
+
+		return FALSE;
+	}
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		if(en_cours[i]){
+
+			return FALSE;
+		}
+	}
+
+	return prochain == AUTOMATION_PLAN_NB;
+}
+
+
+bool automation_command(const char* ligne, uint8_t longueur){
+
+	char texte[24];
+	int16_t x, y;
+
+	if((longueur < 2) || (ligne[0] != '?') || (ligne[1] != 'G')){
+
+		return FALSE;
+	}
+
+	// ?G+<x>,+<y>: la virgule sépare les deux coordonnées
+	const char* fin_texte = ligne + longueur - 1;
+	const char* virgule = ligne + 2;
+
+	while((virgule < fin_texte) && (*virgule != ',')){
+
+		virgule++;
+	}
+
+	if((virgule == fin_texte) || !lire_coordonnee(ligne + 2, virgule, &x) ||
+		!lire_coordonnee(virgule + 1, fin_texte, &y)){
+
+		uart_put_string(UART_0, "goto ?G+<x>,+<y>\n");
+		return TRUE;
+	}
+
+	if(!mode_auto){
+
+		uart_put_string(UART_0, "goto mode auto\n");
+		return TRUE;
+	}
+
+	if(!automation_goto(x, y)){
+
+		uart_put_string(UART_0, "goto hors portee\n");
+		return TRUE;
+	}
+
+	kinematics_polar_t but;
+
+	kinematics_inverse(x, y, &but);
+	sprintf(texte, "goto a=%u c=%u\n", but.angle / KINEMATICS_DEGRE, but.chariot_mm);
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void commencer(uint8_t axe, uint8_t sens_axe, uint8_t duty, uint32_t fin_ms, uint16_t cible_axe){
+
+	en_cours[axe] = TRUE;
+	sens[axe] = sens_axe;
+	fin[axe] = fin_ms;
+	cible[axe] = cible_axe;
+
+	motor_set(axe, sens_axe, duty);
+}
+
+
+/* Déplacement de automation_goto(), en unités de la cible: vitesse par seconde, avance
+   parcourue après l'arrêt */
+static void deplacer(uint8_t axe, uint16_t depart, uint16_t but, uint16_t vitesse, uint16_t avance){
+
+	uint16_t ecart = (but > depart) ? but - depart : depart - but;
+
+	if(ecart == 0){
+
+		return;
+	}
+
+	uint8_t sens_axe = (but < depart);
+	uint16_t cible_axe = (ecart <= avance) ? depart : sens_axe ? but + avance : but - avance;
+	uint32_t duree = (uint32_t)ecart * 1000 / vitesse;
+
+	commencer(axe, sens_axe, AUTOMATION_GOTO_DUTY,
+		maintenant + duree * 3 / 2 + shaper_get_duration_ms() + AUTOMATION_GOTO_MARGE_MS, cible_axe);
+}
+
+
+/* La broche de direction à 0 fait monter l'angle (sens horaire de l'encodeur) et sortir le chariot */
+static bool cible_atteinte(uint8_t axe, const kinematics_polar_t* position){
+
+	uint16_t valeur;
+
+	if(cible[axe] == AUTOMATION_SANS_CIBLE){
+
+		return FALSE;
+	}
+
+	if(axe == MOTOR_FLECHE){
+
+		valeur = position->angle;
+	}
+
+	else if(axe == MOTOR_CHARIOT){
+
+		valeur = position->chariot_mm;
+	}
+
+	else{
+
+		return FALSE;
+	}
+
+	return sens[axe] ? (valeur <= cible[axe]) : (valeur >= cible[axe]);
+}
+
+
+/* Signe suivi de 1 à 4 chiffres, jusqu'à fin_texte */
+static bool lire_coordonnee(const char* debut, const char* fin_texte, int16_t* valeur){
+
+	uint8_t taille = fin_texte - debut;
+
+	if((taille < 2) || (taille > 5) || ((debut[0] != '+') && (debut[0] != '-'))){
+
+		return FALSE;
+	}
+
+	for(const char* p = debut + 1; p < fin_texte; p++){
+
+		if((*p < '0') || (*p > '9')){
+
+			return FALSE;
+		}
+	}
+
+	*valeur = char_array_to_int16(debut, taille);
+
+	return (*valeur >= -GOTO_MAX_MM) && (*valeur <= GOTO_MAX_MM);
+}
@@ -0,0 +1,149 @@
+#ifndef AUTOMATION_H_INCLUDED
+#define AUTOMATION_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file automation.h
+	\brief Mode automatique: rejeu d'un plan de mouvements rangé en flash
+
+	Le plan est une table de segments triés par début, générée hors ligne par
+	tools/planner/planner.py à partir de la position des quilles et des limites de
+	vitesse et d'accélération de chaque axe (automation_plan.h). Chaque segment:
+
+		début, fin		instants en ms depuis le passage en mode automatique
+		axe, sens		l'axe (motor_e) et le niveau de sa broche de direction
+		duty			le rapport cyclique pendant le segment
+		cible			position où l'axe est arrêté avant la fin: angle (degrés) de la
+						flèche ou course (mm) du chariot, ou AUTOMATION_SANS_CIBLE
+		quille			l'étape notée dans la boîte noire au début du segment
+
+	Les segments de plusieurs axes se chevauchent: les axes bougent en même temps.
+	L'arrêt à la fin d'un segment se fait selon le mode d'arrêt de l'axe (motor.h).
+	L'angle cible ne doit pas traverser 0°: le plan suit l'angle de 0 à 345°. La cible
+	est comparée à la position estimée de kinematics.h, recalée par l'encodeur et les
+	fins de course: la flèche s'arrête au front de l'encodeur pour un multiple de 15°.
+	Le plan part de la position laissée par la recherche du zéro (homing.h), chariot
+	sur sa fin de course côté mât: sa première commande du chariot l'en éloigne.
+
+	automation_goto() remplace le reste du plan par un déplacement vers un point du
+	plan horizontal: la cinématique inverse donne l'angle et la course du chariot, et
+	les deux axes partent ensemble à AUTOMATION_GOTO_DUTY jusqu'à leur cible, avancée de
+	ce que l'axe parcourt pendant son arrêt mis en forme (shaper_get_stop_area()). Une
+	fois ses gains réglés (autotune.h), la flèche y va par sa boucle de position (pid.h). La
+	commande ?G+<x mm>,+<y mm> (signes obligatoires, exe.: ?G+300,-150) le demande en
+	mode automatique et répond:
+
+		goto a=<degrés> c=<mm>, goto hors portee ou goto mode auto
+
+	En mode automatique, le plan commande seul les moteurs: les trames de la manette
+	ne commandent plus que la pince.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "motor.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define AUTOMATION_SANS_CIBLE	0xFFFF
+
+/* Rapport cyclique des déplacements de automation_goto() */
+#define AUTOMATION_GOTO_DUTY	200
+
+/* Garde-fou d'un déplacement vers une cible: 150 % de la durée prévue, plus 500 ms */
+#define AUTOMATION_GOTO_MARGE_MS	500
+
+typedef struct{
+
+	uint16_t debut_ms;
+	uint16_t fin_ms;
+	uint8_t axe;			/* motor_e */
+	uint8_t sens;			/* niveau de la broche de direction */
+	uint8_t duty;
+	uint16_t cible;			/* degrés ou mm, ou AUTOMATION_SANS_CIBLE */
+	uint8_t quille;
+
+}automation_step_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Reprend le plan au début, sans toucher aux moteurs
+    \return rien.
+
+	À appeler tant que la grue n'est pas en mode automatique.
+*/
+void automation_start(void);
+
+/**
+    \brief Arrête les axes commandés par le plan
+    \return rien.
+
+	À appeler à la sortie du mode automatique, avant la commande de la manette.
+*/
+void automation_stop(void);
+
+/**
+    \brief Commence et arrête les segments arrivés à échéance
+	\param[in]	ecoule_ms Le temps depuis le passage en mode automatique
+    \return La quille du dernier segment commencé, 0 avant le premier
+
+	À appeler après kinematics_update(). Sans zéro (homing_is_done()), le plan reste à
+	son début et ecoule_ms doit repartir de 0 à la fin de la recherche.
+*/
+uint8_t automation_process(uint32_t ecoule_ms);
+
+/**
+    \brief Remplace le reste du plan par un déplacement vers un point
+	\param[in]	x, y Le point du plan horizontal, en mm (kinematics.h)
+    \return TRUE si le déplacement commence, FALSE si le point est hors de portée
+*/
+bool automation_goto(int16_t x, int16_t y);
+
+/**
+    \brief Abandonne le reste du plan et arrête ses axes, pour un autre usage de la grue
+    \return TRUE en mode automatique, FALSE sinon (rien n'est fait)
+
+	Les moteurs restent à la commande de automation_goto() ou autotune.h.
+*/
+bool automation_release(void);
+
+/**
+    \brief Indique si le plan est terminé
+    \return TRUE si tous les segments sont finis
+*/
+bool automation_done(void);
+
+/**
+    \brief Traite la commande ?G
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool automation_command(const char* ligne, uint8_t longueur);
+
+#endif /* AUTOMATION_H_INCLUDED */
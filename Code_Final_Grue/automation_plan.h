@@ -0,0 +1,54 @@
+#ifndef AUTOMATION_PLAN_H_INCLUDED
+#define AUTOMATION_PLAN_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file automation_plan.h
+	\brief Plan du mode automatique, généré par tools/planner/planner.py
+
+	Source: quilles.txt. Ne pas modifier: relancer make -C tools/planner.
+*/
+
+#include <avr/pgmspace.h>
+#include "automation.h"
+
+#define AUTOMATION_PLAN_NB		14
+#define AUTOMATION_PLAN_CYCLE_MS	31383
+
+static const automation_step_t automation_plan[AUTOMATION_PLAN_NB] PROGMEM = {
+
+	/* début  fin    axe               sens   duty  cible  quille */
+	{ 0,     196,   MOTOR_FLECHE,     FALSE, 200,  AUTOMATION_SANS_CIBLE, 1 },
+	{ 0,     2143,  MOTOR_CHARIOT,    FALSE, 200,  51,    1 },
+	{ 0,     1047,  MOTOR_GLISSIERE,  TRUE,  200,  AUTOMATION_SANS_CIBLE, 1 },
+	{ 3357,  6909,  MOTOR_FLECHE,     FALSE, 200,  60,    3 },
+	{ 7786,  9957,  MOTOR_FLECHE,     TRUE,  200,  75,    2 },
+	{ 7786,  12072, MOTOR_CHARIOT,    FALSE, 200,  251,   2 },
+	{ 12572, 16914, MOTOR_FLECHE,     FALSE, 200,  120,   4 },
+	{ 17528, 20093, MOTOR_FLECHE,     FALSE, 200,  180,   5 },
+	{ 17528, 21813, MOTOR_CHARIOT,    TRUE,  200,  149,   5 },
+	{ 22313, 24681, MOTOR_FLECHE,     FALSE, 200,  240,   6 },
+	{ 22313, 26599, MOTOR_CHARIOT,    FALSE, 200,  251,   6 },
+	{ 27098, 28677, MOTOR_FLECHE,     FALSE, 200,  285,   7 },
+	{ 27098, 31384, MOTOR_CHARIOT,    TRUE,  200,  149,   7 },
+	{ 27098, 28145, MOTOR_GLISSIERE,  FALSE, 200,  AUTOMATION_SANS_CIBLE, 7 },
+};
+
+#endif /* AUTOMATION_PLAN_H_INCLUDED */
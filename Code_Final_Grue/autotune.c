@@ -0,0 +1,458 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file autotune.c
+	\brief Réglage automatique de la boucle de position de la flèche (pid.h) par relais
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <util/atomic.h>
+#include "autotune.h"
+#include "automation.h"
+#include "kinematics.h"
+#include "motor.h"
+#include "pid.h"
+#include "timebase.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define SECTEURS			(360 / KINEMATICS_ENCODEUR_PAS)
+#define SECTEUR				(KINEMATICS_ENCODEUR_PAS * KINEMATICS_DEGRE)
+
+/* Demi-largeur de l'hystérésis: un demi-secteur, en 1/16 de degré */
+#define HYSTERESIS			(SECTEUR / 2)
+
+/* 4 / pi, 12 bits de fraction: Ku = 4.d / (pi.a) */
+#define QUATRE_SUR_PI		5215L
+
+/* Fronts notés par l'interruption, puissance de 2 */
+#define FRONTS_NB			8
+
+_Static_assert(AUTOTUNE_RELAIS_DUTY > KINEMATICS_FLECHE_SEUIL, "Le relais doit dépasser le seuil de frottement");
+_Static_assert((FRONTS_NB & (FRONTS_NB - 1)) == 0, "FRONTS_NB doit être une puissance de 2");
+
+typedef enum{
+
+	ARRET = 0,
+	RELAIS,
+	RETOUR,			/* la boucle ramène la flèche au milieu du centre */
+	ECHELON
+
+}etat_e;
+
+
+typedef struct{
+
+	uint32_t instant_ms;
+	uint8_t secteur;
+
+}front_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static volatile front_t fronts[FRONTS_NB];
+static volatile uint8_t fronts_tete = 0;
+static uint8_t fronts_lu = 0;
+
+static etat_e etat = ARRET;
+static autotune_rule_e regle;
+static uint32_t debut_ms;
+
+/* Relais */
+static uint8_t centre;
+static uint8_t secteur_prec;
+static uint32_t sortie_ms;			/* front de sortie du centre */
+static uint32_t haut_prec_ms;		/* sortie précédente par le haut */
+static uint8_t periodes;
+static uint32_t somme_periodes;
+static uint32_t somme_hors;
+static uint8_t nb_hors;
+
+/* Résultat */
+static uint16_t ku;
+static uint16_t tu;
+static pid_gains_t gains;
+
+/* Échelon */
+static uint16_t depart;
+static uint16_t but;
+static uint16_t montee_10;
+static uint16_t montee_90;
+static int16_t progres_max;			/* % de l'échelon */
+static uint16_t etablissement;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void relais(void);
+static void front(uint32_t instant_ms, uint8_t secteur);
+static bool calcul(void);
+static void echelon(void);
+static void fin(bool reussi);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void autotune_edge(uint8_t secteur){
+
+	uint8_t tete = fronts_tete;
+
+	fronts[tete].instant_ms = timebase_millis();
+	fronts[tete].secteur = secteur;
+	fronts_tete = (tete + 1) & (FRONTS_NB - 1);
+}
+
+
+void autotune_start(autotune_rule_e nouvelle){
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+
+	regle = nouvelle;
+	centre = position.angle / SECTEUR;
+	secteur_prec = centre;
+	periodes = 0;
+	somme_periodes = 0;
+	somme_hors = 0;
+	nb_hors = 0;
+	haut_prec_ms = 0;
+	fronts_lu = fronts_tete;
+	debut_ms = timebase_millis();
+	etat = RELAIS;
+
+	// Le relais commence vers le haut
+	motor_set(MOTOR_FLECHE, FALSE, AUTOTUNE_RELAIS_DUTY);
+}
+
+
+void autotune_stop(void){
+
+	if(etat == RELAIS){
+
+		motor_set_duty(MOTOR_FLECHE, 0);
+	}
+
+	else if(etat != ARRET){
+
+		pid_stop();
+	}
+
+	etat = ARRET;
+}
+
+
+void autotune_process(void){
+
+	switch(etat){
+	case RELAIS:
+
+		relais();
+		break;
+
+	case RETOUR:
+
+		if(!pid_is_active()){
+
+			// Échelon du milieu du centre, vers 0° s'il traverserait 345°
+			kinematics_polar_t position;
+
+			kinematics_get(&position);
+
+			depart = position.angle;
+			but = (depart + AUTOTUNE_ECHELON_DEG * KINEMATICS_DEGRE < 345 * KINEMATICS_DEGRE) ?
+				depart + AUTOTUNE_ECHELON_DEG * KINEMATICS_DEGRE : depart - AUTOTUNE_ECHELON_DEG * KINEMATICS_DEGRE;
+			montee_10 = 0;
+			montee_90 = 0;
+			progres_max = 0;
+			etablissement = 0;
+			debut_ms = timebase_millis();
+			etat = ECHELON;
+
+			pid_start(but);
+		}
+
+		break;
+
+	case ECHELON:
+
+		echelon();
+		break;
+
+	default:
+
+		break;
+	}
+}
+
+
+bool autotune_command(const char* ligne, uint8_t longueur){
+
+	char texte[48];
+
+	if((longueur < 3) || (ligne[0] != '?') || (ligne[1] != 'A')){
+
+		return FALSE;
+	}
+
+	if(longueur == 3){
+
+		pid_gains_t actuels;
+		bool regles = pid_get_gains(&actuels);
+
+		sprintf(texte, "pid kp=%u ti=%u td=%u regle=%u\n", actuels.kp, actuels.ti_ms, actuels.td_ms, regles);
+		uart_put_string(UART_0, texte);
+		return TRUE;
+	}
+
+	if((longueur != 4) || (ligne[2] < '0') || (ligne[2] >= '0' + AUTOTUNE_NB_REGLES)){
+
+		uart_put_string(UART_0, "autotune ?A<0..1>\n");
+		return TRUE;
+	}
+
+	if(!automation_release()){
+
+		uart_put_string(UART_0, "autotune mode auto\n");
+		return TRUE;
+	}
+
+	autotune_start(ligne[2] - '0');
+
+	sprintf(texte, "autotune relais centre=%u\n", centre * KINEMATICS_ENCODEUR_PAS);
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void relais(void){
+
+	// Fronts notés depuis le dernier passage
+	while(fronts_lu != fronts_tete){
+
+		front_t f;
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+			f.instant_ms = fronts[fronts_lu].instant_ms;
+			f.secteur = fronts[fronts_lu].secteur;
+		}
+
+		fronts_lu = (fronts_lu + 1) & (FRONTS_NB - 1);
+		front(f.instant_ms, f.secteur);
+
+		if(etat != RELAIS){
+
+			return;
+		}
+	}
+
+	if(timebase_elapsed_ms(debut_ms) > AUTOTUNE_RELAIS_MAX_MS){
+
+		fin(FALSE);
+	}
+}
+
+
+/* Un front pendant le relais: sortie du centre ou retour */
+static void front(uint32_t instant_ms, uint8_t secteur){
+
+	uint8_t haut = (centre + 1) % SECTEURS;
+	uint8_t bas = (centre + SECTEURS - 1) % SECTEURS;
+	bool mesure = (periodes >= AUTOTUNE_CYCLES_IGNORES);
+
+	if((secteur_prec == centre) && (secteur == haut)){
+
+		motor_set(MOTOR_FLECHE, TRUE, AUTOTUNE_RELAIS_DUTY);
+
+		// Période: d'une sortie par le haut à la suivante
+		if(haut_prec_ms != 0){
+
+			if(mesure){
+
+				somme_periodes += instant_ms - haut_prec_ms;
+			}
+
+			periodes++;
+		}
+
+		haut_prec_ms = instant_ms;
+		sortie_ms = instant_ms;
+	}
+
+	else if((secteur_prec == centre) && (secteur == bas)){
+
+		motor_set(MOTOR_FLECHE, FALSE, AUTOTUNE_RELAIS_DUTY);
+		sortie_ms = instant_ms;
+	}
+
+	else if((secteur == centre) && ((secteur_prec == haut) || (secteur_prec == bas)) && mesure){
+
+		somme_hors += instant_ms - sortie_ms;
+		nb_hors++;
+	}
+
+	secteur_prec = secteur;
+
+	if(periodes == AUTOTUNE_CYCLES_IGNORES + AUTOTUNE_CYCLES){
+
+		motor_set_duty(MOTOR_FLECHE, 0);
+
+		if(!calcul()){
+
+			fin(FALSE);
+			return;
+		}
+
+		pid_set_gains(&gains);
+
+		// Retour au milieu du centre avant l'échelon
+		etat = RETOUR;
+		pid_start(centre * SECTEUR + HYSTERESIS);
+	}
+}
+
+
+/* Ku et Tu de l'oscillation, puis les gains de la règle */
+static bool calcul(void){
+
+	if(nb_hors == 0){
+
+		return FALSE;
+	}
+
+	uint32_t hors = somme_hors / nb_hors;
+
+	tu = somme_periodes / AUTOTUNE_CYCLES;
+
+	// pi.hors / Tu doit rester sous 90°: sinon l'oscillation ne sort pas du centre
+	if((tu == 0) || (2 * hors >= tu)){
+
+		return FALSE;
+	}
+
+	int16_t c = kinematics_cos((uint32_t)180 * KINEMATICS_DEGRE * hors / tu);
+
+	if(c <= 0){
+
+		return FALSE;
+	}
+
+	uint32_t amplitude = (uint32_t)HYSTERESIS * 32768 / c;	/* 1/16 de degré */
+
+	// Ku en 1/256 de rapport cyclique par degré
+	uint32_t k = (uint32_t)(AUTOTUNE_RELAIS_DUTY - KINEMATICS_FLECHE_SEUIL) * QUATRE_SUR_PI *
+		KINEMATICS_DEGRE * 256 / 4096 / amplitude;
+
+	ku = (k > 0xFFFF) ? 0xFFFF : k;
+
+	if(regle == AUTOTUNE_TYREUS_LUYBEN){
+
+		gains.kp = (uint32_t)ku * 10 / 22;
+		gains.ti_ms = ((uint32_t)tu * 22 / 10 > 0xFFFF) ? 0xFFFF : (uint32_t)tu * 22 / 10;
+		gains.td_ms = (uint32_t)tu * 10 / 63;
+	}
+
+	else{
+
+		gains.kp = (uint32_t)ku * 6 / 10;
+		gains.ti_ms = tu / 2;
+		gains.td_ms = tu / 8;
+	}
+
+	return gains.kp != 0;
+}
+
+
+/* Réponse à l'échelon: montée, dépassement et établissement */
+static void echelon(void){
+
+	kinematics_polar_t position;
+	int32_t pas = (int32_t)but - depart;
+	uint16_t ecoule = timebase_elapsed_ms(debut_ms);
+
+	kinematics_get(&position);
+
+	int16_t progres = ((int32_t)position.angle - depart) * 100 / pas;
+	int16_t ecart = (progres > 100) ? progres - 100 : 100 - progres;
+
+	if((montee_10 == 0) && (progres >= 10)){
+
+		montee_10 = ecoule;
+	}
+
+	if((montee_90 == 0) && (progres >= 90)){
+
+		montee_90 = ecoule;
+	}
+
+	if(progres > progres_max){
+
+		progres_max = progres;
+	}
+
+	if(ecart > AUTOTUNE_BANDE_PCT){
+
+		etablissement = 0;
+	}
+
+	else if(etablissement == 0){
+
+		etablissement = ecoule;
+	}
+
+	if(!pid_is_active() || (ecoule > AUTOTUNE_ECHELON_MAX_MS)){
+
+		fin(TRUE);
+	}
+}
+
+
+static void fin(bool reussi){
+
+	char texte[112];	/* rapport: 106 octets au plus, \0 compris */
+
+	autotune_stop();
+
+	if(!reussi){
+
+		uart_put_string(UART_0, "autotune echec\n");
+		return;
+	}
+
+	snprintf(texte, sizeof(texte), "autotune ku=%u tu=%u kp=%u ti=%u td=%u montee=%u depassement=%u etablissement=%u\n",
+		ku, tu, gains.kp, gains.ti_ms, gains.td_ms, (montee_90 > montee_10) ? montee_90 - montee_10 : 0,
+		(progres_max > 100) ? progres_max - 100 : 0, etablissement);
+	uart_put_string(UART_0, texte);
+}
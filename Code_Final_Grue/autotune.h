@@ -0,0 +1,148 @@
+#ifndef AUTOTUNE_H_INCLUDED
+#define AUTOTUNE_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file autotune.h
+	\brief Réglage automatique de la boucle de position de la flèche (pid.h) par relais
+
+	Le réglage se fait en trois temps, en mode automatique:
+
+	1. Relais: la flèche est poussée à ±AUTOTUNE_RELAIS_DUTY selon le secteur de
+	   l'encodeur où elle se trouve au départ (le centre). Elle tourne vers le haut
+	   jusqu'au front qui sort du centre par le haut, puis vers le bas jusqu'au front
+	   qui en sort par le bas: elle oscille autour du centre avec une hystérésis d'un
+	   secteur (h = 7,5°). Les instants des fronts (INT0, autotune_edge()) donnent la
+	   période Tu et le temps passé hors du centre à chaque excursion, d'où l'amplitude
+	   de l'oscillation, supposée sinusoïdale:
+
+		a = h / cos(pi.hors / Tu)
+
+	   Les AUTOTUNE_CYCLES_IGNORES premières périodes (démarrage) ne sont pas mesurées.
+	   Le gain critique vient de l'approximation du premier harmonique, avec d la part du
+	   relais au-dessus du seuil de frottement:
+
+		Ku = 4.d / (pi.a)
+
+	2. Gains, selon la règle demandée, puis sauvés dans l'EEPROM:
+
+		                      Kp          Ti          Td
+		Ziegler-Nichols       0,6.Ku      Tu/2        Tu/8
+		Tyreus-Luyben         Ku/2,2      2,2.Tu      Tu/6,3
+
+	   Tyreus-Luyben dépasse moins et convient mieux à la charge qui balance.
+
+	3. Échelon: la boucle ramène la flèche au milieu du centre, puis la tourne de
+	   AUTOTUNE_ECHELON_DEG (vers 0° si l'échelon traverserait 345°). La position estimée
+	   donne le temps de montée (10 à 90 %), le dépassement et le temps d'établissement
+	   (dernière entrée dans ±AUTOTUNE_BANDE_PCT de l'échelon).
+
+	La commande ?A reçue sur UART_0 renvoie les gains de la boucle:
+
+		pid kp=<1/256 de rapport cyclique par degré> ti=<ms> td=<ms> regle=<1 si réglés>
+
+	et ?A<autotune_rule_e> commence le réglage (mode automatique seulement, le reste du
+	plan est abandonné). La fin du réglage envoie:
+
+		autotune ku=<1/256 par degré> tu=<ms> kp=.. ti=.. td=.. montee=<ms>
+		depassement=<%> etablissement=<ms, 0 si pas établie>
+
+	ou autotune echec (oscillation absente ou trop faible, temps dépassé). La sortie du
+	mode automatique arrête le réglage.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+typedef enum{
+
+	AUTOTUNE_ZIEGLER_NICHOLS = 0,
+	AUTOTUNE_TYREUS_LUYBEN,
+
+	AUTOTUNE_NB_REGLES
+
+}autotune_rule_e;
+
+/* Rapport cyclique du relais */
+#define AUTOTUNE_RELAIS_DUTY		120
+
+/* Périodes du relais ignorées puis mesurées, et durée la plus longue du relais en ms */
+#define AUTOTUNE_CYCLES_IGNORES		1
+#define AUTOTUNE_CYCLES				4
+#define AUTOTUNE_RELAIS_MAX_MS		40000
+
+/* Échelon de la réponse mesurée, bande d'établissement et durée la plus longue en ms */
+#define AUTOTUNE_ECHELON_DEG		45
+#define AUTOTUNE_BANDE_PCT			5
+#define AUTOTUNE_ECHELON_MAX_MS		15000
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Note un front de l'encodeur de la flèche
+	\param[in]	secteur Le secteur de l'encodeur après le front (clics)
+    \return rien.
+
+	Appelée par l'interruption INT0.
+*/
+void autotune_edge(uint8_t secteur);
+
+/**
+    \brief Commence le réglage à la position actuelle de la flèche
+	\param[in]	regle La règle de calcul des gains
+    \return rien.
+
+	La flèche doit être arrêtée et libre (automation_release()).
+*/
+void autotune_start(autotune_rule_e regle);
+
+/**
+    \brief Arrête le réglage et la flèche, sans changer les gains
+    \return rien.
+*/
+void autotune_stop(void);
+
+/**
+    \brief Avance le réglage
+    \return rien.
+
+	À appeler à chaque passage de la boucle principale en mode automatique, après
+	automation_process().
+*/
+void autotune_process(void);
+
+/**
+    \brief Traite la commande ?A
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool autotune_command(const char* ligne, uint8_t longueur);
+
+#endif /* AUTOTUNE_H_INCLUDED */
@@ -0,0 +1,305 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file battery.c
+	\brief Surveillance de la tension de la batterie des moteurs
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/io.h>
+#include "battery.h"
+#include "driver.h"
+#include "motor.h"
+#include "uart.h"
+#include "soft_timer.h"
+#include "blackbox.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define CONFIRMATION_MESURES	(BATTERY_CONFIRMATION_MS / BATTERY_PERIODE_MS)
+
+_Static_assert((BOARD_ADC_PINS & (1 << BATTERY_CHANNEL)) != 0,
+	"BATTERY_CHANNEL doit faire partie de BOARD_ADC_PINS (board_config.h)");
+
+_Static_assert(BATTERY_VIDE_MV + BATTERY_HYSTERESIS_MV < BATTERY_FAIBLE_MV,
+	"Les seuils FAIBLE et VIDE se chevauchent");
+
+_Static_assert(CONFIRMATION_MESURES <= 255, "BATTERY_CONFIRMATION_MS est trop long");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* Plafond du rapport cyclique de chaque axe en FAIBLE (ordre de motor_e) */
+static const uint8_t faible_limit[MOTOR_NB] = {
+
+	/* MOTOR_FLECHE */		180,
+	/* MOTOR_CHARIOT */		200,
+	/* MOTOR_GLISSIERE */	160,
+};
+
+static uint16_t filtre = 0;			/* mesure filtrée, 8 bits de fraction */
+static uint16_t tension_mv = 0;
+static trame_batterie_e etat = TRAME_BATTERIE_OK;
+static uint8_t confirmation = 0;	/* mesures consécutives au-delà d'un seuil */
+static uint16_t gain = MOTOR_GAIN_ONE;
+
+static soft_timer_t mesure_timer;
+#if !BOARD_UART_BUS
+static soft_timer_t telemetrie_timer;
+#endif
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void mesure_cb(void* arg);
+#if !BOARD_UART_BUS
+static void telemetrie_cb(void* arg);
+#endif
+static trame_batterie_e next_state(void);
+static void apply_state(void);
+static void apply_gain(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void battery_init(void){
+
+	filtre = (uint16_t)adc_read(BATTERY_CHANNEL) << 8;
+	tension_mv = ((uint32_t)filtre * BATTERY_FULL_SCALE_MV) >> 16;
+
+	// Une batterie déjà faible au démarrage est limitée tout de suite
+	etat = TRAME_BATTERIE_OK;
+
+	if(tension_mv < BATTERY_VIDE_MV){
+
+		etat = TRAME_BATTERIE_VIDE;
+	}
+
+	else if(tension_mv < BATTERY_FAIBLE_MV){
+
+		etat = TRAME_BATTERIE_FAIBLE;
+	}
+
+	apply_state();
+	apply_gain();
+
+	soft_timer_init(&mesure_timer, mesure_cb, NULL);
+	soft_timer_start(&mesure_timer, BATTERY_PERIODE_MS, BATTERY_PERIODE_MS);
+
+	// Sur un bus, la grue ne répond qu'aux trames qui lui sont adressées (voir bus.h)
+#if !BOARD_UART_BUS
+	soft_timer_init(&telemetrie_timer, telemetrie_cb, NULL);
+	soft_timer_start(&telemetrie_timer, TRAME_BATT_PERIODE_MS, TRAME_BATT_PERIODE_MS);
+#endif
+}
+
+
+uint16_t battery_get_mv(void){
+
+	return tension_mv;
+}
+
+
+trame_batterie_e battery_get_state(void){
+
+	return etat;
+}
+
+
+void battery_format(char* texte){
+
+	sprintf(texte, "%2u.%u%c", tension_mv / 1000, (tension_mv % 1000) / 100, TRAME_BATT_SYMBOLE(etat));
+}
+
+
+void battery_send_telemetry(uint8_t adresse){
+
+	uint16_t mv = (tension_mv > TRAME_BATT_MV_MAX) ? TRAME_BATT_MV_MAX : tension_mv;
+
+	uart_put_byte(UART_0, TRAME_BATT_DEBUT);
+	uart_put_byte(UART_0, TRAME_CODE_7(etat));
+	uart_put_byte(UART_0, TRAME_CODE_7(mv));
+	uart_put_byte(UART_0, TRAME_CODE_7(mv >> 7));
+
+	if(adresse != UART_BROADCAST){
+
+		uart_put_byte(UART_0, TRAME_CODE_7(adresse));
+	}
+
+	uart_put_byte(UART_0, '\n');
+}
+
+
+bool battery_command(const char* ligne, uint8_t longueur){
+
+	char texte[40];
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'V')){
+
+		return FALSE;
+	}
+
+	sprintf(texte, "batterie=%u etat=%u gain=%u\n", tension_mv, etat, gain);
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Une mesure, à toutes les BATTERY_PERIODE_MS */
+static void mesure_cb(void* arg){
+
+	int32_t mesure = (int32_t)adc_read(BATTERY_CHANNEL) << 8;
+
+	filtre += (mesure - (int32_t)filtre) >> BATTERY_FILTRE_DECALAGE;
+	tension_mv = ((uint32_t)filtre * BATTERY_FULL_SCALE_MV) >> 16;
+
+	trame_batterie_e suivant = next_state();
+
+	if(suivant == etat){
+
+		confirmation = 0;
+	}
+
+	else if(++confirmation >= CONFIRMATION_MESURES){
+
+		confirmation = 0;
+		etat = suivant;
+		apply_state();
+		blackbox_log(BLACKBOX_EVENT_BATTERY, etat);
+	}
+
+	apply_gain();
+}
+
+
+#if !BOARD_UART_BUS
+/* Trame de télémétrie vers la manette, à toutes les TRAME_BATT_PERIODE_MS */
+static void telemetrie_cb(void* arg){
+
+	battery_send_telemetry(UART_BROADCAST);
+}
+#endif
+
+
+/* État vers lequel la tension filtrée pousse, sans la confirmation */
+static trame_batterie_e next_state(void){
+
+	switch(etat){
+	case TRAME_BATTERIE_OK:
+
+		if(tension_mv < BATTERY_FAIBLE_MV){
+
+			return TRAME_BATTERIE_FAIBLE;
+		}
+		break;
+
+	case TRAME_BATTERIE_FAIBLE:
+
+		if(tension_mv < BATTERY_VIDE_MV){
+
+			return TRAME_BATTERIE_VIDE;
+		}
+
+		if(tension_mv > BATTERY_FAIBLE_MV + BATTERY_HYSTERESIS_MV){
+
+			return TRAME_BATTERIE_OK;
+		}
+		break;
+
+	default:
+
+		if(tension_mv > BATTERY_FAIBLE_MV + BATTERY_HYSTERESIS_MV){
+
+			return TRAME_BATTERIE_OK;
+		}
+		break;
+	}
+
+	return etat;
+}
+
+
+/* Limites des moteurs selon l'état */
+static void apply_state(void){
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		switch(etat){
+		case TRAME_BATTERIE_OK:
+
+			motor_set_limit(i, 255);
+			break;
+
+		case TRAME_BATTERIE_FAIBLE:
+
+			motor_set_limit(i, faible_limit[i]);
+			break;
+
+		default:
+
+			motor_set_limit(i, 0);
+			break;
+		}
+	}
+}
+
+
+/* Compensation de la tension, changée seulement au-delà de BATTERY_GAIN_PAS */
+static void apply_gain(void){
+
+	uint32_t nouveau = BATTERY_GAIN_MAX;
+
+	if(tension_mv > 0){
+
+		nouveau = ((uint32_t)BATTERY_NOMINAL_MV * MOTOR_GAIN_ONE) / tension_mv;
+	}
+
+	if(nouveau > BATTERY_GAIN_MAX){
+
+		nouveau = BATTERY_GAIN_MAX;
+	}
+
+	else if(nouveau < BATTERY_GAIN_MIN){
+
+		nouveau = BATTERY_GAIN_MIN;
+	}
+
+	if((nouveau + BATTERY_GAIN_PAS <= gain) || (nouveau >= gain + BATTERY_GAIN_PAS) ||
+		(nouveau == BATTERY_GAIN_MIN) || (nouveau == BATTERY_GAIN_MAX)){
+
+		if(nouveau != gain){
+
+			gain = nouveau;
+			motor_set_gain(gain);
+		}
+	}
+}
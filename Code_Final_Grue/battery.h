@@ -0,0 +1,154 @@
+#ifndef BATTERY_H_INCLUDED
+#define BATTERY_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file battery.h
+	\brief Surveillance de la tension de la batterie des moteurs
+
+	La batterie est mesurée par un diviseur de tension sur l'entrée BATTERY_CHANNEL de
+	l'ADC (PA4, broche 36):
+
+		batterie --[ BATTERY_R_HAUT ]--+--[ BATTERY_R_BAS ]-- GND
+		                               |
+		                              PA4
+
+	Une mesure est faite à toutes les BATTERY_PERIODE_MS (minuterie logicielle, dans le
+	programme principal) et filtrée par un filtre passe-bas du premier ordre:
+
+		filtre += (mesure - filtre) / 2^BATTERY_FILTRE_DECALAGE
+
+	soit une constante de temps d'environ 160 ms, assez pour ignorer le creux du
+	démarrage d'un moteur.
+
+	La tension filtrée règle les moteurs (voir motor.h):
+
+	- compensation: le gain des moteurs est BATTERY_NOMINAL_MV / tension, borné entre
+	  BATTERY_GAIN_MIN et BATTERY_GAIN_MAX. Un même rapport cyclique donne donc la même
+	  tension moyenne au moteur, et la même vitesse, du début à la fin de la décharge;
+	- état de la batterie, avec hystérésis. Un changement d'état demande que la tension
+	  reste de l'autre côté du seuil pendant BATTERY_CONFIRMATION_MS:
+
+		OK --(< FAIBLE_MV)--> FAIBLE --(< VIDE_MV)--> VIDE
+		OK <--(> FAIBLE_MV + HYSTERESIS)-- FAIBLE
+		OK <--(> FAIBLE_MV + HYSTERESIS)-------------- VIDE
+
+	  En FAIBLE, le rapport cyclique de chaque axe est plafonné (limite de battery.c) pour
+	  réduire le courant. En VIDE, tous les moteurs sont arrêtés (limite 0). Sans charge,
+	  la tension d'une batterie vide remonte: l'état VIDE n'est donc quitté que pour une
+	  batterie rechargée ou remplacée.
+
+	Chaque changement d'état est noté dans la boîte noire (BLACKBOX_EVENT_BATTERY).
+	L'état et la tension sont envoyés à la manette par la trame de télémétrie (trame.h)
+	à toutes les TRAME_BATT_PERIODE_MS; sur un bus de plusieurs grues, seulement en
+	réponse à une trame de la manette (voir bus.h). La commande ?V reçue sur UART_0 renvoie:
+
+		batterie=<mV> etat=<trame_batterie_e> gain=<gain des moteurs, 256 = 1>
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "trame.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define BATTERY_CHANNEL			PA4
+
+/* Diviseur de tension (ohms) et référence de l'ADC (AVCC) */
+#define BATTERY_R_HAUT			10000
+#define BATTERY_R_BAS			3300
+#define BATTERY_VREF_MV			5000
+
+/* Tension à la pleine échelle de l'ADC: 20,2 V */
+#define BATTERY_FULL_SCALE_MV	((uint32_t)BATTERY_VREF_MV * (BATTERY_R_HAUT + BATTERY_R_BAS) / BATTERY_R_BAS)
+
+#define BATTERY_PERIODE_MS		20
+#define BATTERY_FILTRE_DECALAGE	3
+
+/**
+    \brief Seuils de la batterie de 12 V (10 éléments NiMH), en mV
+*/
+#define BATTERY_NOMINAL_MV		12000
+#define BATTERY_FAIBLE_MV		11000
+#define BATTERY_VIDE_MV			10000
+#define BATTERY_HYSTERESIS_MV	400
+
+#define BATTERY_CONFIRMATION_MS	1000
+
+/* Bornes du gain de compensation (MOTOR_GAIN_ONE = 256) */
+#define BATTERY_GAIN_MIN		205		/* 0,8 */
+#define BATTERY_GAIN_MAX		333		/* 1,3 */
+
+/* Écart de gain minimal avant de changer les moteurs, pour ne pas suivre le bruit */
+#define BATTERY_GAIN_PAS		3
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Fait une première mesure et démarre la surveillance
+    \return rien.
+
+	À appeler après adc_init(), motor_init() et pwm1_init(), les interruptions
+	actives. Le filtre part de la première mesure.
+*/
+void battery_init(void);
+
+/**
+    \brief Retourne la tension filtrée de la batterie
+    \return la tension en mV
+*/
+uint16_t battery_get_mv(void);
+
+/**
+    \brief Retourne l'état de la batterie
+    \return TRAME_BATTERIE_OK, TRAME_BATTERIE_FAIBLE ou TRAME_BATTERIE_VIDE
+*/
+trame_batterie_e battery_get_state(void);
+
+/**
+    \brief Écrit la tension et l'état pour l'afficheur, exe.: "12.1V" (5 caractères)
+	\param[out]	texte Au moins 6 octets
+    \return rien.
+*/
+void battery_format(char* texte);
+
+/**
+    \brief Envoie la trame de télémétrie sur UART_0 (voir trame.h)
+	\param[in]	adresse L'adresse de la grue sur le bus, UART_BROADCAST sans bus
+    \return rien.
+*/
+void battery_send_telemetry(uint8_t adresse);
+
+/**
+    \brief Traite la commande ?V
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool battery_command(const char* ligne, uint8_t longueur);
+
+#endif /* BATTERY_H_INCLUDED */
@@ -0,0 +1,320 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file blackbox.c
+	\brief Boîte noire: derniers événements de la grue, gardés après une panne
+
+	Contenu de l'EEPROM à EEPROM_BLACKBOX_ADDR:
+
+		magic(1) reset(1) nombre(1) réservé(1)
+		temps(2) type(1) valeur(1)		une fois par événement, du plus ancien au plus récent
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+#include "blackbox.h"
+#include "eeprom_map.h"
+#include "timebase.h"
+#include "soft_timer.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define RAM_MAGIC			0xB10C
+#define EEPROM_MAGIC		0xBB
+
+#define RING_MASK			(BLACKBOX_NB_EVENTS - 1)
+
+/* Copie dans l'EEPROM: une échéance par ms, au plus FLUSH_OCTETS octets vérifiés par
+échéance et une seule écriture (3,4 ms) à la fois */
+#define FLUSH_PERIOD_MS		1
+#define FLUSH_OCTETS		8
+
+/* Période d'envoi d'une ligne du contenu (une ligne dure au plus 17 ms à 9600 bauds) */
+#define DUMP_PERIOD_MS		20
+
+typedef struct{
+
+	uint16_t time;
+	uint8_t event;
+	uint8_t value;
+
+}blackbox_entry_t;
+
+
+typedef struct{
+
+	uint8_t magic;
+	uint8_t reset;
+	uint8_t count;
+	uint8_t reserved;
+
+}blackbox_header_t;
+
+_Static_assert((BLACKBOX_NB_EVENTS & RING_MASK) == 0, "BLACKBOX_NB_EVENTS doit être une puissance de 2");
+_Static_assert(BLACKBOX_NB_EVENTS <= 255, "Le nombre d'événements doit tenir sur 8 bits");
+_Static_assert(sizeof(blackbox_header_t) + BLACKBOX_NB_EVENTS * sizeof(blackbox_entry_t) <= EEPROM_BLACKBOX_TAILLE,
+	"La boîte noire dépasse sa zone de l'EEPROM");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* Gardés d'un reset à l'autre: ni initialisés, ni remis à 0 au démarrage */
+static volatile blackbox_entry_t ring[BLACKBOX_NB_EVENTS] __attribute__((section(".noinit")));
+static volatile uint8_t head __attribute__((section(".noinit")));
+static volatile uint8_t count __attribute__((section(".noinit")));
+static volatile uint16_t magic __attribute__((section(".noinit")));
+static uint8_t mcusr_copy __attribute__((section(".noinit")));
+
+/* Faux jusqu'à blackbox_init() et pendant la copie dans l'EEPROM: les événements d'avant
+(arrêt des moteurs au démarrage) remplaceraient ceux de la panne */
+static volatile bool pret = FALSE;
+
+static soft_timer_t flush_timer;
+static uint16_t flush_index;
+static uint16_t flush_fin;
+
+static soft_timer_t dump_timer;
+static uart_e dump_port;
+static int16_t dump_index;
+static uint8_t dump_count;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void save_reset_cause(void) __attribute__((naked, used, section(".init3")));
+static void flush_cb(void* arg);
+static void flush_octet(uint16_t index, uint16_t* addr, uint8_t* octet);
+static void dump_cb(void* arg);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void blackbox_init(void){
+
+	bool valid = (magic == RAM_MAGIC) && (head <= RING_MASK) && (count <= BLACKBOX_NB_EVENTS);
+
+	soft_timer_init(&dump_timer, dump_cb, NULL);
+	soft_timer_init(&flush_timer, flush_cb, NULL);
+
+	// Après une mise sous tension, la RAM ne contient rien d'utile
+	if((valid == FALSE) || (mcusr_copy & (1 << PORF))){
+
+		head = 0;
+		count = 0;
+		magic = RAM_MAGIC;
+	}
+
+	// Le tampon reste figé pendant la copie: pret passe à TRUE à la fin (flush_cb())
+	else if(mcusr_copy & ((1 << WDRF) | (1 << BORF))){
+
+		flush_index = 0;
+		flush_fin = 1 + count * sizeof(blackbox_entry_t) + sizeof(blackbox_header_t);
+		soft_timer_start(&flush_timer, 0, FLUSH_PERIOD_MS);
+		return;
+	}
+
+	pret = TRUE;
+
+	blackbox_log(BLACKBOX_EVENT_RESET, mcusr_copy);
+}
+
+
+void blackbox_log(blackbox_event_e event, uint8_t value){
+
+	if(!pret){
+
+		return;
+	}
+
+	uint16_t now = timebase_millis();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		uint8_t i = head;
+
+		ring[i].time = now;
+		ring[i].event = event;
+		ring[i].value = value;
+
+		head = (i + 1) & RING_MASK;
+
+		if(count < BLACKBOX_NB_EVENTS){
+
+			count++;
+		}
+	}
+}
+
+
+bool blackbox_command(const char* ligne, uint8_t longueur){
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'B')){
+
+		return FALSE;
+	}
+
+	blackbox_dump(UART_0);
+
+	return TRUE;
+}
+
+
+void blackbox_dump(uart_e port){
+
+	dump_port = port;
+	dump_index = -1;
+	soft_timer_start(&dump_timer, 0, DUMP_PERIOD_MS);
+}
+
+
+uint8_t blackbox_reset_cause(void){
+
+	return mcusr_copy;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/*
+	Exécutée avant main(), avant même l'initialisation des variables. Après un reset du
+	chien de garde, celui-ci reste actif (WDRF à 1) avec le plus court délai: il faut le
+	couper tout de suite, sinon le programme redémarre en boucle.
+*/
+static void save_reset_cause(void){
+
+	mcusr_copy = MCUSR;
+	MCUSR = 0;
+	wdt_disable();
+}
+
+
+/*
+	Copie le tampon dans l'EEPROM, quelques octets à la fois: l'en-tête est d'abord
+	invalidé, puis les événements sont écrits du plus ancien au plus récent et l'en-tête
+	en dernier, magic à la fin. Une copie interrompue (nouvelle panne) laisse un en-tête
+	invalide, et le tampon, figé, est copié de nouveau au démarrage suivant.
+*/
+static void flush_cb(void* arg){
+
+	for(uint8_t i = 0; (i < FLUSH_OCTETS) && eeprom_is_ready(); i++){
+
+		if(flush_index == flush_fin){
+
+			soft_timer_stop(&flush_timer);
+			pret = TRUE;
+			blackbox_log(BLACKBOX_EVENT_RESET, mcusr_copy);
+			return;
+		}
+
+		uint16_t addr;
+		uint8_t octet;
+
+		flush_octet(flush_index++, &addr, &octet);
+
+		// Comme eeprom_update_byte(), sans attendre la fin de l'écriture
+		if(eeprom_read_byte((const uint8_t*)addr) != octet){
+
+			eeprom_write_byte((uint8_t*)addr, octet);
+		}
+	}
+}
+
+
+/* Adresse et valeur de l'octet numéro index de la copie (voir flush_cb()) */
+static void flush_octet(uint16_t index, uint16_t* addr, uint8_t* octet){
+
+	uint16_t taille = count * sizeof(blackbox_entry_t);
+
+	if(index == 0){
+
+		*addr = EEPROM_BLACKBOX_ADDR;
+		*octet = (uint8_t)~EEPROM_MAGIC;
+	}
+
+	else if(index <= taille){
+
+		uint16_t i = index - 1;
+		uint8_t entry = (head - count + i / sizeof(blackbox_entry_t)) & RING_MASK;
+
+		*addr = EEPROM_BLACKBOX_ADDR + sizeof(blackbox_header_t) + i;
+		*octet = ((const volatile uint8_t*)&ring[entry])[i % sizeof(blackbox_entry_t)];
+	}
+
+	else{
+
+		blackbox_header_t header = {EEPROM_MAGIC, mcusr_copy, count, 0};
+		uint8_t i = flush_fin - 1 - index;		// du dernier octet de l'en-tête au premier
+
+		*addr = EEPROM_BLACKBOX_ADDR + i;
+		*octet = ((const uint8_t*)&header)[i];
+	}
+}
+
+
+static void dump_cb(void* arg){
+
+	char ligne[24];
+
+	if(dump_index < 0){
+
+		blackbox_header_t header;
+
+		eeprom_read_block(&header, (const void*)EEPROM_BLACKBOX_ADDR, sizeof(header));
+
+		if((header.magic != EEPROM_MAGIC) || (header.count > BLACKBOX_NB_EVENTS)){
+
+			header.reset = 0;
+			header.count = 0;
+		}
+
+		dump_count = header.count;
+		sprintf(ligne, "bb reset=%u n=%u\n", header.reset, header.count);
+	}
+
+	else if(dump_index < dump_count){
+
+		blackbox_entry_t entry;
+		uint16_t addr = EEPROM_BLACKBOX_ADDR + sizeof(blackbox_header_t) + dump_index * sizeof(entry);
+
+		eeprom_read_block(&entry, (const void*)addr, sizeof(entry));
+		sprintf(ligne, "%u %u %u\n", entry.time, entry.event, entry.value);
+	}
+
+	else{
+
+		soft_timer_stop(&dump_timer);
+		return;
+	}
+
+	uart_put_string(dump_port, ligne);
+	dump_index++;
+}
@@ -0,0 +1,132 @@
+#ifndef BLACKBOX_H_INCLUDED
+#define BLACKBOX_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file blackbox.h
+	\brief Boîte noire: derniers événements de la grue, gardés après une panne
+
+	Les événements sont écrits dans un tampon circulaire de BLACKBOX_NB_EVENTS entrées
+	de 4 octets (temps, type, valeur), placé dans la section .noinit: le démarrage ne
+	l'efface pas et son contenu survit à un reset du chien de garde, d'une baisse de
+	tension (BOD) ou de la broche RESET. Après une mise sous tension, il est vidé.
+
+	Au démarrage qui suit un reset du chien de garde ou du BOD, blackbox_init() lance la
+	copie du tampon dans l'EEPROM (EEPROM_BLACKBOX_ADDR). La copie se fait en arrière-plan,
+	par une minuterie logicielle, sans retarder les commandes: elle prend près d'une
+	seconde si tout le contenu a changé, et les événements de ce temps ne sont pas notés.
+	Le BOD doit être activé par les fusibles (BODLEVEL) pour que les baisses de tension
+	soient vues.
+
+	Le temps est celui de timebase_millis() sur 16 bits: il revient à 0 toutes les
+	65,5 s. Les événements étant dans l'ordre, le lecteur n'a qu'à ajouter 65536 à
+	chaque recul.
+
+	La commande ?B reçue sur UART_0 renvoie le contenu de l'EEPROM, une ligne par
+	événement, du plus ancien au plus récent:
+
+		bb reset=<MCUSR> n=<nombre>
+		<temps> <type> <valeur>
+
+	blackbox_log() peut être appelée du programme principal ou d'une interruption et
+	coûte quelques dizaines de cycles.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Nombre d'événements gardés (puissance de 2)
+*/
+#define BLACKBOX_NB_EVENTS		64
+
+typedef enum{
+
+	BLACKBOX_EVENT_RESET = 0,		/* démarrage, valeur: MCUSR */
+	BLACKBOX_EVENT_FRAME,			/* trame reçue, valeur: numéro (0xFF sans numéro) */
+	BLACKBOX_EVENT_MODE,			/* changement de mode, valeur: a */
+	BLACKBOX_EVENT_LIMIT,			/* changement des fins de course, valeur: l1 | l2 << 1 */
+	BLACKBOX_EVENT_STEP,			/* étape de l'automation, valeur: quille (0 = aucune, 7 = point final) */
+	BLACKBOX_EVENT_TIME_OVER,		/* début du TIME OVER, valeur: secondes écoulées */
+	BLACKBOX_EVENT_PWM_FLECHE,		/* sortie d'un moteur (ordre de motor_e), valeur: rapport cyclique */
+	BLACKBOX_EVENT_PWM_CHARIOT,
+	BLACKBOX_EVENT_PWM_GLISSIERE,
+	BLACKBOX_EVENT_DIR,				/* sens d'un moteur, valeur: moteur << 1 | sens */
+	BLACKBOX_EVENT_BATTERY,			/* changement d'état de la batterie, valeur: trame_batterie_e */
+	BLACKBOX_EVENT_HOMING,			/* fin de la recherche du zéro, valeur: 0 réussie, 1 + motor_e de l'axe en échec */
+	BLACKBOX_EVENT_NB
+
+}blackbox_event_e;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Vérifie le tampon gardé et lance sa copie dans l'EEPROM après une panne
+    \return rien.
+
+	À appeler au début de main(), après l'arrêt des moteurs (motor_init()) et la
+	réception des commandes (uart_init()). Les événements d'avant ne sont pas notés. Note
+	aussi un événement BLACKBOX_EVENT_RESET, après la copie s'il y en a une.
+*/
+void blackbox_init(void);
+
+/**
+    \brief Ajoute un événement au tampon
+	\param[in]	event Le type d'événement
+	\param[in]	value La valeur associée
+    \return rien.
+*/
+void blackbox_log(blackbox_event_e event, uint8_t value);
+
+/**
+    \brief Traite la commande ?B
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool blackbox_command(const char* ligne, uint8_t longueur);
+
+/**
+    \brief Commence l'envoi du contenu de l'EEPROM
+	\param[in]	port Le port où écrire
+    \return rien.
+
+	L'envoi se fait une ligne à la fois par une minuterie logicielle, sans bloquer la
+	boucle principale.
+*/
+void blackbox_dump(uart_e port);
+
+/**
+    \brief Cause du dernier reset
+    \return MCUSR lu au démarrage
+*/
+uint8_t blackbox_reset_cause(void);
+
+#endif /* BLACKBOX_H_INCLUDED */
@@ -0,0 +1,82 @@
+#ifndef BOARD_CONFIG_H_INCLUDED
+#define BOARD_CONFIG_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file board_config.h
+	\brief Configuration des pilotes communs (Code_Commun) pour la grue
+
+	Voir Code_Commun/board.h pour la liste des choix.
+*/
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Pilotes */
+#define BOARD_HAS_PWM0			1	/* flèche (PB3) et chariot (PB4), voir motor.h */
+#define BOARD_HAS_PWM2			1	/* glissière (PD6) */
+
+/* Options des pilotes */
+#define BOARD_HAS_PROFILE		1	/* zones actives seulement avec le symbole PROFILE */
+#define BOARD_UART_EOL_TIME		1	/* latence des trames, voir latency.h */
+#define BOARD_ADC_NOISE_REDUCTION	0	/* base de temps exacte pour latency.h */
+
+/* Bus de plusieurs grues sur UART_0 (voir bus.h): liaison filaire seulement, le XBee
+   transparent ne transmet pas le 9e bit. Se change à la compilation: -DBOARD_UART_BUS=1 */
+#ifndef BOARD_UART_BUS
+#define BOARD_UART_BUS			0
+#endif
+
+/* Brochage: PA4 mesure la batterie des moteurs (voir battery.h), PA2 lit le repère de la flèche (homing.h) */
+#define BOARD_ADC_PINS			((1 << PA0) | (1 << PA1) | (1 << PA2) | (1 << PA4))
+
+#define BOARD_LCD_DATA_PORT		PORTC
+#define BOARD_LCD_DATA_DDR		DDRC
+#define BOARD_LCD_CTRL_PORT		PORTA
+#define BOARD_LCD_CTRL_DDR		DDRA
+#define BOARD_LCD_E_PIN			PA7
+#define BOARD_LCD_RW_PIN		PA6
+#define BOARD_LCD_RS_PIN		PA5
+
+/*
+	Taille des tampons de chaque port et de chaque sens: une puissance de 2 jusqu'à 128,
+	ou 0 pour retirer ce sens (voir uart.h). Chaque taille peut être redéfinie à la
+	compilation, exe.: -DUART_1_TX_BUFFER_SIZE=32.
+*/
+#ifndef UART_0_RX_BUFFER_SIZE
+#define UART_0_RX_BUFFER_SIZE	64	/* trames de la manette et commandes ?x */
+#endif
+#ifndef UART_0_TX_BUFFER_SIZE
+#define UART_0_TX_BUFFER_SIZE	128	/* rapports des commandes ?x */
+#endif
+
+#ifndef UART_1_RX_BUFFER_SIZE
+#define UART_1_RX_BUFFER_SIZE	0	/* inutilisé: RXD1 est l'entrée INT0 de l'encodeur */
+#endif
+#ifndef UART_1_TX_BUFFER_SIZE
+#if defined(PROFILE) && defined(PROFILE_UART_1_FORCE)
+#define UART_1_TX_BUFFER_SIZE	32	/* envoi du profilage forcé sur UART_1 (profile.h) */
+#else
+#define UART_1_TX_BUFFER_SIZE	0
+#endif
+#endif
+
+#endif /* BOARD_CONFIG_H_INCLUDED */
@@ -0,0 +1,118 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file boot.c
+	\brief Temps de démarrage de la grue
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <util/atomic.h>
+#include "boot.h"
+#include "timebase.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+_Static_assert(BOOT_NB == 4, "Le rapport de ?D nomme chaque étape du démarrage");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static volatile uint32_t instants[BOOT_NB] = {BOOT_JAMAIS, BOOT_JAMAIS, BOOT_JAMAIS, BOOT_JAMAIS};
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static char* format(char* texte, const char* nom, boot_step_e etape);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void boot_mark(boot_step_e etape){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		if(instants[etape] == BOOT_JAMAIS){
+
+			instants[etape] = timebase_micros();
+		}
+	}
+}
+
+
+uint32_t boot_get_us(boot_step_e etape){
+
+	uint32_t instant;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		instant = instants[etape];
+	}
+
+	return instant;
+}
+
+
+bool boot_command(const char* ligne, uint8_t longueur){
+
+	char texte[64];
+	char* fin = texte;
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'D')){
+
+		return FALSE;
+	}
+
+	fin += sprintf(fin, "boot");
+	fin = format(fin, "uart", BOOT_UART);
+	fin = format(fin, "commande", BOOT_COMMANDE);
+	fin = format(fin, "mli", BOOT_MLI);
+	fin = format(fin, "lcd", BOOT_LCD);
+	sprintf(fin, "\n");
+
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Ajoute " nom=<µs>" (ou " nom=-") au rapport, retourne la nouvelle fin du texte */
+static char* format(char* texte, const char* nom, boot_step_e etape){
+
+	uint32_t instant = boot_get_us(etape);
+
+	if(instant == BOOT_JAMAIS){
+
+		return texte + sprintf(texte, " %s=-", nom);
+	}
+
+	return texte + sprintf(texte, " %s=%lu", nom, (unsigned long)instant);
+}
@@ -0,0 +1,100 @@
+#ifndef BOOT_H_INCLUDED
+#define BOOT_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file boot.h
+	\brief Temps de démarrage de la grue
+
+	Au démarrage, main() met d'abord les moteurs à l'arrêt (motor_init()), lance la
+	base de temps puis la réception des commandes (uart_init()). Le LCD s'initialise
+	ensuite en arrière-plan (lcd_begin(), lcd_process()): il ne retarde plus ni les
+	commandes, ni les moteurs.
+
+	Chaque étape est notée une fois, en µs depuis le lancement de la base de temps
+	(pwm1_init(), au début de main(): les quelques µs d'avant ne sont pas comptées):
+
+		Étape            Instant
+		BOOT_UART        réception des commandes prête
+		BOOT_COMMANDE    première commande valide: trame de la manette ou commande ?x
+		BOOT_MLI         premier rapport cyclique non nul sur un moteur
+		BOOT_LCD         LCD prêt
+
+	La commande ?D reçue sur UART_0 renvoie:
+
+		boot uart=<µs> commande=<µs> mli=<µs> lcd=<µs>
+
+	avec - pour une étape pas encore atteinte. tools/twin vérifie ces temps sur le
+	démarrage à la mise sous tension et après un reset du chien de garde (make boot).
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+typedef enum{
+
+	BOOT_UART = 0,
+	BOOT_COMMANDE,
+	BOOT_MLI,
+	BOOT_LCD,
+
+	BOOT_NB
+
+}boot_step_e;
+
+/* Étape pas encore atteinte (boot_get_us()) */
+#define BOOT_JAMAIS		0xFFFFFFFFUL
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Note une étape du démarrage, seulement la première fois
+	\param[in]	etape L'étape atteinte
+    \return rien.
+
+	Peut être appelée d'une interruption.
+*/
+void boot_mark(boot_step_e etape);
+
+/**
+    \brief Retourne l'instant d'une étape du démarrage
+	\param[in]	etape L'étape
+    \return L'instant en µs, BOOT_JAMAIS si l'étape n'est pas atteinte
+*/
+uint32_t boot_get_us(boot_step_e etape);
+
+/**
+    \brief Traite la commande ?D
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool boot_command(const char* ligne, uint8_t longueur);
+
+#endif /* BOOT_H_INCLUDED */
@@ -0,0 +1,143 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file bus.c
+	\brief Adresse de la grue sur un bus de plusieurs grues
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/eeprom.h>
+#include "bus.h"
+#include "battery.h"
+#include "eeprom_map.h"
+#include "timebase.h"
+#include "trame.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define EEPROM_MAGIC		0x4E
+
+typedef struct{
+
+	uint8_t magic;
+	uint8_t adresse;
+
+}bus_eeprom_t;
+
+_Static_assert(sizeof(bus_eeprom_t) <= EEPROM_BUS_TAILLE, "L'adresse dépasse sa zone de l'EEPROM");
+_Static_assert((BUS_ADRESSE_DEFAUT != UART_BROADCAST) && (BUS_ADRESSE_DEFAUT <= TRAME_BUS_GRUES_MAX),
+	"L'adresse par défaut doit être celle d'une grue");
+_Static_assert(TRAME_BUS_GRUES_MAX <= 9, "?N<d> ne lit qu'un chiffre");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static uint8_t adresse = BUS_ADRESSE_DEFAUT;
+
+#if BOARD_UART_BUS
+static uint32_t telemetrie_ms;		/* dernière réponse à la manette */
+static bool repondu = FALSE;
+#endif
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void bus_init(void){
+
+	bus_eeprom_t sauve;
+
+	eeprom_read_block(&sauve, (const void*)EEPROM_BUS_ADDR, sizeof(sauve));
+
+	if((sauve.magic == EEPROM_MAGIC) && (sauve.adresse != UART_BROADCAST) && (sauve.adresse <= TRAME_BUS_GRUES_MAX)){
+
+		adresse = sauve.adresse;
+	}
+
+#if BOARD_UART_BUS
+	uart_set_address(UART_0, adresse);
+#endif
+}
+
+
+uint8_t bus_get_address(void){
+
+	return adresse;
+}
+
+
+void bus_frame(void){
+
+#if BOARD_UART_BUS
+	if(repondu && (timebase_elapsed_ms(telemetrie_ms) < TRAME_BATT_PERIODE_MS)){
+
+		return;
+	}
+
+	telemetrie_ms = timebase_millis();
+	repondu = TRUE;
+
+	battery_send_telemetry(adresse);
+#endif
+}
+
+
+bool bus_command(const char* ligne, uint8_t longueur){
+
+	char texte[32];
+
+	if((longueur < 3) || (ligne[0] != '?') || (ligne[1] != 'N')){
+
+		return FALSE;
+	}
+
+	// ?N<1..9>
+	if(longueur > 3){
+
+		uint8_t nouvelle = ligne[2] - '0';
+
+		if((longueur != 4) || (nouvelle == UART_BROADCAST) || (nouvelle > TRAME_BUS_GRUES_MAX)){
+
+			uart_put_string(UART_0, "bus ?N<1..9>\n");
+			return TRUE;
+		}
+
+		bus_eeprom_t sauve = {EEPROM_MAGIC, nouvelle};
+
+		adresse = nouvelle;
+		eeprom_update_block(&sauve, (void*)EEPROM_BUS_ADDR, sizeof(sauve));
+	}
+
+	sprintf(texte, "bus adresse=%u actif=%u\n", adresse, BOARD_UART_BUS);
+	uart_put_string(UART_0, texte);
+
+#if BOARD_UART_BUS
+	uart_set_address(UART_0, adresse);
+#endif
+
+	return TRUE;
+}
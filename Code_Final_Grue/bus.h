@@ -0,0 +1,99 @@
+#ifndef BUS_H_INCLUDED
+#define BUS_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file bus.h
+	\brief Adresse de la grue sur un bus de plusieurs grues
+
+	Avec BOARD_UART_BUS à 1 (board_config.h), UART_0 reçoit des caractères de 9 bits et
+	une manette commande plusieurs grues sur la même liaison (voir trame.h). La grue ne
+	reçoit que les trames qui suivent son adresse: l'USART jette les autres sans lever
+	d'interruption (uart_set_address()).
+
+	L'adresse, de 1 à TRAME_BUS_GRUES_MAX, est gardée en EEPROM (EEPROM_BUS_ADDR); une
+	grue neuve a l'adresse BUS_ADRESSE_DEFAUT. La télémétrie de la batterie n'est plus
+	envoyée par une minuterie: la grue y répond après une trame qui lui est adressée,
+	au plus à toutes les TRAME_BATT_PERIODE_MS, pendant le créneau de sa trame.
+
+	Les sorties des grues sont reliées (voir trame.h): avec une adresse, UART_0 ne tient
+	TXD0 que pendant une réponse et la relâche en entrée avec pull-up ensuite. Vérifié
+	sur l'USART simulée de tools/fuzz (make bus: TXEN0 à 1 pendant chaque réponse, à 0
+	au repos); le conflit entre deux grues n'a pas été mesuré sur les cartes.
+
+	La commande ?N reçue sur UART_0 renvoie:
+
+		bus adresse=<1..9> actif=<BOARD_UART_BUS>
+
+	et ?N<1..9> change l'adresse, tout de suite et en EEPROM. Les commandes ne sont
+	reçues que par la grue visée, ou par toutes après l'adresse UART_BROADCAST: pour
+	changer l'adresse d'une grue neuve, elle doit être seule sur le bus.
+
+	Sans BOARD_UART_BUS, l'adresse se règle de la même façon mais n'est pas utilisée.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define BUS_ADRESSE_DEFAUT		1
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Lit l'adresse en EEPROM et la donne à UART_0
+    \return rien.
+
+	À appeler après uart_init(UART_0).
+*/
+void bus_init(void);
+
+/**
+    \brief Retourne l'adresse de la grue
+    \return L'adresse, de 1 à TRAME_BUS_GRUES_MAX
+*/
+uint8_t bus_get_address(void);
+
+/**
+    \brief Note une trame valide de la manette et y répond, sur un bus
+    \return rien.
+
+	À appeler après chaque trame acceptée par command_parse(). Sans BOARD_UART_BUS, ne
+	fait rien: la télémétrie suit sa minuterie (voir battery.h).
+*/
+void bus_frame(void);
+
+/**
+    \brief Traite la commande ?N
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool bus_command(const char* ligne, uint8_t longueur);
+
+#endif /* BUS_H_INCLUDED */
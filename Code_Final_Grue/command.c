@@ -0,0 +1,228 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file command.c
+	\brief Décodage des lignes reçues de la manette et commande des axes
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "command.h"
+#include "motor.h"
+#include "servo.h"
+#include "kinematics.h"
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void apply_glissiere(uint8_t g);
+static void apply_signed(motor_e motor, int16_t duty);
+static int16_t jog_speed(uint8_t value, uint8_t centre, uint8_t bas, uint8_t haut);
+static uint8_t reverse_duty(uint8_t value);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+command_e command_parse(const char* ligne, uint8_t longueur, command_frame_t* trame){
+
+	if((longueur == 0) || (ligne[longueur - 1] != '\n')){
+
+		return COMMAND_INVALID;
+	}
+
+	if(ligne[0] == '?'){
+
+		return ((longueur == 3) || (longueur == 4)) ? COMMAND_QUERY : COMMAND_INVALID;
+	}
+
+	if(longueur == TRAME_LONGUEUR){
+
+		if(((ligne[TRAME_SEQ] & TRAME_MARQUE) == 0) ||
+			((ligne[TRAME_TEMPS_BAS] & TRAME_MARQUE) == 0) ||
+			((ligne[TRAME_TEMPS_HAUT] & TRAME_MARQUE) == 0)){
+
+			return COMMAND_INVALID;
+		}
+	}
+
+	else if(longueur != TRAME_LONGUEUR_SIMPLE){
+
+		return COMMAND_INVALID;
+	}
+
+	if((ligne[TRAME_P] > 1) || (ligne[TRAME_A] >= TRAME_MODE_NB)){
+
+		return COMMAND_INVALID;
+	}
+
+	trame->y = ligne[TRAME_Y];
+	trame->x = ligne[TRAME_X];
+	trame->g = ligne[TRAME_G];
+	trame->p = ligne[TRAME_P];
+	trame->a = ligne[TRAME_A];
+	trame->has_seq = (longueur == TRAME_LONGUEUR);
+	trame->seq = trame->has_seq ? TRAME_DECODE_7(ligne[TRAME_SEQ]) : 0;
+
+	return COMMAND_FRAME;
+}
+
+
+void command_apply(uint8_t x, uint8_t y, uint8_t g, uint8_t p){
+
+	//Conditions Moteur en X
+	if(x == 137){
+
+		motor_set_duty(MOTOR_CHARIOT, 0);
+	}
+
+	else if(x < 135){
+
+		motor_set(MOTOR_CHARIOT, TRUE, reverse_duty(x));
+	}
+
+	else if(x >= 140){
+
+		motor_set(MOTOR_CHARIOT, FALSE, x);
+	}
+
+	//Conditions Moteur en Y
+	if(y == 140){
+
+		motor_set_duty(MOTOR_FLECHE, 0);
+	}
+
+	else if(y < 130){
+
+		motor_set(MOTOR_FLECHE, TRUE, reverse_duty(y));
+	}
+
+	else if(y > 145){
+
+		motor_set(MOTOR_FLECHE, FALSE, y);
+	}
+
+	apply_glissiere(g);
+	command_apply_gripper(p);
+}
+
+
+void command_apply_cartesian(uint8_t x, uint8_t y, uint8_t g, uint8_t p){
+
+	kinematics_jog_t jog;
+
+	// Mêmes zones mortes que command_apply(): l'axe s'arrête entre elles
+	kinematics_jog(jog_speed(x, 137, 135, 140), jog_speed(y, 140, 130, 146), &jog);
+
+	apply_signed(MOTOR_CHARIOT, jog.chariot);
+	apply_signed(MOTOR_FLECHE, jog.fleche);
+
+	apply_glissiere(g);
+	command_apply_gripper(p);
+}
+
+
+void command_apply_gripper(uint8_t p){
+
+	//Conditions Pince
+	if(p == 1){
+
+		servo_set_position(COMMAND_PINCE_FERMEE_US);
+	}
+
+	else if(p == 0){
+
+		servo_set_position(COMMAND_PINCE_OUVERTE_US);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void apply_glissiere(uint8_t g){
+
+	//Conditions Moteur Glissière
+	if((g > 50) && (g < 205)){
+
+		motor_set_duty(MOTOR_GLISSIERE, 0);
+	}
+
+	else if(g > 205){
+
+		motor_set(MOTOR_GLISSIERE, TRUE, g);
+	}
+
+	else if(g <= 50){
+
+		motor_set(MOTOR_GLISSIERE, FALSE, reverse_duty(g));
+	}
+}
+
+
+/* Rapport cyclique signé: négatif pour la broche de direction à 1 */
+static void apply_signed(motor_e motor, int16_t duty){
+
+	if(duty == 0){
+
+		motor_set_duty(motor, 0);
+	}
+
+	else{
+
+		motor_set(motor, duty < 0, (duty < 0) ? -duty : duty);
+	}
+}
+
+
+/**
+    \brief Vitesse dans le plan d'un axe du joystick, en mm/s
+
+	0 de bas à haut - 1, proportionnelle à l'écart au centre au-delà, jusqu'à
+	KINEMATICS_JOG_MM_S au bout de la course.
+*/
+static int16_t jog_speed(uint8_t value, uint8_t centre, uint8_t bas, uint8_t haut){
+
+	if(value >= haut){
+
+		return (int32_t)(value - centre) * KINEMATICS_JOG_MM_S / (255 - centre);
+	}
+
+	if(value < bas){
+
+		return -(int32_t)(centre - value) * KINEMATICS_JOG_MM_S / centre;
+	}
+
+	return 0;
+}
+
+
+/**
+    \brief Rapport cyclique du recul: 255 - 2 * value, sans passer sous 0
+
+	Calculé sur 8 bits, 255 - 2 * value revenait à 243..254 pour x de 128 à 134: le
+	joystick presque au centre donnait le recul à pleine vitesse.
+*/
+static uint8_t reverse_duty(uint8_t value){
+
+	return (value < 128) ? 255 - 2 * value : 0;
+}
@@ -0,0 +1,124 @@
+#ifndef COMMAND_H_INCLUDED
+#define COMMAND_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file command.h
+	\brief Décodage des lignes reçues de la manette et commande des axes
+
+	Une ligne lue par uart_get_line() est:
+
+	- une trame (trame.h): TRAME_LONGUEUR octets dont seq, t0 et t1 ont le bit 7 à 1,
+	  ou TRAME_LONGUEUR_SIMPLE octets d'une ancienne manette. p vaut 0 ou 1 et a est
+	  un trame_mode_e;
+	- une commande de mesure: '?', une lettre et parfois un chiffre, puis '\n';
+	- sinon invalide: ligne tronquée par un '\n' dans une valeur, fin d'une ligne trop
+	  longue pour le tampon, octets perdus. Elle est ignorée.
+
+	Correspondance entre les commandes et les axes (command_apply()):
+
+		Axe          Arrêt        Recul (dir 1)               Avance (dir 0)
+		Chariot (x)  x = 137      x < 135: 255 - 2x, min. 0   x >= 140: x
+		Flèche (y)   y = 140      y < 130: 255 - 2y, min. 0   y > 145: y
+		Glissière(g) 50 < g < 205 g > 205: g (dir 1)          g <= 50: 255 - 2g (dir 0)
+
+	Entre ces zones (exe.: x de 135 à 139 sauf 137), l'axe garde la commande
+	précédente. La pince est fermée pour p = 1 et ouverte pour p = 0.
+
+	En mode cartésien (command_apply_cartesian()), x et y donnent la vitesse de la
+	charge selon X et Y (kinematics.h), proportionnelle à l'écart au centre au-delà des
+	mêmes zones: de 0 entre elles à KINEMATICS_JOG_MM_S au bout de la course. La
+	glissière et la pince ne changent pas.
+
+	Le décodage et la correspondance sont compilés aussi sur Linux par tools/fuzz, qui
+	les vérifie avec des flux d'octets tronqués, aléatoires ou plus gros que le tampon.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "trame.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Positions de la pince (largeur d'impulsion du servomoteur en us) */
+#define COMMAND_PINCE_FERMEE_US		1000
+#define COMMAND_PINCE_OUVERTE_US	2000
+
+typedef enum{
+
+	COMMAND_INVALID = 0,
+	COMMAND_FRAME,
+	COMMAND_QUERY
+
+}command_e;
+
+
+typedef struct{
+
+	uint8_t y;
+	uint8_t x;
+	uint8_t g;
+	uint8_t p;
+	uint8_t a;
+	bool has_seq;		/* FALSE pour une trame d'une ancienne manette */
+	uint8_t seq;
+
+}command_frame_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Classe une ligne reçue et décode la trame
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+	\param[out]	trame Les commandes, écrites seulement pour COMMAND_FRAME
+    \return COMMAND_FRAME, COMMAND_QUERY ou COMMAND_INVALID
+*/
+command_e command_parse(const char* ligne, uint8_t longueur, command_frame_t* trame);
+
+/**
+    \brief Applique les commandes aux moteurs et à la pince
+	\param[in]	x, y, g, p Les commandes d'une trame ou du rejeu (teach.h)
+    \return rien.
+*/
+void command_apply(uint8_t x, uint8_t y, uint8_t g, uint8_t p);
+
+/**
+    \brief Applique les commandes en mode cartésien: x et y déplacent la charge en ligne droite
+	\param[in]	x, y, g, p Les commandes d'une trame
+    \return rien.
+*/
+void command_apply_cartesian(uint8_t x, uint8_t y, uint8_t g, uint8_t p);
+
+/**
+    \brief Applique seulement la commande de la pince (mode automatique, voir automation.h)
+	\param[in]	p La commande de la pince d'une trame
+    \return rien.
+*/
+void command_apply_gripper(uint8_t p);
+
+#endif /* COMMAND_H_INCLUDED */
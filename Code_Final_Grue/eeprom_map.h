@@ -0,0 +1,57 @@
+#ifndef EEPROM_MAP_H_INCLUDED
+#define EEPROM_MAP_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file eeprom_map.h
+	\brief Plan de l'EEPROM de la grue
+
+	Les adresses sont fixes (pas de EEMEM): le contenu doit rester lisible d'une
+	version du programme à l'autre. Chaque module qui utilise l'EEPROM a sa zone ici,
+	à la suite de la précédente.
+*/
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define EEPROM_TAILLE				1024
+
+/* Boîte noire: dernier contenu du tampon d'événements (voir blackbox.h) */
+#define EEPROM_BLACKBOX_ADDR		0x000
+#define EEPROM_BLACKBOX_TAILLE		0x104
+
+/* Session apprise: en-tête puis enregistrements codés (voir teach.h) */
+#define EEPROM_TEACH_ADDR			(EEPROM_BLACKBOX_ADDR + EEPROM_BLACKBOX_TAILLE)
+#define EEPROM_TEACH_TAILLE			0x2C0
+
+/* Gains de la boucle de position de la flèche, trouvés par autotune.c (voir pid.h) */
+#define EEPROM_PID_ADDR				(EEPROM_TEACH_ADDR + EEPROM_TEACH_TAILLE)
+#define EEPROM_PID_TAILLE			0x08
+
+/* Adresse de la grue sur le bus de plusieurs grues (voir bus.h) */
+#define EEPROM_BUS_ADDR				(EEPROM_PID_ADDR + EEPROM_PID_TAILLE)
+#define EEPROM_BUS_TAILLE			0x02
+
+#define EEPROM_LIBRE_ADDR			(EEPROM_BUS_ADDR + EEPROM_BUS_TAILLE)
+
+_Static_assert(EEPROM_LIBRE_ADDR <= EEPROM_TAILLE, "Le plan dépasse la taille de l'EEPROM");
+
+#endif /* EEPROM_MAP_H_INCLUDED */
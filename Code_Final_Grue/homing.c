@@ -0,0 +1,332 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file homing.c
+	\brief Recherche du zéro de la flèche et du chariot
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "homing.h"
+#include "automation.h"
+#include "blackbox.h"
+#include "kinematics.h"
+#include "motor.h"
+#include "timebase.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Axes cherchés: la flèche et le chariot, dans l'ordre de motor_e */
+#define AXES				2
+
+/* Repère de la flèche: milieu du secteur 0 de l'encodeur, en 1/16 de degré */
+#define REPERE_FLECHE		(KINEMATICS_ENCODEUR_PAS * KINEMATICS_DEGRE / 2)
+
+_Static_assert((MOTOR_FLECHE == 0) && (MOTOR_CHARIOT == 1), "Les axes cherchés suivent l'ordre de motor_e");
+_Static_assert(HOMING_FLECHE_LENT_DUTY > KINEMATICS_FLECHE_SEUIL, "L'approche lente doit dépasser le seuil de frottement");
+_Static_assert(HOMING_CHARIOT_LENT_DUTY > KINEMATICS_CHARIOT_SEUIL, "L'approche lente doit dépasser le seuil de frottement");
+
+typedef enum{
+
+	FINI = 0,
+	RAPIDE,
+	RECUL,
+	LENT,
+	ECHEC
+
+}phase_e;
+
+
+typedef struct{
+
+	bool vers;				/* direction de l'approche */
+	uint8_t lent;			/* rapport cyclique de l'approche lente */
+	uint16_t max_ms;
+
+}config_t;
+
+
+typedef struct{
+
+	phase_e phase;
+	bool lance;				/* moteur démarré après la pause */
+	bool vu;				/* repère appuyé pendant le recul */
+	uint32_t phase_ms;		/* début de la phase */
+	uint32_t relache_ms;	/* repère relâché pendant le recul, 0 sinon */
+	uint16_t duree_ms;
+	int16_t ecart;
+
+}axe_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static const config_t config[AXES] = {
+
+	{FALSE, HOMING_FLECHE_LENT_DUTY, HOMING_FLECHE_MAX_MS},
+	{TRUE, HOMING_CHARIOT_LENT_DUTY, HOMING_CHARIOT_MAX_MS},
+};
+
+static axe_t axes[AXES];
+static uint32_t debut_ms;
+static bool en_cours = FALSE;
+static bool fait = FALSE;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static bool avancer(uint8_t i, bool appuye);
+static void phase(uint8_t i, phase_e nouvelle);
+static int16_t ecart(uint8_t i);
+static void rapport(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void homing_start(void){
+
+	debut_ms = timebase_millis();
+	en_cours = TRUE;
+	fait = FALSE;
+
+	for(uint8_t i = 0; i < AXES; i++){
+
+		axes[i].ecart = 0;
+		phase(i, RAPIDE);
+	}
+}
+
+
+bool homing_process(bool repere_fleche, bool fin_mat){
+
+	if(!en_cours){
+
+		return FALSE;
+	}
+
+	bool zero = avancer(MOTOR_FLECHE, repere_fleche);
+
+	avancer(MOTOR_CHARIOT, fin_mat);
+
+	// Fin quand chaque axe a trouvé son zéro ou échoué
+	for(uint8_t i = 0; i < AXES; i++){
+
+		if((axes[i].phase != FINI) && (axes[i].phase != ECHEC)){
+
+			return zero;
+		}
+	}
+
+	en_cours = FALSE;
+	fait = (axes[MOTOR_FLECHE].phase == FINI) && (axes[MOTOR_CHARIOT].phase == FINI);
+
+	rapport();
+
+	return zero;
+}
+
+
+bool homing_is_busy(void){
+
+	return en_cours;
+}
+
+
+bool homing_is_done(void){
+
+	return fait;
+}
+
+
+bool homing_command(const char* ligne, uint8_t longueur){
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'Z')){
+
+		return FALSE;
+	}
+
+	// Le plan rend ses axes; il recommence après le zéro
+	automation_stop();
+	homing_start();
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Une phase d'un axe, retourne TRUE quand l'axe prend son zéro */
+static bool avancer(uint8_t i, bool appuye){
+
+	axe_t* axe = &axes[i];
+	uint32_t maintenant = timebase_millis();
+
+	if((axe->phase == FINI) || (axe->phase == ECHEC)){
+
+		return FALSE;
+	}
+
+	if(timebase_elapsed_ms(debut_ms) > config[i].max_ms){
+
+		phase(i, ECHEC);
+		return FALSE;
+	}
+
+	// L'axe démarre après la pause, sauf la première approche: le recul s'éloigne du
+	// repère, les approches y vont
+	if(!axe->lance && ((axe->phase == RAPIDE) || (maintenant - axe->phase_ms >= HOMING_PAUSE_MS))){
+
+		bool dir = (axe->phase == RECUL) ? !config[i].vers : config[i].vers;
+		uint8_t duty = HOMING_RAPIDE_DUTY;
+
+		if(axe->phase == RECUL){
+
+			duty = HOMING_RECUL_DUTY;
+		}
+
+		else if(axe->phase == LENT){
+
+			duty = config[i].lent;
+		}
+
+		motor_set(i, dir, duty);
+		axe->lance = TRUE;
+	}
+
+	switch(axe->phase){
+	case RAPIDE:
+
+		if(appuye){
+
+			axe->ecart = ecart(i);
+			phase(i, RECUL);
+		}
+
+		break;
+
+	case RECUL:
+
+		// Freiné au-delà du repère, l'axe le retraverse en reculant: seul le dernier
+		// relâchement compte
+		if(appuye){
+
+			axe->vu = TRUE;
+			axe->relache_ms = 0;
+		}
+
+		else if(!axe->vu){
+
+			break;
+		}
+
+		else if(axe->relache_ms == 0){
+
+			axe->relache_ms = maintenant;
+		}
+
+		else if(maintenant - axe->relache_ms >= HOMING_RECUL_MS){
+
+			phase(i, LENT);
+		}
+
+		break;
+
+	case LENT:
+
+		if(appuye && axe->lance){
+
+			phase(i, FINI);
+			axe->duree_ms = timebase_elapsed_ms(debut_ms);
+
+			if(i == MOTOR_FLECHE){
+
+				kinematics_set_angle(REPERE_FLECHE);
+				return TRUE;
+			}
+		}
+
+		break;
+
+	default:
+
+		break;
+	}
+
+	return FALSE;
+}
+
+
+/* Passe un axe à une phase, moteur freiné */
+static void phase(uint8_t i, phase_e nouvelle){
+
+	motor_stop(i, MOTOR_STOP_BRAKE);
+
+	axes[i].phase = nouvelle;
+	axes[i].lance = FALSE;
+	axes[i].vu = FALSE;
+	axes[i].phase_ms = timebase_millis();
+	axes[i].relache_ms = 0;
+}
+
+
+/* Position estimée d'un axe moins celle de son repère */
+static int16_t ecart(uint8_t i){
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+
+	if(i == MOTOR_CHARIOT){
+
+		return position.chariot_mm;
+	}
+
+	int16_t e = (int16_t)position.angle - REPERE_FLECHE;
+
+	return (e > 180 * KINEMATICS_DEGRE) ? e - 360 * KINEMATICS_DEGRE : e;
+}
+
+
+static void rapport(void){
+
+	char texte[72];		/* rapport réussi: 65 octets au plus, \0 compris */
+
+	blackbox_log(BLACKBOX_EVENT_HOMING, fait ? 0 : 1 + (axes[MOTOR_FLECHE].phase == FINI));
+
+	if(!fait){
+
+		snprintf(texte, sizeof(texte), "homing echec axe=%u\n", (axes[MOTOR_FLECHE].phase == FINI) ? MOTOR_CHARIOT : MOTOR_FLECHE);
+		uart_put_string(UART_0, texte);
+		return;
+	}
+
+	snprintf(texte, sizeof(texte), "homing fleche=%u chariot=%u ecart_a=%d ecart_c=%d\n", axes[MOTOR_FLECHE].duree_ms,
+		axes[MOTOR_CHARIOT].duree_ms, axes[MOTOR_FLECHE].ecart, axes[MOTOR_CHARIOT].ecart);
+	uart_put_string(UART_0, texte);
+}
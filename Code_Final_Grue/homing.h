@@ -0,0 +1,131 @@
+#ifndef HOMING_H_INCLUDED
+#define HOMING_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file homing.h
+	\brief Recherche du zéro de la flèche et du chariot
+
+	L'encodeur de la flèche compte des secteurs à partir de sa position au démarrage:
+	sans recherche du zéro, les angles du plan et de automation_goto() ne veulent rien
+	dire. Chaque axe a un repère, actif à 0:
+
+		Axe          Repère                          Sens de l'approche
+		Flèche       PA2, milieu du secteur 0        angle croissant (direction à 0)
+		Chariot      PA0, fin de course côté mât     vers le mât (direction à 1)
+
+	Le repère de la flèche est un contact ajouté, placé pour fermer au milieu du secteur
+	0 de l'encodeur (7,5°) quand la flèche y arrive par le bas: le zéro tombe loin des
+	fronts de INT0. La glissière n'a que ses butées mécaniques et n'est pas cherchée.
+
+	Les deux axes sont cherchés en même temps, chacun en trois temps:
+
+	1. approche rapide jusqu'au repère (HOMING_RAPIDE_DUTY), arrêt freiné;
+	2. recul jusqu'à ce que le repère se relâche, puis HOMING_RECUL_MS de plus;
+	3. approche lente: à l'arrivée sur le repère, l'axe est freiné et son zéro pris.
+
+	Chaque changement de sens attend HOMING_PAUSE_MS, axe arrêté. Le zéro de la flèche
+	remet l'encodeur (clics) à 0 et l'estimation de kinematics.h au repère; celui du
+	chariot est pris par kinematics.h sur sa fin de course.
+
+	La recherche commence au démarrage et sur la commande ?Z reçue sur UART_0. Pendant
+	la recherche, la manette ne commande que la pince; l'automation attend le zéro. À
+	la fin, sur UART_0:
+
+		homing fleche=<ms> chariot=<ms> ecart_a=<1/16 de degré> ecart_c=<mm>
+
+	L'écart est la position estimée à la première arrivée sur le repère, moins celle du
+	repère: la dérive de l'estimation depuis le zéro précédent. Au démarrage, c'est
+	l'écart à la position supposée (angle 0, chariot à mi-course). Deux ?Z de suite
+	donnent la répétabilité: le second écart est l'erreur du zéro trouvé par le premier,
+	à la résolution de l'estimation près.
+
+	Un axe qui n'arrive pas à son repère avant sa durée la plus longue est arrêté et la
+	recherche échoue (homing echec axe=<motor_e>): la manette reprend les moteurs,
+	l'automation attend un ?Z réussi.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Rapports cycliques de l'approche rapide, du recul et de l'approche lente de chaque axe */
+#define HOMING_RAPIDE_DUTY			200
+#define HOMING_RECUL_DUTY			120
+#define HOMING_FLECHE_LENT_DUTY		60
+#define HOMING_CHARIOT_LENT_DUTY	80
+
+/* Arrêt avant chaque changement de sens et recul après le repère relâché, en ms */
+#define HOMING_PAUSE_MS				200
+#define HOMING_RECUL_MS				300
+
+/* Durée la plus longue de la recherche d'un axe, en ms: un tour de flèche, la course du chariot */
+#define HOMING_FLECHE_MAX_MS		20000
+#define HOMING_CHARIOT_MAX_MS		15000
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Commence la recherche du zéro des deux axes
+    \return rien.
+
+	Les axes doivent être libres: automation_stop() avant, en mode automatique.
+*/
+void homing_start(void);
+
+/**
+    \brief Avance la recherche
+	\param[in]	repere_fleche TRUE si le repère de la flèche (PA2) est appuyé
+	\param[in]	fin_mat TRUE si la fin de course côté mât (PA0) est appuyée
+    \return TRUE quand la flèche arrive sur son repère: l'encodeur (clics) est à remettre à 0
+
+	À appeler à chaque passage de la boucle principale, avant kinematics_update().
+*/
+bool homing_process(bool repere_fleche, bool fin_mat);
+
+/**
+    \brief Indique si la recherche est en cours
+    \return TRUE de homing_start() à la fin, réussie ou non
+*/
+bool homing_is_busy(void);
+
+/**
+    \brief Indique si le zéro est connu
+    \return TRUE après une recherche réussie
+*/
+bool homing_is_done(void);
+
+/**
+    \brief Traite la commande ?Z
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool homing_command(const char* ligne, uint8_t longueur);
+
+#endif /* HOMING_H_INCLUDED */
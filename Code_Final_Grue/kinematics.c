@@ -0,0 +1,330 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file kinematics.c
+	\brief Géométrie de la grue: position estimée, mode cartésien et cinématique inverse
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/pgmspace.h>
+#include "kinematics.h"
+#include "motor.h"
+#include "battery.h"
+#include "timebase.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define SECTEURS			(360 / KINEMATICS_ENCODEUR_PAS)
+
+/* Angles en millidegrés et chariot en µm: une vitesse en °/s ou mm/s avance de v par ms */
+#define SECTEUR_MDEG		((int32_t)KINEMATICS_ENCODEUR_PAS * 1000)
+#define COURSE_UM			((int32_t)KINEMATICS_CHARIOT_COURSE_MM * 1000)
+
+#define DEMI_TOUR			(180 * KINEMATICS_DEGRE)
+#define QUART_TOUR			(90 * KINEMATICS_DEGRE)
+
+/* CORDIC: angles en degrés avec 8 bits de fraction, gain 1/1,64676 (15 bits) */
+#define CORDIC_ITERATIONS	14
+#define CORDIC_GAIN			19898L
+
+/* 180 / pi avec 6 bits de fraction: °/s d'une vitesse tangentielle divisée par le rayon */
+#define RADIAN_DEGRES		3667L
+
+_Static_assert(360 % KINEMATICS_ENCODEUR_PAS == 0, "L'encodeur doit avoir un nombre entier de secteurs");
+
+_Static_assert((KINEMATICS_FLECHE_SEUIL < 255) && (KINEMATICS_CHARIOT_SEUIL < 255),
+	"Le seuil de frottement doit être sous 255");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* sin(0° à 90°), 15 bits de fraction */
+static const int16_t sinus[91] PROGMEM = {
+
+	0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+	5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+	11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+	16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+	21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+	25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+	28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+	30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+	32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+	32767,
+};
+
+/* atan(2^-i), en degrés avec 8 bits de fraction */
+static const int16_t arctan[CORDIC_ITERATIONS] PROGMEM = {
+
+	11520, 6801, 3593, 1824, 916, 458, 229, 115, 57, 29, 14, 7, 4, 2,
+};
+
+static int32_t angle_mdeg;
+static int32_t chariot_um;
+static uint8_t secteur_prec;
+static uint32_t dernier_ms;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static int32_t vitesse(motor_e motor, uint8_t vmax, uint8_t seuil);
+static int16_t rapport(int32_t utile, uint8_t seuil);
+static uint32_t valeur_absolue(int32_t valeur);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void kinematics_init(void){
+
+	angle_mdeg = 0;
+	chariot_um = (int32_t)KINEMATICS_CHARIOT_DEPART_MM * 1000;
+	secteur_prec = 0;
+	dernier_ms = timebase_millis();
+}
+
+
+void kinematics_set_angle(uint16_t angle){
+
+	angle_mdeg = (int32_t)angle * 1000 / KINEMATICS_DEGRE;
+	secteur_prec = angle_mdeg / SECTEUR_MDEG;
+}
+
+
+void kinematics_update(uint8_t secteur, bool fin_mat, bool fin_bout){
+
+	uint32_t maintenant = timebase_millis();
+	uint32_t dt = maintenant - dernier_ms;
+
+	dernier_ms = maintenant;
+
+	angle_mdeg += vitesse(MOTOR_FLECHE, KINEMATICS_FLECHE_VMAX, KINEMATICS_FLECHE_SEUIL) * dt;
+	chariot_um += vitesse(MOTOR_CHARIOT, KINEMATICS_CHARIOT_VMAX, KINEMATICS_CHARIOT_SEUIL) * dt;
+
+	// Angle: dans le secteur de l'encodeur, sur son bord au franchissement
+	int32_t debut = (int32_t)secteur * SECTEUR_MDEG;
+
+	if(secteur != secteur_prec){
+
+		angle_mdeg = (secteur == (secteur_prec + 1) % SECTEURS) ? debut : debut + SECTEUR_MDEG - 1;
+		secteur_prec = secteur;
+	}
+
+	else if(angle_mdeg < debut){
+
+		angle_mdeg = debut;
+	}
+
+	else if(angle_mdeg >= debut + SECTEUR_MDEG){
+
+		angle_mdeg = debut + SECTEUR_MDEG - 1;
+	}
+
+	// Chariot: dans sa course, recalé sur les fins de course
+	if(fin_mat || (chariot_um < 0)){
+
+		chariot_um = 0;
+	}
+
+	if(fin_bout || (chariot_um > COURSE_UM)){
+
+		chariot_um = COURSE_UM;
+	}
+}
+
+
+void kinematics_get(kinematics_polar_t* position){
+
+	position->angle = angle_mdeg * KINEMATICS_DEGRE / 1000;
+	position->chariot_mm = chariot_um / 1000;
+}
+
+
+int16_t kinematics_sin(uint16_t angle){
+
+	bool negatif = FALSE;
+
+	angle %= 2 * DEMI_TOUR;
+
+	if(angle >= DEMI_TOUR){
+
+		angle -= DEMI_TOUR;
+		negatif = TRUE;
+	}
+
+	if(angle > QUART_TOUR){
+
+		angle = DEMI_TOUR - angle;
+	}
+
+	// Interpolation entre deux degrés de la table
+	uint8_t degre = angle / KINEMATICS_DEGRE;
+	uint8_t fraction = angle % KINEMATICS_DEGRE;
+	int16_t a = pgm_read_word(&sinus[degre]);
+	int16_t b = (degre < 90) ? (int16_t)pgm_read_word(&sinus[degre + 1]) : a;
+	int16_t s = a + ((int32_t)(b - a) * fraction) / KINEMATICS_DEGRE;
+
+	return negatif ? -s : s;
+}
+
+
+int16_t kinematics_cos(uint16_t angle){
+
+	return kinematics_sin((angle % (2 * DEMI_TOUR)) + QUART_TOUR);
+}
+
+
+void kinematics_forward(const kinematics_polar_t* position, int16_t* x, int16_t* y){
+
+	int32_t rayon = KINEMATICS_RAYON_MIN_MM + position->chariot_mm;
+
+	*x = (rayon * kinematics_cos(position->angle)) / 32768;
+	*y = (rayon * kinematics_sin(position->angle)) / 32768;
+}
+
+
+bool kinematics_inverse(int16_t x, int16_t y, kinematics_polar_t* position){
+
+	// CORDIC en mode vecteur: la rotation qui amène (x, y) sur l'axe X donne l'angle
+	int32_t cx = (int32_t)x << 8;
+	int32_t cy = (int32_t)y << 8;
+	int32_t angle = 0;
+
+	if(cx < 0){
+
+		cx = -cx;
+		cy = -cy;
+		angle = 180L << 8;
+	}
+
+	for(uint8_t i = 0; i < CORDIC_ITERATIONS; i++){
+
+		int32_t dx = cx >> i;
+		int32_t dy = cy >> i;
+		int16_t pas = pgm_read_word(&arctan[i]);
+
+		if(cy > 0){
+
+			cx += dy;
+			cy -= dx;
+			angle += pas;
+		}
+
+		else{
+
+			cx -= dy;
+			cy += dx;
+			angle -= pas;
+		}
+	}
+
+	if(angle < 0){
+
+		angle += 360L << 8;
+	}
+
+	int32_t rayon = ((cx >> 4) * CORDIC_GAIN) >> 19;
+	int32_t course = rayon - KINEMATICS_RAYON_MIN_MM;
+
+	position->angle = ((angle + 8) >> 4) % (2 * DEMI_TOUR);
+	position->chariot_mm = (course < 0) ? 0 :
+		(course > KINEMATICS_CHARIOT_COURSE_MM) ? KINEMATICS_CHARIOT_COURSE_MM : course;
+
+	return (course >= 0) && (course <= KINEMATICS_CHARIOT_COURSE_MM);
+}
+
+
+void kinematics_jog(int16_t vx, int16_t vy, kinematics_jog_t* jog){
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+
+	int16_t s = kinematics_sin(position.angle);
+	int16_t c = kinematics_cos(position.angle);
+	int32_t rayon = KINEMATICS_RAYON_MIN_MM + position.chariot_mm;
+
+	// Vitesses radiale (chariot) et tangentielle (flèche), en mm/s
+	int32_t radiale = ((int32_t)vx * c + (int32_t)vy * s) / 32768;
+	int32_t tangentielle = ((int32_t)vy * c - (int32_t)vx * s) / 32768;
+	int32_t rotation = tangentielle * RADIAN_DEGRES / (rayon << 6);
+
+	// Part du rapport cyclique au-dessus du seuil de frottement
+	int32_t fleche = rotation * 255 / KINEMATICS_FLECHE_VMAX;
+	int32_t chariot = radiale * 255 / KINEMATICS_CHARIOT_VMAX;
+
+	// Saturation: les deux axes réduits ensemble (8 bits de fraction)
+	uint32_t echelle_fleche = valeur_absolue(fleche) * 256 / (255 - KINEMATICS_FLECHE_SEUIL);
+	uint32_t echelle_chariot = valeur_absolue(chariot) * 256 / (255 - KINEMATICS_CHARIOT_SEUIL);
+	uint32_t echelle = (echelle_fleche > echelle_chariot) ? echelle_fleche : echelle_chariot;
+
+	if(echelle > 256){
+
+		fleche = fleche * 256 / (int32_t)echelle;
+		chariot = chariot * 256 / (int32_t)echelle;
+	}
+
+	jog->fleche = rapport(fleche, KINEMATICS_FLECHE_SEUIL);
+	jog->chariot = rapport(chariot, KINEMATICS_CHARIOT_SEUIL);
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Vitesse d'un axe (°/s ou mm/s), positive pour la broche de direction à 0 */
+static int32_t vitesse(motor_e motor, uint8_t vmax, uint8_t seuil){
+
+	// Tension au moteur ramenée à la batterie nominale
+	uint32_t duty = (uint32_t)motor_get_duty(motor) * battery_get_mv() / BATTERY_NOMINAL_MV;
+
+	if(duty <= seuil){
+
+		return 0;
+	}
+
+	int32_t v = (int32_t)vmax * (int32_t)(duty - seuil) / 255;
+
+	return motor_get_dir(motor) ? -v : v;
+}
+
+
+/* Rapport cyclique signé: le seuil de frottement plus la part utile */
+static int16_t rapport(int32_t utile, uint8_t seuil){
+
+	if(utile == 0){
+
+		return 0;
+	}
+
+	return (utile > 0) ? seuil + utile : -(seuil - utile);
+}
+
+
+static uint32_t valeur_absolue(int32_t valeur){
+
+	return (valeur < 0) ? -valeur : valeur;
+}
@@ -0,0 +1,174 @@
+#ifndef KINEMATICS_H_INCLUDED
+#define KINEMATICS_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file kinematics.h
+	\brief Géométrie de la grue: position estimée, mode cartésien et cinématique inverse
+
+	La grue est polaire: la flèche tourne d'un angle a autour du mât et le chariot
+	porte la charge à un rayon r = KINEMATICS_RAYON_MIN_MM + course du chariot. Le plan
+	horizontal a l'axe X à l'angle 0 de l'encodeur et l'axe Y à 90°:
+
+		x = r.cos(a)        r = sqrt(x^2 + y^2)
+		y = r.sin(a)        a = atan2(y, x)
+
+	Tout est en virgule fixe: sinus d'une table de 91 valeurs en flash (15 bits de
+	fraction, interpolée au 1/16 de degré), atan2 et rayon par CORDIC (14 itérations).
+	Les angles sont en 1/16 de degré (KINEMATICS_DEGRE), les positions en mm.
+
+	Position estimée (kinematics_update(), à chaque passage de la boucle):
+
+	- angle: intégré de la vitesse de la flèche et gardé dans le secteur de 15° de
+	  l'encodeur; un front de l'encodeur le place sur le bord du secteur franchi;
+	- chariot: intégré de sa vitesse, recalé sur les fins de course (0 et
+	  KINEMATICS_CHARIOT_COURSE_MM). Au démarrage, le chariot est supposé à
+	  KINEMATICS_CHARIOT_DEPART_MM jusqu'à la recherche du zéro (homing.h).
+
+	La vitesse d'un axe vient de son rapport cyclique appliqué (motor_get_duty()), avec
+	un seuil de frottement: v = vmax.(duty - seuil) / 255 au-dessus du seuil, 0 sinon.
+
+	En mode cartésien (TRAME_MODE_CARTESIEN), le joystick donne les vitesses vx et vy
+	dans le plan; kinematics_jog() les change en rapports cycliques de la flèche et du
+	chariot à la position estimée. Quand un axe sature, les deux sont réduits dans la
+	même proportion: la charge garde sa direction.
+
+	La direction est recalculée à chaque trame à la position estimée. La mise en forme
+	contre le balancement (shaper.h) retarde les deux axes d'environ une demi-période
+	du pendule: la trajectoire s'écarte un peu de la droite (environ 10 % à 80 mm/s).
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Résolution des angles: 1/16 de degré */
+#define KINEMATICS_DEGRE			16
+
+/* Rayon du chariot en fin de course côté mât, et sa course, en mm */
+#define KINEMATICS_RAYON_MIN_MM		100
+#define KINEMATICS_CHARIOT_COURSE_MM	400
+#define KINEMATICS_CHARIOT_DEPART_MM	(KINEMATICS_CHARIOT_COURSE_MM / 2)
+
+/* Vitesse à 255 sans le frottement (°/s, mm/s) et seuil de frottement de chaque axe */
+#define KINEMATICS_FLECHE_VMAX		60
+#define KINEMATICS_FLECHE_SEUIL		38
+#define KINEMATICS_CHARIOT_VMAX		120
+#define KINEMATICS_CHARIOT_SEUIL	51
+
+/* Pas d'un secteur de l'encodeur de la flèche, en degrés */
+#define KINEMATICS_ENCODEUR_PAS		15
+
+/* Vitesse du joystick au bout de sa course en mode cartésien, en mm/s */
+#define KINEMATICS_JOG_MM_S			80
+
+typedef struct{
+
+	uint16_t angle;			/* 1/16 de degré, de 0 à 360° */
+	uint16_t chariot_mm;	/* course du chariot */
+
+}kinematics_polar_t;
+
+
+typedef struct{
+
+	int16_t fleche;			/* rapport cyclique signé, négatif pour la direction à 1 */
+	int16_t chariot;
+
+}kinematics_jog_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Place l'estimation au démarrage: angle 0, chariot à KINEMATICS_CHARIOT_DEPART_MM
+    \return rien.
+*/
+void kinematics_init(void);
+
+/**
+    \brief Place l'angle estimé, au zéro de la flèche (homing.h)
+	\param[in]	angle L'angle, en 1/16 de degré, dans le secteur 0 de l'encodeur après sa remise à 0
+    \return rien.
+*/
+void kinematics_set_angle(uint16_t angle);
+
+/**
+    \brief Avance la position estimée
+	\param[in]	secteur Le secteur de l'encodeur (clics, de 0 à 23)
+	\param[in]	fin_mat TRUE si la fin de course côté mât est appuyée
+	\param[in]	fin_bout TRUE si la fin de course au bout de la flèche est appuyée
+    \return rien.
+*/
+void kinematics_update(uint8_t secteur, bool fin_mat, bool fin_bout);
+
+/**
+    \brief Retourne la position estimée
+	\param[out]	position L'angle et la course du chariot
+    \return rien.
+*/
+void kinematics_get(kinematics_polar_t* position);
+
+/**
+    \brief Sinus en virgule fixe
+	\param[in]	angle L'angle, en 1/16 de degré
+    \return Le sinus, 15 bits de fraction
+*/
+int16_t kinematics_sin(uint16_t angle);
+
+/**
+    \brief Cosinus en virgule fixe
+	\param[in]	angle L'angle, en 1/16 de degré
+    \return Le cosinus, 15 bits de fraction
+*/
+int16_t kinematics_cos(uint16_t angle);
+
+/**
+    \brief Position dans le plan d'une position de la grue
+	\param[in]	position L'angle et la course du chariot
+	\param[out]	x, y La position de la charge, en mm
+    \return rien.
+*/
+void kinematics_forward(const kinematics_polar_t* position, int16_t* x, int16_t* y);
+
+/**
+    \brief Cinématique inverse: position de la grue pour un point du plan
+	\param[in]	x, y Le point, en mm (de -2000 à 2000)
+	\param[out]	position L'angle et la course du chariot
+    \return TRUE si le chariot atteint le point, FALSE s'il est hors de sa course
+*/
+bool kinematics_inverse(int16_t x, int16_t y, kinematics_polar_t* position);
+
+/**
+    \brief Rapports cycliques de la flèche et du chariot pour une vitesse dans le plan
+	\param[in]	vx, vy La vitesse de la charge, en mm/s
+	\param[out]	jog Les rapports cycliques signés
+    \return rien.
+*/
+void kinematics_jog(int16_t vx, int16_t vy, kinematics_jog_t* jog);
+
+#endif /* KINEMATICS_H_INCLUDED */
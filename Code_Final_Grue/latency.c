@@ -0,0 +1,289 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file latency.c
+	\brief Latence entre la lecture d'une commande sur la manette et son application
+	sur les moteurs de la grue
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "latency.h"
+#include "timebase.h"
+#include "trame.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/*
+	Le décalage entre les horloges est gardé en quarts de ms sur 16 bits: le retour à 0
+	tombe au même endroit que celui des 14 bits de temps de la trame.
+*/
+#define QUARTS_PAR_MS		4
+
+/* Temps de la grue après lequel le décalage remonte d'un quart de ms */
+#define FUITE_MS			(1000000UL / (QUARTS_PAR_MS * LATENCY_DERIVE_PPM))
+
+typedef struct{
+
+	uint16_t buckets[LATENCY_NB_BUCKETS];
+	uint16_t count;
+	uint32_t max;
+
+}histogram_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static histogram_t histograms[LATENCY_NB];
+static const char* const noms[LATENCY_NB] = {"tr", "ap", "to"};
+
+static uint16_t nb_trames = 0;
+static uint16_t nb_perdues = 0;
+static uint16_t nb_sans_numero = 0;
+
+/* Dernière trame reçue */
+static bool en_attente = FALSE;
+static bool avec_temps = FALSE;
+static uint32_t rx_us_trame;
+static uint32_t transit_us;
+
+/* Suivi des numéros et du décalage des horloges */
+static bool premier = TRUE;
+static uint8_t seq_attendu;
+static uint16_t decalage_q;
+static uint32_t dernier_rx_ms;
+static uint32_t fuite_ms;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void histogram_add(histogram_t* h, uint32_t value);
+static uint32_t histogram_percentile(const histogram_t* h, uint8_t percent);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void latency_frame(const char* trame, uint8_t longueur, uint32_t rx_us){
+
+	nb_trames++;
+	en_attente = TRUE;
+	avec_temps = FALSE;
+	rx_us_trame = rx_us;
+
+	if(longueur < TRAME_LONGUEUR){
+
+		nb_sans_numero++;
+		return;
+	}
+
+	uint8_t seq = TRAME_DECODE_7(trame[TRAME_SEQ]);
+	uint16_t temps_q = TRAME_DECODE_14(trame[TRAME_TEMPS_BAS], trame[TRAME_TEMPS_HAUT]) * QUARTS_PAR_MS;
+	uint32_t rx_ms = rx_us / 1000;
+
+	// Écart brut entre les deux horloges, modulo 2^14 ms
+	uint16_t brut_q = (uint16_t)(rx_ms * QUARTS_PAR_MS) - temps_q;
+
+	if(premier){
+
+		premier = FALSE;
+		decalage_q = brut_q;
+		fuite_ms = 0;
+	}
+
+	else{
+
+		nb_perdues += (seq - seq_attendu) & TRAME_SEQ_MASQUE;
+
+		// Le décalage remonte lentement pour suivre la dérive des horloges
+		fuite_ms += rx_ms - dernier_rx_ms;
+
+		while(fuite_ms >= FUITE_MS){
+
+			fuite_ms -= FUITE_MS;
+			decalage_q++;
+		}
+
+		// Nouveau meilleur délai
+		if((int16_t)(brut_q - decalage_q) < 0){
+
+			decalage_q = brut_q;
+		}
+	}
+
+	seq_attendu = (seq + 1) & TRAME_SEQ_MASQUE;
+	dernier_rx_ms = rx_ms;
+
+	transit_us = (uint32_t)(uint16_t)(brut_q - decalage_q) * (1000 / QUARTS_PAR_MS);
+	avec_temps = TRUE;
+
+	histogram_add(&histograms[LATENCY_TRANSIT], transit_us);
+}
+
+
+void latency_applied(void){
+
+	if(en_attente == FALSE){
+
+		return;
+	}
+
+	en_attente = FALSE;
+
+	uint32_t apply_us = timebase_elapsed_us(rx_us_trame);
+
+	histogram_add(&histograms[LATENCY_APPLY], apply_us);
+
+	if(avec_temps){
+
+		histogram_add(&histograms[LATENCY_TOTAL], transit_us + apply_us);
+	}
+}
+
+
+bool latency_command(const char* ligne, uint8_t longueur){
+
+	if((longueur != 3) || (ligne[0] != '?')){
+
+		return FALSE;
+	}
+
+	switch(ligne[1]){
+	case 'L':
+
+		latency_report(UART_0);
+		break;
+
+	case 'R':
+
+		latency_reset();
+		break;
+
+	default:
+
+		// Les autres commandes de 3 octets (?A, ?B...) restent aux suivantes
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+void latency_report(uart_e port){
+
+	char ligne[64];		/* histogramme: 57 octets au plus, \0 compris */
+
+	for(uint8_t i = 0; i < LATENCY_NB; i++){
+
+		const histogram_t* h = &histograms[i];
+
+		snprintf(ligne, sizeof(ligne), "%s n=%u p50=%lu p99=%lu max=%lu\n", noms[i], h->count,
+			(unsigned long)histogram_percentile(h, 50), (unsigned long)histogram_percentile(h, 99),
+			(unsigned long)h->max);
+		uart_put_string(port, ligne);
+	}
+
+	sprintf(ligne, "trames=%u perdues=%u sans_num=%u\n", nb_trames, nb_perdues, nb_sans_numero);
+	uart_put_string(port, ligne);
+}
+
+
+void latency_reset(void){
+
+	for(uint8_t i = 0; i < LATENCY_NB; i++){
+
+		for(uint8_t k = 0; k < LATENCY_NB_BUCKETS; k++){
+
+			histograms[i].buckets[k] = 0;
+		}
+
+		histograms[i].count = 0;
+		histograms[i].max = 0;
+	}
+
+	nb_trames = 0;
+	nb_perdues = 0;
+	nb_sans_numero = 0;
+	premier = TRUE;
+	en_attente = FALSE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void histogram_add(histogram_t* h, uint32_t value){
+
+	uint8_t k = 0;
+
+	// Classe = nombre de bits significatifs de la valeur
+	while((value >> k) != 0 && k < LATENCY_NB_BUCKETS - 1){
+
+		k++;
+	}
+
+	if(h->buckets[k] != 0xFFFF){
+
+		h->buckets[k]++;
+	}
+
+	if(h->count != 0xFFFF){
+
+		h->count++;
+	}
+
+	if(value > h->max){
+
+		h->max = value;
+	}
+}
+
+
+/* Borne haute de la classe qui contient le centile, limitée au maximum observé */
+static uint32_t histogram_percentile(const histogram_t* h, uint8_t percent){
+
+	uint32_t rang = ((uint32_t)h->count * percent + 99) / 100;
+	uint32_t cumul = 0;
+
+	if(h->count == 0){
+
+		return 0;
+	}
+
+	for(uint8_t k = 0; k < LATENCY_NB_BUCKETS; k++){
+
+		cumul += h->buckets[k];
+
+		if(cumul >= rang){
+
+			uint32_t borne = (k == 0) ? 0 : ((1UL << k) - 1);
+
+			return (borne < h->max) ? borne : h->max;
+		}
+	}
+
+	return h->max;
+}
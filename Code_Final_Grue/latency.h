@@ -0,0 +1,123 @@
+#ifndef LATENCY_H_INCLUDED
+#define LATENCY_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file latency.h
+	\brief Latence entre la lecture d'une commande sur la manette et son application
+	sur les moteurs de la grue
+
+	Pour chaque trame, trois durées sont mesurées, en µs:
+
+	- LATENCY_TRANSIT: de la lecture des commandes sur la manette (temps de la trame)
+	  à la réception du '\n' par la grue, moins le plus petit délai observé.
+	- LATENCY_APPLY: de la réception du '\n' à la fin des consignes des moteurs.
+	- LATENCY_TOTAL: la somme des deux.
+
+	Les horloges des deux cartes ne sont pas synchronisées: le transit mesuré est le
+	délai au-dessus du meilleur délai récent. Ce plancher (au moins l'envoi des
+	TRAME_LONGUEUR octets, soit 9,4 ms à 9600 bauds, plus le minimum de la radio)
+	n'est pas observable. Il suit lentement une dérive entre les deux horloges
+	(jusqu'à LATENCY_DERIVE_PPM).
+
+	Chaque durée est accumulée dans un histogramme à classes logarithmiques: la classe
+	k compte les durées de 2^(k-1) à 2^k - 1 µs. Les centiles rapportés sont la borne
+	haute de leur classe (au pire 2 fois la vraie valeur), le maximum est exact.
+
+	Les numéros de trame donnent aussi le nombre de trames perdues.
+
+	Commandes reçues sur UART_0, à la place d'une trame:
+
+		?L	envoie le rapport sur UART_0
+		?R	remet les mesures à zéro
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Classes des histogrammes: la dernière reçoit tout ce qui dépasse 2^18 µs (262 ms) */
+#define LATENCY_NB_BUCKETS		20
+
+/* Dérive maximale suivie entre les horloges des deux cartes */
+#define LATENCY_DERIVE_PPM		2500
+
+typedef enum{
+
+	LATENCY_TRANSIT = 0,
+	LATENCY_APPLY,
+	LATENCY_TOTAL,
+	LATENCY_NB
+
+}latency_e;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Note la réception d'une trame
+	\param[in]	trame La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+	\param[in]	rx_us L'instant de réception du '\n' (timebase_micros())
+    \return rien.
+*/
+void latency_frame(const char* trame, uint8_t longueur, uint32_t rx_us);
+
+/**
+    \brief Note l'application des consignes de la dernière trame
+    \return rien.
+
+	À appeler une fois les consignes des moteurs et de la pince données.
+*/
+void latency_applied(void);
+
+/**
+    \brief Traite une commande ?L ou ?R
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était une commande, FALSE si c'est une trame
+*/
+bool latency_command(const char* ligne, uint8_t longueur);
+
+/**
+    \brief Envoie le rapport des latences
+	\param[in]	port Le port où écrire
+    \return rien.
+
+	Une ligne par histogramme (nombre, p50, p99, max en µs), puis le nombre de trames
+	reçues, perdues et sans numéro. Le rapport tient dans le tampon d'envoi de UART_0.
+*/
+void latency_report(uart_e port);
+
+/**
+    \brief Remet les histogrammes et les compteurs à zéro
+    \return rien.
+*/
+void latency_reset(void);
+
+#endif /* LATENCY_H_INCLUDED */
@@ -12,29 +12,68 @@
 #include "lcd.h"
 #include "uart.h"
 #include "driver.h"
+#include "servo.h"
+#include "motor.h"
+#include "timebase.h"
+#include "soft_timer.h"
+#include "bench.h"
+#include "profile.h"
+#include "latency.h"
+#include "trame.h"
+#include "blackbox.h"
+#include "stack.h"
+#include "idle.h"
+#include "battery.h"
+#include "teach.h"
+#include "command.h"
+#include "automation.h"
+#include "shaper.h"
+#include "kinematics.h"
+#include "pid.h"
+#include "autotune.h"
+#include "homing.h"
+#include "boot.h"
+#include "bus.h"
+#include <avr/wdt.h>
 #include <avr/interrupt.h>
 
 //Definir les constantes
 #define HORAIRE 1
 #define ANTIHORAIRE 0
 
+//Vitesse de la pince (largeur d'impulsion du servomoteur en us, voir command.h)
+#define PINCE_PAS_US 20		//variation max par trame de 20 ms (1000 us en 1 s)
+
+//Affichage du TIME OVER: message pendant 2 s, cran vide pendant 1 s
+#define TIME_OVER_AFFICHE_MS 2000
+#define TIME_OVER_EFFACE_MS 1000
+
+typedef enum{
+	TIME_OVER_AUCUN = 0,	//affichage normal de l'automation
+	TIME_OVER_AFFICHE,		//message TIME OVER  l'cran
+	TIME_OVER_EFFACE		//cran vide avant de reprendre l'affichage normal
+}time_over_e;
+
 //Ajouter les variables globales
 volatile uint8_t clics=0;
 volatile uint16_t degree;
 volatile uint8_t dir=HORAIRE;
-volatile uint16_t msec=0;
-volatile uint8_t sec=0;
 bool broche_state;
 
 char str[40];
 char str2[40];
 char msg3[40];
 char msg4[40];
+char batt[8];
+time_over_e time_over = TIME_OVER_AUCUN;
+soft_timer_t time_over_timer;
 
 
 // fct d'interruption sur INT0
 ISR(INT0_vect) {
 
+	PROFILE_BEGIN(PROFILE_ZONE_ISR_INT0);
+
 	if (read_bit(PIND, PD3)){
 		dir=HORAIRE;
 		clics++;
@@ -52,35 +91,64 @@ ISR(INT0_vect) {
 	clics = 0;
 	
 	degree=clics*360/24;
+	autotune_edge(clics);
 	
+	PROFILE_END(PROFILE_ZONE_ISR_INT0);
 }
 
-ISR (TIMER1_OVF_vect){
-	msec++;
-	if (msec>=1000){
-		msec=0;
-		sec++;
-	}
+// tick de 1 ms sur la comparaison B du compteur 1
+ISR (TIMER1_COMPB_vect){
+	PROFILE_BEGIN(PROFILE_ZONE_ISR_TICK);
+	OCR1B += PWM1_TICK_PAS;
+	motor_tick();
+	timebase_tick();
+	PROFILE_END(PROFILE_ZONE_ISR_TICK);
+}
 
+// fin d'une tape de l'affichage du TIME OVER (contexte du programme principal)
+static void time_over_cb(void* arg){
+	
+	if (time_over == TIME_OVER_AFFICHE){
+		lcd_clear_display();
+		lcd_set_cursor_position(15,1);
+		time_over = TIME_OVER_EFFACE;
+		soft_timer_start(&time_over_timer, TIME_OVER_EFFACE_MS, 0);
+	}
+	
+	else {
+		time_over = TIME_OVER_AUCUN;
+	}
 }
 
 int main(void)
 {
 	char msg[40];
-	char msg2[40];
-	char msg5[40];
+	
+	// Moteurs  l'arrt avant tout le reste, puis base de temps et rception des commandes (voir boot.h)
+	motor_init();
+	pwm1_init();
+	sei();
+	
+	uart_init(UART_0);
+	bus_init();
+	boot_mark(BOOT_UART);
+	
+	// Bote noire: la copie du tampon aprs une panne se fait en arrire-plan (voir blackbox.h)
+	blackbox_init();
 	
 	// Mettre la broche du bouton du joystick en entre
 	DDRD = clear_bit(DDRD, PD2);
 	DDRD = clear_bit(DDRD, PD3);
 	DDRA = clear_bit(DDRA, PA0);
 	DDRA = clear_bit(DDRA, PA1);
+	DDRA = clear_bit(DDRA, PA2);
 	
 	// On doit activer la "pull-up" interne de la broche pour PD3
 	PORTD = set_bit(PORTD, PD2);
 	PORTD = set_bit(PORTD, PD3);
 	PORTA = set_bit(PORTA, PA0);
 	PORTA = set_bit(PORTA, PA1);
+	PORTA = set_bit(PORTA, PA2);	//repre de la flche (voir homing.h)
 	
 	// Activer les interruptions
 	EIMSK = set_bit(EIMSK, INT0);
@@ -89,15 +157,8 @@ int main(void)
 	EICRA = set_bit(EICRA, ISC01);
 	EICRA = clear_bit(EICRA, ISC00);
 	
-	// Activation gnrale des interruptions
-	sei();
-	
-	// Faire l'initialisation du LCD
-	lcd_init();
-	uart_init(UART_0);
-	
-	// Mettre les bits 0,1,2,3,4,5 du port des DELs en sortie
-	DDRB = set_bits(DDRB, 0b00000100);
+	// Initialisation du LCD en arrire-plan: lcd_process() dans la boucle
+	lcd_begin();
 	
 	//Initialiser les diffrentes variables lies aux moteurs
 	uint8_t x=0;
@@ -107,255 +168,244 @@ int main(void)
 	uint8_t a=0;
 	bool l1;
 	bool l2;
-	uint8_t v;
 	
 	//Initialisation des entres et des broches
 	adc_init();
-	pwm0_init();
-	pwm1_init(1000);
-	pwm1_set_PD4(20000);	//reset WIFI prevention
-	pwm2_init();
+	kinematics_init();
+	pid_init();
+	servo_init(COMMAND_PINCE_OUVERTE_US);
+	servo_set_slew(PINCE_PAS_US);
+	battery_init();
+	DDRD = set_bit(DDRD, PD4);
+	PORTD = set_bit(PORTD, PD4);	//reset WIFI prevention (niveau haut permanent)
 	
 	uint8_t temps;
+	uint32_t debut_automation = timebase_millis();	//instant du passage en mode automatique
+	soft_timer_init(&time_over_timer, time_over_cb, NULL);
+	PROFILE_INIT();
+	uint8_t fins_course = 0xFF;	//dernier tat des fins de course not
+	uint8_t etape = 0;			//dernire quille note par l'automation
+	
+	// Chien de garde: un blocage de la boucle redmarre la grue (voir blackbox.h)
+	wdt_enable(WDTO_250MS);
 	x=137;
 	y=140;
 	g=100;
 	
+	//Recherche du zro de la flche et du chariot avant toute commande (voir homing.h)
+	homing_start();
+	
     while (1) 
     {
+		BENCH_MARK(BENCH_MARK_LOOP);
+		PROFILE_COUNT(PROFILE_COUNTER_LOOP);
+		wdt_reset();
+		
+		//Minuteries de l'affichage, criture de la session apprise
+		soft_timer_process();
+		teach_process();
+		
+		if (!lcd_is_ready() && lcd_process()){
+			boot_mark(BOOT_LCD);
+		}
+		
+		//Recherche du zro: la flche sur son repre remet l'encodeur  0
+		if (homing_process(!read_bit(PINA, PA2), !read_bit(PINA, PA0))){
+			cli();
+			clics = 0;
+			degree = 0;
+			sei();
+		}
+		
+		//Position estime de la flche et du chariot: encodeur et fins de course (voir kinematics.h)
+		kinematics_update(clics, !read_bit(PINA, PA0), !read_bit(PINA, PA1));
+		
+		//Rejeu d'une session apprise: remplace les trames de la manette (voir teach.h)
+		bool rejeu = teach_replay(&x, &y, &g, &p, clics);
+		
 		//Conditions Moteur en X
-		if(uart_rx_buffer_nb_line(UART_0)){
+		if(rejeu || uart_rx_buffer_nb_line(UART_0)){
 			
-			uart_get_line(UART_0, msg, 40);
-			y = msg[0];
-			x = msg[1];
-			g = msg[2];
-			p = msg[3];
-			a = msg[4];
+			uint8_t a_prec = a;
+			PROFILE_BEGIN(PROFILE_ZONE_FRAME);
 			
-			if(x == 137){
+			if (rejeu){
+				a = 0;
+			}
+			
+			else {
+				uint8_t longueur = uart_get_line(UART_0, msg, 40);
+				BENCH_MARK(BENCH_MARK_FRAME);
+				
+				//Commandes de mesure: latence (?L, ?R), bote noire (?B), mmoire (?M), nergie (?E), batterie (?V)
+				//Apprentissage et rejeu (?T, ?S, ?P), mise en forme contre le balancement (?H), dplacement vers un point (?G)
+				//Rglage de la boucle de la flche (?A), recherche du zro (?Z), temps de dmarrage (?D), adresse sur le bus (?N)
+				if (latency_command(msg, longueur) || blackbox_command(msg, longueur) ||
+					stack_command(msg, longueur) || idle_command(msg, longueur) ||
+					battery_command(msg, longueur) || teach_command(msg, longueur) ||
+					shaper_command(msg, longueur) || automation_command(msg, longueur) ||
+					autotune_command(msg, longueur) || homing_command(msg, longueur) ||
+					boot_command(msg, longueur) || bus_command(msg, longueur)){
+					boot_mark(BOOT_COMMANDE);
+					PROFILE_END(PROFILE_ZONE_FRAME);
+					continue;
+				}
+				
+				//Ligne tronque, trop longue ou commande inconnue: ignore (voir command.h)
+				command_frame_t trame;
+				if (command_parse(msg, longueur, &trame) != COMMAND_FRAME){
+					PROFILE_END(PROFILE_ZONE_FRAME);
+					continue;
+				}
+				
+				PROFILE_COUNT(PROFILE_COUNTER_FRAME);
+				boot_mark(BOOT_COMMANDE);
+				latency_frame(msg, longueur, uart_get_eol_time(UART_0));
+				blackbox_log(BLACKBOX_EVENT_FRAME, trame.has_seq ? trame.seq : 0xFF);
+				bus_frame();
 				
-				pwm0_set_PB4(0);
-				sprintf(msg,"-> x: %d", x);
+				//Pendant le rejeu, la trame de la manette est ignore
+				if (teach_get_state() != TEACH_REPLAYING){
+					y = trame.y;
+					x = trame.x;
+					g = trame.g;
+					p = trame.p;
+					a = trame.a;
+					teach_record(x, y, g, p, clics);
+				}
 			}
+			PROFILE_END(PROFILE_ZONE_FRAME);
 			
-			else if (x >= 0 && x < 135){
-				v = -2*x + 255;
-				pwm0_set_PB4(v);
-				PORTB = set_bit(PORTB,PB2);
+			if (a != a_prec){
+				PROFILE_EVENT(PROFILE_EVENT_MODE, a);
+				blackbox_log(BLACKBOX_EVENT_MODE, a);
+				
+				//Sortie du mode automatique: la manette reprend les moteurs arrts
+				if (a_prec == 1){
+					automation_stop();
+				}
 			}
 			
-			else if(x >= 140 && x <= 255){
-				pwm0_set_PB4(x);
-				PORTB = clear_bit(PORTB,PB2);
+			PROFILE_BEGIN(PROFILE_ZONE_MOTOR);
+			
+			//Moteurs et pince: pendant la recherche du zro, la manette ne commande que la pince
+			if (homing_is_busy()){
+				command_apply_gripper(p);
 			}
-		
-		
-		//Conditions Moteur en Y
-			if(y == 140) {
-				pwm0_set_PB3(0);
+			
+			//En mode automatique, le plan commande les moteurs (automation.h)
+			else if (a == TRAME_MODE_AUTO){
+				command_apply_gripper(p);
 			}
 			
-			else if (y >= 0 && y < 130){
-				v = -2*y + 255;
-				pwm0_set_PB3(v);
-				PORTB = set_bit(PORTB,PB1);
+			//Mode cartsien: le joystick dplace la charge en X et Y (voir kinematics.h)
+			else if (a == TRAME_MODE_CARTESIEN){
+				command_apply_cartesian(x, y, g, p);
 			}
 			
-			else if(y > 145 && y <= 255){
-				pwm0_set_PB3(y);
-				PORTB = clear_bit(PORTB,PB1);
+			else {
+				command_apply(x, y, g, p);
 			}
-	
-	
-	//Conditions Moteur Glissire
-		if(g > 50 && g < 205 ){
-			pwm2_set_PD6(0);
-		}
-		
-		else if (g > 205 && g <= 255){
-			pwm2_set_PD6(g);
-			PORTB = set_bit(PORTB,PB0);
-		}
-		
-		else if(g >= 0 && g <= 50){
-			v = -2*g + 255;
-			pwm2_set_PD6(v);
-			PORTB = clear_bit(PORTB,PB0);
-		}
-	
-	//Conditions Pince	
-		if(p == 1){
-			pwm1_set_PD5(1000);
-		}
-		
-		else if (p == 0){
-			pwm1_set_PD5(5000);
-		}
+			
+		PROFILE_END(PROFILE_ZONE_MOTOR);
+		latency_applied();
 		
 	//Conditions Limit Switch
 		l1 = read_bit(PINA, PA0);
 		l2 = read_bit(PINA, PA1);
 		
-		//Test batterie morte
-		/*pwm0_set_PB3(0);
-		pwm0_set_PB4(0);
-		pwm2_set_PD6(0);
-		a=1;
-		*/
+		if ((l1 | (l2 << 1)) != fins_course){
+			fins_course = l1 | (l2 << 1);
+			blackbox_log(BLACKBOX_EVENT_LIMIT, fins_course);
+		}
+		
+		//Batterie: compensation, limites et arrt des moteurs faits par battery.c
+		battery_format(batt);
 		
 	//Programme Automation
 		broche_state = read_bit(PINA, PA3);
-		uint8_t val=0;
 		
 		if (a == 1){
-			//Affichage LCD Automation
-			lcd_clear_display();
-			sprintf(msg3, "l1:%d,l2:%d,t:%d:%d",l1, l2, sec, msec);
-			lcd_set_cursor_position(0,0);
-			lcd_write_string(msg3);
+			//Temps coul depuis le dbut de l'automation
+			uint32_t ecoule = timebase_elapsed_ms(debut_automation);
+			uint16_t sec = ecoule / 1000;
+			uint16_t msec = ecoule % 1000;
 			
-			//Affichage LCD Angle et Direction
-			sprintf(msg4, "Angle=%3d, Dir=%d", degree, dir);
-			lcd_set_cursor_position(0,1);
-			lcd_write_string(msg4);
+			//Affichage LCD Automation (sauf pendant le TIME OVER)
+			if (time_over == TIME_OVER_AUCUN){
+				lcd_clear_display();
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(msg3, "l1:%d,l2:%d,t:%u:%u",l1, l2, sec, msec));
+				lcd_set_cursor_position(0,0);
+				lcd_write_string(msg3);
+				
+				//Affichage LCD Angle, Direction et Batterie
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(msg4, "A=%3d D=%d %s", degree, dir, batt));
+				lcd_set_cursor_position(0,1);
+				lcd_write_string(msg4);
+			}
 			
-			//Affichage TIME OVER
-			if (sec > 120){
+			//Affichage TIME OVER, sans bloquer l'automation
+			if (sec > 120 && time_over == TIME_OVER_AUCUN){
 				lcd_clear_display();
-				sprintf(msg3, "TIME", sec, msec);
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(msg3, "TIME"));
 				lcd_set_cursor_position(6,0);
 				lcd_write_string(msg3);
 				
-				sprintf(msg4, "OVER!!", sec, msec);
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(msg4, "OVER!!"));
 				lcd_set_cursor_position(5,1);
 				lcd_write_string(msg4);
 				
-				
-				_delay_ms(2000);
-				lcd_clear_display();
-				lcd_set_cursor_position(15,1);
-				_delay_ms(1000);
+				time_over = TIME_OVER_AFFICHE;
+				PROFILE_EVENT(PROFILE_EVENT_TIME_OVER, sec);
+				blackbox_log(BLACKBOX_EVENT_TIME_OVER, sec);
+				soft_timer_start(&time_over_timer, TIME_OVER_AFFICHE_MS, 0);
 			}
-			
-			
-			//Algorithme Automatique
-			
-				//quille #1
-				if (degree >= 0 && degree < 10){
-					//fleche
-					if (sec >= 0 && sec < 2)
-					pwm0_set_PB3(200);
-					if (sec == 5)
-					pwm0_set_PB3(0);
-				}
-				
-				//quille #2
-				if (degree >= 10 && degree <= 65){
-					//chariot
-					if (sec >= 3 && sec < 10)
-					pwm0_set_PB4(200);
-					if (sec == 7)
-					pwm0_set_PB4(0);
-					
-					//fleche
-					if (sec >= 10 && sec < 15)
-					pwm0_set_PB3(200);
-					if (sec == 15)
-					pwm0_set_PB3(0);
-				}
-				
-				//quille #3
-				if (degree >= 65 && degree <= 120){
-					//chariot
-					if (sec >= 15 && sec < 22)
-					pwm0_set_PB4(200);
-					if (sec == 22)
-					pwm0_set_PB4(0);
-					PORTB = clear_bit(PORTB,PB2);
-					
-					//fleche
-					if (sec >= 22 && sec < 25)
-					pwm0_set_PB3(200);
-					if (sec == 25)
-					pwm0_set_PB3(0);
-				}
-				
-				//quille #4
-				if (degree >= 120 && degree <= 185){
-					//chariot
-					if (sec >= 25 && sec < 32 )
-					pwm0_set_PB4(200);
-					if (sec == 32)
-					pwm0_set_PB4(0);
-					PORTB = set_bit(PORTB,PB2);
-					
-					//fleche
-					if (sec >= 32 && sec < 35)
-					pwm0_set_PB3(200);
-					if (sec == 35)
-					pwm0_set_PB3(0);
-				}
-				
-				//quille #5
-				if (degree >= 185 && degree <= 245){
-					//chariot
-					if (sec >= 35 && sec < 42)
-					pwm0_set_PB4(200);
-					if (sec == 42)
-					pwm0_set_PB4(0);
-					PORTB = clear_bit(PORTB,PB2);
-					
-					//fleche
-					if (sec >= 42 && sec < 45)
-					pwm0_set_PB3(200);
-					if (sec == 45)
-					pwm0_set_PB3(0);
-				}
-				
-				//quille #6
-				if (degree >= 245 && degree <= 305){
-					//chariot
-					if (sec >= 45 && sec < 52 )
-					pwm0_set_PB4(200);
-					if (sec == 52)
-					pwm0_set_PB4(0);
-					PORTB = set_bit(PORTB,PB2);
-					
-					//fleche
-					if (sec >= 52 && sec < 55)
-					pwm0_set_PB3(200);
-					if (sec == 55)
-					pwm0_set_PB3(0);
-				}
-				
-				//point final
-				if (degree >= 305 && degree <= 330){
-					//fleche
-					if (sec >= 55 && sec < 58)
-					pwm0_set_PB3(200);
-					if (sec > 58)
-					pwm0_set_PB3(0);
-				}
 		}
 		
 			else {
-				msec=0;
-				sec=0;
+				debut_automation = timebase_millis();
+				soft_timer_stop(&time_over_timer);
+				time_over = TIME_OVER_AUCUN;
+				etape = 0;
+				automation_start();
 				//Affichage LCD Moteur x, y	
 				lcd_clear_display();
-				sprintf(str,"x: %3d, y: %3d", x, y);
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(str,"x: %3d, y: %3d", x, y));
 				lcd_set_cursor_position(0,0);
 				lcd_write_string(str);
 			
-				//Affichage LCD Glissire, Pince
+				//Affichage LCD Glissire, Angle et Batterie
 				temps = temps + 1/100;
-				sprintf(str2, "g: %3d, a: %d", g, degree);
+				PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(str2, "g:%3d a:%3d %s", g, degree, batt));
 				lcd_set_cursor_position(0,1);
 				lcd_write_string(str2);
 			}
 	
-		}	
+		}
+		
+		//Automation: le plan avance  chaque passage (au moins au tick de 1 ms), pas seulement aux trames
+		if (a == 1){
+			//Sans zro, le plan attend: son temps part de la fin de la recherche
+			if (!homing_is_done()){
+				debut_automation = timebase_millis();
+			}
+			
+			uint8_t quille = automation_process(timebase_elapsed_ms(debut_automation));
+			
+			if (quille != etape){
+				etape = quille;
+				blackbox_log(BLACKBOX_EVENT_STEP, etape);
+			}
+			
+			autotune_process();
+		}
+		
+		//Veille jusqu' la prochaine interruption: trame reue ou tick de 1 ms
+		cli();
+		if (!uart_rx_buffer_nb_line(UART_0)){
+			idle_sleep(SLEEP_MODE_IDLE);
+		}
+		sei();
 	}
 }
 
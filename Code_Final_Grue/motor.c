@@ -0,0 +1,531 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file motor.c
+	\brief Sorties des trois moteurs à courant continu de la grue (sens + MLI)
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "motor.h"
+#include "blackbox.h"
+#include "boot.h"
+#include "shaper.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+_Static_assert(MOTOR_FLECHE_FREQUENCY == MOTOR_CHARIOT_FREQUENCY,
+	"La flèche et le chariot partagent le compteur 0 et doivent avoir la même fréquence");
+
+_Static_assert((MOTOR_DEADTIME_MS >= 1) && (MOTOR_DEADTIME_MS <= 255),
+	"MOTOR_DEADTIME_MS doit être entre 1 et 255");
+
+_Static_assert((PWM_FREQUENCY_HZ(MOTOR_FLECHE_FREQUENCY) >= MOTOR_MLI_MIN_HZ) && (PWM_FREQUENCY_HZ(MOTOR_FLECHE_FREQUENCY) <= MOTOR_MLI_MAX_HZ),
+	"Aucun réglage du compteur 0 ne tombe entre MOTOR_MLI_MIN_HZ et MOTOR_MLI_MAX_HZ à F_CPU");
+
+_Static_assert((PWM_FREQUENCY_HZ(MOTOR_GLISSIERE_FREQUENCY) >= MOTOR_MLI_MIN_HZ) && (PWM_FREQUENCY_HZ(MOTOR_GLISSIERE_FREQUENCY) <= MOTOR_MLI_MAX_HZ),
+	"Aucun réglage du compteur 2 ne tombe entre MOTOR_MLI_MIN_HZ et MOTOR_MLI_MAX_HZ à F_CPU");
+
+_Static_assert(PWM_FREQUENCY_HZ(MOTOR_FLECHE_FREQUENCY) * MOTOR_DEADTIME_MS > 1000UL,
+	"La période MLI doit rester plus courte que le temps mort");
+
+typedef enum{
+
+	STATE_RUN = 0,		/* la sortie suit la consigne */
+	STATE_DEADTIME,		/* sortie coupée, on attend avant de changer de sens */
+	STATE_BRAKE			/* contre-courant en cours */
+
+}state_e;
+
+
+typedef struct{
+
+	void (*set_duty)(uint8_t duty);
+	void (*connect)(bool connect);
+	uint8_t dir_pin;		/* broche de direction sur le PORTB */
+	uint8_t brake_duty;		/* rapport cyclique du contre-courant */
+	uint8_t brake_ms;		/* durée du contre-courant après un arrêt à 255 */
+
+}motor_config_t;
+
+
+typedef struct{
+
+	uint8_t duty;			/* rapport cyclique appliqué */
+	bool dir;				/* direction appliquée */
+	uint8_t target_duty;	/* consigne, après la mise en forme (shaper.h) */
+	bool target_dir;		/* consigne, après la mise en forme */
+	uint8_t input_duty;		/* consigne demandée */
+	bool input_dir;			/* consigne demandée */
+	motor_stop_e stop_mode;	/* mode d'arrêt par défaut */
+	motor_stop_e next_stop;	/* mode du prochain arrêt (motor_stop() peut le remplacer) */
+	state_e state;
+	uint8_t timer_ms;		/* temps restant dans STATE_DEADTIME ou STATE_BRAKE */
+	uint8_t brake_ms;		/* contre-courant à faire à la fin du temps mort (0 = aucun) */
+	uint8_t off_ms;			/* temps depuis que la sortie est coupée (sature à 255) */
+
+}motor_state_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static const motor_config_t config[MOTOR_NB] = {
+
+	/* MOTOR_FLECHE */		{pwm0_set_PB3, pwm0_connect_PB3, PB1, 128, 100},
+	/* MOTOR_CHARIOT */		{pwm0_set_PB4, pwm0_connect_PB4, PB2, 128, 100},
+	/* MOTOR_GLISSIERE */	{pwm2_set_PD6, pwm2_connect_PD6, PB0, 128, 100},
+};
+
+static volatile motor_state_t state[MOTOR_NB];
+
+static volatile uint16_t gain = MOTOR_GAIN_ONE;
+static volatile uint8_t limit[MOTOR_NB];
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void set_target(motor_e motor, bool dir, uint8_t duty);
+static void apply_shaped(motor_e motor, int16_t consigne);
+static void update(motor_e motor);
+static uint8_t output_duty(motor_e motor);
+static uint8_t brake_duty(motor_e motor);
+static void output_off(motor_e motor);
+static void output_on(motor_e motor, uint8_t duty);
+static void write_dir(motor_e motor, bool dir);
+static void start_deadtime(motor_e motor, uint8_t ms);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void motor_init(void){
+
+	pwm0_init();
+	pwm2_init();
+
+	pwm0_set_frequency(MOTOR_FLECHE_FREQUENCY);
+	pwm2_set_frequency(MOTOR_GLISSIERE_FREQUENCY);
+
+	shaper_init();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+			DDRB = set_bit(DDRB, config[i].dir_pin);
+
+			state[i].target_duty = 0;
+			state[i].target_dir = FALSE;
+			state[i].input_duty = 0;
+			state[i].input_dir = FALSE;
+			state[i].stop_mode = MOTOR_STOP_COAST;
+			state[i].next_stop = MOTOR_STOP_COAST;
+			state[i].state = STATE_RUN;
+			state[i].brake_ms = 0;
+			limit[i] = 255;
+
+			output_off(i);
+			write_dir(i, FALSE);
+			state[i].off_ms = 255;
+		}
+	}
+}
+
+
+void motor_set(motor_e motor, bool dir, uint8_t duty){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		set_target(motor, dir, duty);
+	}
+}
+
+
+void motor_set_duty(motor_e motor, uint8_t duty){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		set_target(motor, state[motor].input_dir, duty);
+	}
+}
+
+
+void motor_set_dir(motor_e motor, bool dir){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		set_target(motor, dir, state[motor].input_duty);
+	}
+}
+
+
+void motor_stop(motor_e motor, motor_stop_e mode){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		// Arrêt tout de suite, sans la mise en forme
+		if(motor < SHAPER_NB){
+
+			shaper_reset(motor, 0);
+		}
+
+		state[motor].next_stop = mode;
+		state[motor].input_duty = 0;
+		state[motor].target_duty = 0;
+		update(motor);
+	}
+}
+
+
+void motor_set_stop_mode(motor_e motor, motor_stop_e mode){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		state[motor].stop_mode = mode;
+		state[motor].next_stop = mode;
+	}
+}
+
+
+void motor_set_gain(uint16_t new_gain){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		gain = new_gain;
+
+		for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+			update(i);
+		}
+	}
+}
+
+
+void motor_set_limit(motor_e motor, uint8_t max){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		limit[motor] = max;
+		update(motor);
+	}
+}
+
+
+uint8_t motor_get_duty(motor_e motor){
+
+	return state[motor].duty;
+}
+
+
+bool motor_get_dir(motor_e motor){
+
+	return state[motor].dir;
+}
+
+
+void motor_tick(void){
+
+	// Sortie de la mise en forme de la flèche et du chariot
+	shaper_tick();
+
+	for(uint8_t i = 0; i < SHAPER_NB; i++){
+
+		int16_t consigne;
+
+		if(shaper_output(i, &consigne)){
+
+			apply_shaped(i, consigne);
+		}
+	}
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		volatile motor_state_t* s = &state[i];
+
+		switch(s->state){
+		case STATE_RUN:
+
+			if((s->duty == 0) && (s->off_ms < 255)){
+
+				s->off_ms++;
+			}
+			break;
+
+		case STATE_DEADTIME:
+
+			if(--s->timer_ms == 0){
+
+				// Une limite de 0 (batterie vide) remplace le contre-courant par la roue libre
+				if((s->brake_ms > 0) && (brake_duty(i) > 0)){
+
+					// Contre-courant: sens inverse du dernier mouvement
+					write_dir(i, !s->dir);
+					output_on(i, brake_duty(i));
+					s->timer_ms = s->brake_ms;
+					s->brake_ms = 0;
+					s->state = STATE_BRAKE;
+				}
+
+				else{
+
+					s->brake_ms = 0;
+					s->state = STATE_RUN;
+					s->off_ms = 255;
+					update(i);
+				}
+			}
+			break;
+
+		case STATE_BRAKE:
+
+			if(--s->timer_ms == 0){
+
+				output_off(i);
+				start_deadtime(i, MOTOR_DEADTIME_MS);
+			}
+			break;
+		}
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Static functions
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Nouvelle consigne demandée (appelée les interruptions désactivées)
+*/
+static void set_target(motor_e motor, bool dir, uint8_t duty){
+
+	volatile motor_state_t* s = &state[motor];
+
+	s->input_dir = dir;
+	s->input_duty = duty;
+
+	if(motor < SHAPER_NB){
+
+		int16_t consigne;
+
+		// La première impulsion n'a pas de retard: sa part s'applique tout de suite
+		shaper_input(motor, dir ? -(int16_t)duty : duty);
+
+		if(shaper_output(motor, &consigne)){
+
+			apply_shaped(motor, consigne);
+		}
+		return;
+	}
+
+	s->target_dir = dir;
+	s->target_duty = duty;
+	update(motor);
+}
+
+
+/**
+    \brief Consigne signée sortie de la mise en forme (appelée les interruptions désactivées)
+*/
+static void apply_shaped(motor_e motor, int16_t consigne){
+
+	volatile motor_state_t* s = &state[motor];
+
+	// À 0, la direction reste celle du dernier mouvement
+	if(consigne != 0){
+
+		s->target_dir = (consigne < 0);
+	}
+
+	s->target_duty = (consigne < 0) ? -consigne : consigne;
+	update(motor);
+}
+
+
+/**
+    \brief Amène la sortie vers la consigne (appelée les interruptions désactivées)
+*/
+static void update(motor_e motor){
+
+	volatile motor_state_t* s = &state[motor];
+	uint8_t duty = output_duty(motor);
+	motor_stop_e mode;
+
+	switch(s->state){
+	case STATE_DEADTIME:
+
+		// Une nouvelle consigne de mouvement annule le freinage prévu. La consigne
+		// sera appliquée à la fin du temps mort.
+		if(duty > 0){
+
+			s->brake_ms = 0;
+		}
+		return;
+
+	case STATE_BRAKE:
+
+		// Nouvelle consigne, ou limite abaissée à 0 pendant le contre-courant
+		if((duty > 0) || (brake_duty(motor) == 0)){
+
+			output_off(motor);
+			start_deadtime(motor, MOTOR_DEADTIME_MS);
+		}
+
+		else if(brake_duty(motor) != s->duty){
+
+			output_on(motor, brake_duty(motor));
+		}
+		return;
+
+	case STATE_RUN:
+		break;
+	}
+
+	// Arrêt
+	if(duty == 0){
+
+		mode = s->next_stop;
+		s->next_stop = s->stop_mode;
+
+		if(s->duty > 0){
+
+			if((mode == MOTOR_STOP_BRAKE) && (config[motor].brake_ms > 0)){
+
+				s->brake_ms = ((uint16_t)config[motor].brake_ms * s->duty) / 255;
+
+				if(s->brake_ms == 0){
+
+					s->brake_ms = 1;
+				}
+
+				output_off(motor);
+				start_deadtime(motor, MOTOR_DEADTIME_MS);
+			}
+
+			else{
+
+				output_off(motor);
+			}
+		}
+		return;
+	}
+
+	// Changement de sens: la sortie doit être coupée depuis au moins le temps mort
+	if(s->target_dir != s->dir){
+
+		if(s->duty > 0){
+
+			output_off(motor);
+			s->brake_ms = 0;
+			start_deadtime(motor, MOTOR_DEADTIME_MS);
+			return;
+		}
+
+		if(s->off_ms < MOTOR_DEADTIME_MS){
+
+			s->brake_ms = 0;
+			start_deadtime(motor, MOTOR_DEADTIME_MS - s->off_ms);
+			return;
+		}
+
+		write_dir(motor, s->target_dir);
+	}
+
+	if(duty != s->duty){
+
+		output_on(motor, duty);
+	}
+}
+
+
+/**
+    \brief Rapport cyclique à appliquer: consigne, gain et limite de l'axe
+*/
+static uint8_t output_duty(motor_e motor){
+
+	uint16_t duty = ((uint32_t)state[motor].target_duty * gain) >> 8;
+
+	if(duty > limit[motor]){
+
+		duty = limit[motor];
+	}
+
+	return duty;
+}
+
+
+/**
+    \brief Rapport cyclique du contre-courant, plafonné par la limite de l'axe
+*/
+static uint8_t brake_duty(motor_e motor){
+
+	return (config[motor].brake_duty > limit[motor]) ? limit[motor] : config[motor].brake_duty;
+}
+
+
+static void output_off(motor_e motor){
+
+	// La broche tombe à 0 tout de suite; le 0 dans OCR sera chargé à la fin de la période
+	config[motor].connect(FALSE);
+	config[motor].set_duty(0);
+
+	state[motor].duty = 0;
+	state[motor].off_ms = 0;
+
+	blackbox_log(BLACKBOX_EVENT_PWM_FLECHE + motor, 0);
+}
+
+
+static void output_on(motor_e motor, uint8_t duty){
+
+	config[motor].set_duty(duty);
+
+	if(state[motor].duty == 0){
+
+		config[motor].connect(TRUE);
+		boot_mark(BOOT_MLI);
+	}
+
+	state[motor].duty = duty;
+
+	blackbox_log(BLACKBOX_EVENT_PWM_FLECHE + motor, duty);
+}
+
+
+static void write_dir(motor_e motor, bool dir){
+
+	PORTB = write_bit(PORTB, config[motor].dir_pin, dir ? 1 : 0);
+
+	state[motor].dir = dir;
+
+	blackbox_log(BLACKBOX_EVENT_DIR, (motor << 1) | (dir ? 1 : 0));
+}
+
+
+static void start_deadtime(motor_e motor, uint8_t ms){
+
+	state[motor].state = STATE_DEADTIME;
+	state[motor].timer_ms = ms;
+}
@@ -0,0 +1,212 @@
+#ifndef MOTOR_H_INCLUDED
+#define MOTOR_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file motor.h
+	\brief Sorties des trois moteurs à courant continu de la grue (sens + MLI)
+
+	Chaque axe est commandé par une broche MLI et une broche de direction sur le PORTB:
+
+		Axe          MLI           Direction
+		Flèche       PB3 (OC0A)    PB1
+		Chariot      PB4 (OC0B)    PB2
+		Glissière    PD6 (OC2B)    PB0
+
+	Le module garantit que la direction et le rapport cyclique changent ensemble: une
+	inversion de sens coupe d'abord la sortie MLI (la broche tombe à 0 immédiatement), attend
+	un temps mort de MOTOR_DEADTIME_MS, change la direction puis seulement rebranche la MLI.
+	Aucune impulsion de l'ancien rapport cyclique ne sort donc dans le nouveau sens.
+
+	L'arrêt (rapport cyclique de 0) se fait en roue libre ou en freinage. Le pont en H
+	n'a que les entrées MLI et direction, le freinage est donc fait par contre-courant:
+	une impulsion en sens inverse dont la durée est proportionnelle au dernier rapport
+	cyclique, suivie de la roue libre.
+
+	Les consignes de la flèche et du chariot passent d'abord par la mise en forme contre
+	le balancement de la charge (shaper.h): un échelon demandé est appliqué en deux ou
+	trois marches, la dernière une période du pendule plus tard.
+
+	Le rapport cyclique appliqué est la consigne multipliée par un gain commun (la
+	compensation de la tension de la batterie, voir battery.h), puis plafonnée par la
+	limite de l'axe. Une limite de 0 arrête l'axe quelle que soit la consigne. Le
+	contre-courant est plafonné de même: avec une limite de 0, l'arrêt se fait en roue
+	libre.
+
+	Les temporisations sont avancées par motor_tick(), qui doit être appelée à chaque
+	milliseconde (interruption du tick du compteur 1).
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "driver.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Fréquences MLI permises pour les moteurs, en Hz
+
+	Au-dessus de MOTOR_MLI_MIN_HZ, le sifflement des moteurs ne s'entend presque plus;
+	au-delà de MOTOR_MLI_MAX_HZ, les pertes de commutation du pont en H chauffent. Chaque
+	axe prend le réglage le plus lent d'au moins MOTOR_MLI_MIN_HZ: 15,7 kHz à 8 MHz,
+	31,4 kHz à 16 MHz, 39,2 kHz à 20 MHz.
+*/
+#define MOTOR_MLI_MIN_HZ			15000UL
+#define MOTOR_MLI_MAX_HZ			40000UL
+
+/**
+    \brief Fréquence MLI de chaque axe
+
+	La flèche et le chariot partagent le compteur 0 et doivent avoir la même fréquence.
+	Les fréquences de division par 64 et plus ne sont pas offertes: la période MLI doit
+	rester plus courte que le temps mort pour que le rapport cyclique nul soit chargé
+	avant de rebrancher la sortie.
+*/
+#define MOTOR_FLECHE_FREQUENCY		PWM_FREQUENCY_MIN(MOTOR_MLI_MIN_HZ)
+#define MOTOR_CHARIOT_FREQUENCY		PWM_FREQUENCY_MIN(MOTOR_MLI_MIN_HZ)
+#define MOTOR_GLISSIERE_FREQUENCY	PWM_FREQUENCY_MIN(MOTOR_MLI_MIN_HZ)
+
+/**
+    \brief Temps mort lors d'une inversion de sens, en ms (de 1 à 255)
+*/
+#define MOTOR_DEADTIME_MS	2
+
+/**
+    \brief Gain unitaire de motor_set_gain() (virgule fixe, 8 bits de fraction)
+*/
+#define MOTOR_GAIN_ONE		256
+
+typedef enum{
+
+	MOTOR_FLECHE = 0,
+	MOTOR_CHARIOT,
+	MOTOR_GLISSIERE,
+
+	MOTOR_NB
+
+}motor_e;
+
+
+typedef enum{
+
+	MOTOR_STOP_COAST = 0,	/* roue libre: la MLI est coupée */
+	MOTOR_STOP_BRAKE		/* contre-courant puis roue libre */
+
+}motor_stop_e;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Initialise les compteurs 0 et 2 et les broches de direction
+    \return rien.
+
+	Tous les moteurs démarrent arrêtés, MLI débranchée.
+*/
+void motor_init(void);
+
+/**
+    \brief Fixe le sens et le rapport cyclique d'un axe en une seule opération
+	\param[in]	motor L'axe à commander
+	\param[in]	dir Le niveau de la broche de direction (TRUE = broche à 1)
+	\param[in]	duty Le rapport cyclique, entre 0 et 255. 0 arrête l'axe selon son mode d'arrêt.
+    \return rien.
+*/
+void motor_set(motor_e motor, bool dir, uint8_t duty);
+
+/**
+    \brief Change seulement le rapport cyclique d'un axe, dans le sens déjà demandé
+	\param[in]	motor L'axe à commander
+	\param[in]	duty Le rapport cyclique, entre 0 et 255
+    \return rien.
+*/
+void motor_set_duty(motor_e motor, uint8_t duty);
+
+/**
+    \brief Change seulement le sens d'un axe, au rapport cyclique déjà demandé
+	\param[in]	motor L'axe à commander
+	\param[in]	dir Le niveau de la broche de direction (TRUE = broche à 1)
+    \return rien.
+*/
+void motor_set_dir(motor_e motor, bool dir);
+
+/**
+    \brief Arrête un axe avec un mode d'arrêt précis
+	\param[in]	motor L'axe à arrêter
+	\param[in]	mode MOTOR_STOP_COAST ou MOTOR_STOP_BRAKE
+    \return rien.
+
+	L'arrêt est immédiat, sans la mise en forme.
+*/
+void motor_stop(motor_e motor, motor_stop_e mode);
+
+/**
+    \brief Choisit le mode d'arrêt utilisé quand le rapport cyclique demandé tombe à 0
+	\param[in]	motor L'axe visé
+	\param[in]	mode MOTOR_STOP_COAST (défaut) ou MOTOR_STOP_BRAKE
+    \return rien.
+*/
+void motor_set_stop_mode(motor_e motor, motor_stop_e mode);
+
+/**
+    \brief Change le gain appliqué à la consigne de tous les axes
+	\param[in]	gain Le gain, MOTOR_GAIN_ONE pour 1 (défaut)
+    \return rien.
+
+	Le produit est saturé à 255. Les axes en mouvement prennent le nouveau rapport
+	cyclique tout de suite.
+*/
+void motor_set_gain(uint16_t gain);
+
+/**
+    \brief Plafonne le rapport cyclique appliqué sur un axe
+	\param[in]	motor L'axe visé
+	\param[in]	max Le rapport cyclique maximal, 255 (défaut) pour aucune limite
+    \return rien.
+*/
+void motor_set_limit(motor_e motor, uint8_t max);
+
+/**
+    \brief Retourne le rapport cyclique présentement appliqué sur un axe
+    \return Le rapport cyclique (0 pendant un temps mort)
+*/
+uint8_t motor_get_duty(motor_e motor);
+
+/**
+    \brief Retourne le niveau présentement appliqué sur la broche de direction d'un axe
+    \return TRUE si la broche de direction est à 1
+*/
+bool motor_get_dir(motor_e motor);
+
+/**
+    \brief Avance les temps morts et les freinages en cours
+    \return rien.
+
+	Doit être appelée à toutes les millisecondes, à partir de l'interruption du tick.
+*/
+void motor_tick(void);
+
+#endif /* MOTOR_H_INCLUDED */
@@ -0,0 +1,255 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file pid.c
+	\brief Boucle de position de la flèche
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/eeprom.h>
+#include "pid.h"
+#include "eeprom_map.h"
+#include "kinematics.h"
+#include "motor.h"
+#include "timebase.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define EEPROM_MAGIC		0x50
+
+/* Part intégrale la plus forte: un rapport cyclique de 255, 8 bits de fraction */
+#define INTEGRALE_MAX		(255L * 256)
+
+typedef struct{
+
+	uint8_t magic;
+	pid_gains_t gains;
+
+}pid_eeprom_t;
+
+_Static_assert(sizeof(pid_eeprom_t) <= EEPROM_PID_TAILLE, "Les gains dépassent leur zone de l'EEPROM");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static pid_gains_t gains;
+static bool regle = FALSE;
+
+static bool actif = FALSE;
+static uint16_t cible;
+static int32_t integrale;		/* part intégrale, rapport cyclique avec 8 bits de fraction */
+static uint16_t mesure_prec;
+static uint32_t dernier_ms;
+static bool dedans;				/* erreur sous PID_TOLERANCE */
+static uint32_t entree_ms;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static int16_t demi_tour(int16_t ecart);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void pid_init(void){
+
+	pid_eeprom_t sauve;
+
+	eeprom_read_block(&sauve, (const void*)EEPROM_PID_ADDR, sizeof(sauve));
+
+	regle = (sauve.magic == EEPROM_MAGIC) && (sauve.gains.kp != 0);
+
+	if(regle){
+
+		gains = sauve.gains;
+	}
+
+	else{
+
+		gains.kp = PID_KP_DEFAUT;
+		gains.ti_ms = 0;
+		gains.td_ms = 0;
+	}
+
+	actif = FALSE;
+}
+
+
+bool pid_get_gains(pid_gains_t* copie){
+
+	*copie = gains;
+
+	return regle;
+}
+
+
+void pid_set_gains(const pid_gains_t* nouveaux){
+
+	gains = *nouveaux;
+	gains.kp = (gains.kp > PID_KP_MAX) ? PID_KP_MAX : gains.kp;
+	gains.td_ms = (gains.td_ms > PID_TD_MAX_MS) ? PID_TD_MAX_MS : gains.td_ms;
+
+	pid_eeprom_t sauve = {EEPROM_MAGIC, gains};
+
+	regle = TRUE;
+
+	eeprom_update_block(&sauve, (void*)EEPROM_PID_ADDR, sizeof(sauve));
+}
+
+
+void pid_start(uint16_t nouvelle){
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+
+	cible = nouvelle;
+	integrale = 0;
+	mesure_prec = position.angle;
+	dernier_ms = timebase_millis();
+	dedans = FALSE;
+	actif = TRUE;
+}
+
+
+void pid_stop(void){
+
+	if(actif){
+
+		motor_set_duty(MOTOR_FLECHE, 0);
+		actif = FALSE;
+	}
+}
+
+
+bool pid_process(void){
+
+	if(!actif){
+
+		return FALSE;
+	}
+
+	uint32_t maintenant = timebase_millis();
+	uint32_t dt = maintenant - dernier_ms;
+
+	if(dt < PID_PERIODE_MS){
+
+		return TRUE;
+	}
+
+	// Après un passage lent de la boucle principale, l'intégrale avance de 4 périodes au plus
+	dernier_ms = maintenant;
+	dt = (dt > 4 * PID_PERIODE_MS) ? 4 * PID_PERIODE_MS : dt;
+
+	kinematics_polar_t position;
+
+	kinematics_get(&position);
+
+	// Par le plus court chemin: la flèche peut passer par 0°
+	int16_t erreur = demi_tour((int16_t)cible - (int16_t)position.angle);
+	int16_t variation = demi_tour((int16_t)position.angle - (int16_t)mesure_prec);
+
+	mesure_prec = position.angle;
+
+	// Établie: l'erreur reste dans la tolérance, flèche arrêtée
+	if((erreur >= -PID_TOLERANCE) && (erreur <= PID_TOLERANCE)){
+
+		if(!dedans){
+
+			dedans = TRUE;
+			entree_ms = maintenant;
+		}
+
+		else if(maintenant - entree_ms >= PID_ETABLI_MS){
+
+			pid_stop();
+			return FALSE;
+		}
+
+		motor_set_duty(MOTOR_FLECHE, 0);
+		return TRUE;
+	}
+
+	dedans = FALSE;
+
+	// Parts P et D, 8 bits de fraction (angles en 1/16 de degré)
+	int32_t p = (int32_t)gains.kp * erreur / KINEMATICS_DEGRE;
+	int32_t d = ((int32_t)gains.kp * variation / KINEMATICS_DEGRE) * gains.td_ms / (int32_t)dt;
+
+	// Kp.e.dt / Ti, bornée
+	if(gains.ti_ms != 0){
+
+		integrale += p * (int32_t)dt / gains.ti_ms;
+
+		if(integrale > INTEGRALE_MAX){
+
+			integrale = INTEGRALE_MAX;
+		}
+
+		else if(integrale < -INTEGRALE_MAX){
+
+			integrale = -INTEGRALE_MAX;
+		}
+	}
+
+	int32_t u = p + integrale - d;
+
+	// Rapport cyclique: seuil de frottement plus |u|
+	uint32_t duty = ((u < 0) ? -u : u) >> 8;
+
+	duty += KINEMATICS_FLECHE_SEUIL;
+
+	motor_set(MOTOR_FLECHE, u < 0, (duty > 255) ? 255 : duty);
+
+	return TRUE;
+}
+
+
+bool pid_is_active(void){
+
+	return actif;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Ramène un écart d'angle entre -180° et 180° */
+static int16_t demi_tour(int16_t ecart){
+
+	if(ecart > 180 * KINEMATICS_DEGRE){
+
+		return ecart - 360 * KINEMATICS_DEGRE;
+	}
+
+	if(ecart < -180 * KINEMATICS_DEGRE){
+
+		return ecart + 360 * KINEMATICS_DEGRE;
+	}
+
+	return ecart;
+}
@@ -0,0 +1,130 @@
+#ifndef PID_H_INCLUDED
+#define PID_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file pid.h
+	\brief Boucle de position de la flèche
+
+	La flèche est amenée à un angle par un PID sur la position estimée de kinematics.h
+	(encodeur de 15° et vitesse entre ses fronts):
+
+		u = Kp.(e + 1/Ti.somme(e.dt) - Td.dmesure/dt)
+
+	La dérivée porte sur la mesure, pas sur l'erreur: un changement de cible ne donne
+	pas de coup. La part intégrale est bornée à un rapport cyclique de 255. Le rapport
+	cyclique appliqué est le seuil de frottement de la flèche plus |u|, à toutes les
+	PID_PERIODE_MS, par la mise en forme contre le balancement (shaper.h): les gains
+	trouvés par autotune.h tiennent compte de son retard.
+
+	La flèche est arrêtée et la boucle finie quand l'erreur reste sous PID_TOLERANCE
+	pendant PID_ETABLI_MS.
+
+	Les gains sont lus de l'EEPROM (eeprom_map.h) au démarrage. Sans gains sauvés, la
+	boucle a des gains prudents (P seul) et automation_goto() déplace la flèche sans
+	elle.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Période de la boucle, en ms */
+#define PID_PERIODE_MS		10
+
+/* Erreur acceptée (1/16 de degré) et durée sous celle-ci pour finir, en ms */
+#define PID_TOLERANCE		16
+#define PID_ETABLI_MS		300
+
+/* Gains sans réglage: 4 de rapport cyclique par degré, sans intégrale ni dérivée */
+#define PID_KP_DEFAUT		(4 * 256)
+
+/* Gains les plus forts acceptés: la part D reste sur 32 bits */
+#define PID_KP_MAX			(64 * 256)
+#define PID_TD_MAX_MS		4000
+
+typedef struct{
+
+	uint16_t kp;			/* rapport cyclique par degré, 8 bits de fraction */
+	uint16_t ti_ms;			/* 0: sans intégrale */
+	uint16_t td_ms;			/* 0: sans dérivée */
+
+}pid_gains_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Lit les gains sauvés dans l'EEPROM, boucle arrêtée
+    \return rien.
+*/
+void pid_init(void);
+
+/**
+    \brief Retourne les gains de la boucle
+	\param[out]	gains Les gains
+    \return TRUE si les gains viennent d'un réglage (EEPROM), FALSE pour les gains par défaut
+*/
+bool pid_get_gains(pid_gains_t* gains);
+
+/**
+    \brief Change les gains et les sauve dans l'EEPROM
+	\param[in]	gains Les nouveaux gains, plafonnés à PID_KP_MAX et PID_TD_MAX_MS
+    \return rien.
+
+	L'écriture bloque environ 25 ms.
+*/
+void pid_set_gains(const pid_gains_t* gains);
+
+/**
+    \brief Amène la flèche à un angle
+	\param[in]	cible L'angle, en 1/16 de degré (kinematics.h), atteint par le plus court chemin
+    \return rien.
+*/
+void pid_start(uint16_t cible);
+
+/**
+    \brief Arrête la boucle et la flèche
+    \return rien.
+*/
+void pid_stop(void);
+
+/**
+    \brief Avance la boucle
+    \return TRUE tant que la flèche n'est pas établie à sa cible
+
+	À appeler à chaque passage de la boucle principale, après kinematics_update().
+*/
+bool pid_process(void);
+
+/**
+    \brief Indique si la boucle commande la flèche
+    \return TRUE entre pid_start() et la fin
+*/
+bool pid_is_active(void);
+
+#endif /* PID_H_INCLUDED */
@@ -0,0 +1,396 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file profile.c
+	\brief Zones de profilage du microprogramme de la grue
+
+	Format d'un envoi, entiers en little-endian:
+
+		0xA5 0x5A					synchronisation
+		'P' version
+		nb_zones nb_counters nb_ring
+		now(2)						TCNT1 au début de l'envoi
+		count(2) min(2) max(2) sum(4)	une fois par zone, durées en pas du compteur 1 (µs à 8 MHz)
+		value(2)					une fois par compteur
+		time(2) id(1) value(2)		une fois par entrée du tampon circulaire, de la plus
+									ancienne à la plus récente. id < 0x80: fin de la zone
+									id, value est sa durée. id >= 0x80: événement id - 0x80.
+		checksum(1)					somme modulo 256 des octets depuis 'P'
+
+	Les statistiques de chaque zone et chaque compteur sont remis à zéro au moment où
+	ils sont envoyés. Le tampon circulaire est figé pendant l'envoi et vidé à la fin.
+*/
+
+#ifdef PROFILE
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "profile.h"
+#include "uart.h"
+#include "soft_timer.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define PROFILE_VERSION		1
+#define SYNC_0				0xA5
+#define SYNC_1				0x5A
+#define EVENT_FLAG			0x80
+
+/* Période de remplissage du tampon de l'UART pendant un envoi */
+#define DRAIN_PERIOD_MS		2
+
+#define RING_MASK			(PROFILE_RING_SIZE - 1)
+
+_Static_assert((PROFILE_RING_SIZE & RING_MASK) == 0, "PROFILE_RING_SIZE doit être une puissance de 2");
+_Static_assert(PROFILE_ZONE_NB < EVENT_FLAG, "Trop de zones pour le format d'envoi");
+_Static_assert((PROFILE_UART == UART_0 ? UART_0_TX_BUFFER_SIZE : UART_1_TX_BUFFER_SIZE) > 0,
+	"Le port du profilage n'a pas de tampon d'envoi (board_config.h)");
+_Static_assert(PROFILE_UART != UART_1 || PROFILE_UART_1_FORCE,
+	"TXD1 (PD3) lit le sens de l'encodeur: UART_1 demande -DPROFILE_UART_1_FORCE=1 (profile.h)");
+
+typedef struct{
+
+	uint16_t count;
+	uint16_t min;
+	uint16_t max;
+	uint32_t sum;
+
+}zone_stats_t;
+
+
+typedef struct{
+
+	uint16_t time;
+	uint8_t id;
+	uint16_t value;
+
+}ring_entry_t;
+
+
+typedef enum{
+
+	DUMP_IDLE = 0,
+	DUMP_HEADER,
+	DUMP_ZONES,
+	DUMP_COUNTERS,
+	DUMP_RING,
+	DUMP_CHECKSUM
+
+}dump_state_e;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static volatile zone_stats_t zones[PROFILE_ZONE_NB];
+static volatile uint16_t counters[PROFILE_COUNTER_NB];
+
+static volatile ring_entry_t ring[PROFILE_RING_SIZE];
+static volatile uint8_t ring_in = 0;
+static volatile uint8_t ring_count = 0;
+static volatile bool ring_frozen = FALSE;
+
+static soft_timer_t dump_timer;
+static soft_timer_t drain_timer;
+
+/* Envoi en cours: un enregistrement à la fois est préparé dans record[] */
+static dump_state_e dump_state = DUMP_IDLE;
+static uint8_t dump_item;
+static uint8_t dump_ring_start;
+static uint8_t dump_ring_nb;
+static uint8_t checksum;
+static uint8_t record[10];
+static uint8_t record_len = 0;
+static uint8_t record_index = 0;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void ring_add(uint16_t time, uint8_t id, uint16_t value);
+static void put_u16(uint8_t* p, uint16_t value);
+static bool next_record(void);
+static void dump_cb(void* arg);
+static void drain_cb(void* arg);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void profile_init(void){
+
+	// UART_0 est déjà ouvert par main.c avec le bus: le rouvrir viderait ses tampons.
+	// Pour UART_1, seul l'envoi sert: sans tampon de réception (board_config.h), le
+	// récepteur n'est pas activé et laisse PD2 à l'encodeur (INT0)
+	if(PROFILE_UART != UART_0)
+		uart_init(PROFILE_UART);
+
+	soft_timer_init(&dump_timer, dump_cb, NULL);
+	soft_timer_init(&drain_timer, drain_cb, NULL);
+	soft_timer_start(&dump_timer, PROFILE_DUMP_PERIOD_MS, PROFILE_DUMP_PERIOD_MS);
+	soft_timer_start(&drain_timer, DRAIN_PERIOD_MS, DRAIN_PERIOD_MS);
+}
+
+
+void profile_zone_end(profile_zone_e zone, uint16_t begin){
+
+	uint16_t now = profile_now();
+	uint16_t duration = now - begin;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		volatile zone_stats_t* z = &zones[zone];
+
+		if((z->count == 0) || (duration < z->min)){
+
+			z->min = duration;
+		}
+
+		if(duration > z->max){
+
+			z->max = duration;
+		}
+
+		if(z->count != 0xFFFF){
+
+			z->count++;
+		}
+
+		z->sum += duration;
+
+		ring_add(now, zone, duration);
+	}
+}
+
+
+void profile_count(profile_counter_e counter){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		if(counters[counter] != 0xFFFF){
+
+			counters[counter]++;
+		}
+	}
+}
+
+
+void profile_event(profile_event_e event, uint16_t value){
+
+	uint16_t now = profile_now();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		ring_add(now, EVENT_FLAG | event, value);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Appelée en section critique */
+static void ring_add(uint16_t time, uint8_t id, uint16_t value){
+
+	if(ring_frozen){
+
+		return;
+	}
+
+	ring[ring_in].time = time;
+	ring[ring_in].id = id;
+	ring[ring_in].value = value;
+
+	ring_in = (ring_in + 1) & RING_MASK;
+
+	if(ring_count < PROFILE_RING_SIZE){
+
+		ring_count++;
+	}
+}
+
+
+static void put_u16(uint8_t* p, uint16_t value){
+
+	p[0] = value & 0xFF;
+	p[1] = value >> 8;
+}
+
+
+/* Prépare le prochain enregistrement de l'envoi, retourne FALSE quand l'envoi est fini */
+static bool next_record(void){
+
+	uint8_t first = 0;
+
+	record_index = 0;
+
+	switch(dump_state){
+
+	case DUMP_HEADER:
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+			ring_frozen = TRUE;
+			dump_ring_nb = ring_count;
+			dump_ring_start = (ring_in - ring_count) & RING_MASK;
+		}
+
+		record[0] = SYNC_0;
+		record[1] = SYNC_1;
+		record[2] = 'P';
+		record[3] = PROFILE_VERSION;
+		record[4] = PROFILE_ZONE_NB;
+		record[5] = PROFILE_COUNTER_NB;
+		record[6] = dump_ring_nb;
+		put_u16(&record[7], profile_now());
+		record_len = 9;
+
+		// La synchronisation n'entre pas dans la somme de contrôle
+		checksum = 0;
+		first = 2;
+
+		dump_item = 0;
+		dump_state = DUMP_ZONES;
+		break;
+
+	case DUMP_ZONES:
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+			volatile zone_stats_t* z = &zones[dump_item];
+
+			put_u16(&record[0], z->count);
+			put_u16(&record[2], z->min);
+			put_u16(&record[4], z->max);
+			put_u16(&record[6], z->sum & 0xFFFF);
+			put_u16(&record[8], z->sum >> 16);
+
+			z->count = 0;
+			z->min = 0;
+			z->max = 0;
+			z->sum = 0;
+		}
+
+		record_len = 10;
+
+		if(++dump_item == PROFILE_ZONE_NB){
+
+			dump_item = 0;
+			dump_state = DUMP_COUNTERS;
+		}
+		break;
+
+	case DUMP_COUNTERS:
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+			put_u16(&record[0], counters[dump_item]);
+			counters[dump_item] = 0;
+		}
+
+		record_len = 2;
+
+		if(++dump_item == PROFILE_COUNTER_NB){
+
+			dump_item = 0;
+			dump_state = (dump_ring_nb != 0) ? DUMP_RING : DUMP_CHECKSUM;
+		}
+		break;
+
+	case DUMP_RING:{
+
+		// Le tampon est figé: pas de section critique nécessaire
+		volatile ring_entry_t* e = &ring[(dump_ring_start + dump_item) & RING_MASK];
+
+		put_u16(&record[0], e->time);
+		record[2] = e->id;
+		put_u16(&record[3], e->value);
+		record_len = 5;
+
+		if(++dump_item == dump_ring_nb){
+
+			dump_state = DUMP_CHECKSUM;
+		}
+		break;
+	}
+
+	case DUMP_CHECKSUM:
+
+		record[0] = checksum;
+		record_len = 1;
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+			ring_count = 0;
+			ring_frozen = FALSE;
+		}
+
+		dump_state = DUMP_IDLE;
+
+		// Le dernier octet n'entre pas dans sa propre somme
+		return TRUE;
+
+	default:
+
+		record_len = 0;
+		return FALSE;
+	}
+
+	for(uint8_t i = first; i < record_len; i++){
+
+		checksum += record[i];
+	}
+
+	return TRUE;
+}
+
+
+static void dump_cb(void* arg){
+
+	// Un envoi trop lent pour la période est simplement allongé
+	if((dump_state == DUMP_IDLE) && (record_index == record_len)){
+
+		dump_state = DUMP_HEADER;
+	}
+}
+
+
+static void drain_cb(void* arg){
+
+	while(!uart_is_tx_buffer_full(PROFILE_UART)){
+
+		if(record_index == record_len){
+
+			if(!next_record()){
+
+				return;
+			}
+		}
+
+		uart_put_byte(PROFILE_UART, record[record_index++]);
+	}
+}
+
+#endif /* PROFILE */
@@ -0,0 +1,202 @@
+#ifndef PROFILE_H_INCLUDED
+#define PROFILE_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file profile.h
+	\brief Zones de profilage du microprogramme de la grue
+
+	Le profilage n'existe que si le projet est compilé avec le symbole PROFILE. Sans
+	lui, toutes les macros sont vides et profile.c ne génère aucun code.
+
+	- PROFILE_BEGIN(zone) / PROFILE_END(zone) mesurent la durée d'une zone, dans une
+	  même portée. Une zone ne peut pas être ouverte deux fois dans la même portée.
+	- PROFILE_CALL(zone, instruction) mesure une seule instruction, exe.:
+	  PROFILE_CALL(PROFILE_ZONE_SPRINTF, sprintf(msg, "x: %d", x));
+	- PROFILE_COUNT(counter) incrémente un compteur.
+	- PROFILE_EVENT(event, value) note un événement ponctuel avec une valeur.
+
+	Les instants sont lus dans TCNT1, le compteur libre de la base de temps, sans les
+	ramener en µs pour ne rien ajouter aux zones mesurées: la résolution est d'un pas de
+	PWM1_DIVISION cycles (1 µs à 8 MHz) et une zone doit durer moins de 65536 pas.
+
+	Chaque zone garde son nombre de passages, sa durée min, max et la somme des durées
+	(la moyenne est calculée par le décodeur). Chaque fin de zone et chaque événement est
+	aussi ajouté à un tampon circulaire des PROFILE_RING_SIZE dernières entrées.
+
+	Toutes les PROFILE_DUMP_PERIOD_MS, le tout est envoyé en binaire sur PROFILE_UART,
+	puis les statistiques sont remises à zéro: chaque envoi couvre donc une période.
+	L'envoi se fait quelques octets à la fois, par une minuterie logicielle, sans
+	bloquer la boucle principale. Le format est décrit dans profile.c et décodé par
+	tools/bench/profile_decode.py.
+
+	PROFILE_UART est UART_0 par défaut. TXD0 porte aussi la télémétrie de la batterie
+	(trame.h) et les réponses des commandes ?x: les envois binaires s'y mêlent, la
+	manette reçoit de fausses trames de télémétrie et les réponses ne sont plus
+	lisibles. Profiler la grue sans manette et ne lire TXD0 qu'avec profile_decode.py.
+
+	Sur la grue, TXD1 est la broche PD3 qui lit le sens de l'encodeur: avec UART_1, le
+	sens de rotation lu est faux pendant le profilage (le comptage sur INT0 reste bon).
+	La compilation refuse donc UART_1 sans le demander explicitement:
+	-DPROFILE -DPROFILE_UART=UART_1 -DPROFILE_UART_1_FORCE=1.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+#ifdef PROFILE
+#include <avr/io.h>
+#include <util/atomic.h>
+#endif
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#ifndef PROFILE_UART
+#define PROFILE_UART			UART_0
+#endif
+#ifndef PROFILE_UART_1_FORCE
+#define PROFILE_UART_1_FORCE	0	/* 1: accepter UART_1 malgré l'encodeur (voir plus haut) */
+#endif
+
+#define PROFILE_DUMP_PERIOD_MS	1000
+
+/**
+    \brief Nombre d'entrées du tampon circulaire (puissance de 2)
+*/
+#define PROFILE_RING_SIZE		16
+
+typedef enum{
+
+	PROFILE_ZONE_FRAME = 0,			/* lecture et décodage d'une trame */
+	PROFILE_ZONE_MOTOR,				/* consignes des moteurs et de la pince */
+	PROFILE_ZONE_LCD,				/* écriture sur l'afficheur */
+	PROFILE_ZONE_SPRINTF,			/* formatage des textes de l'afficheur */
+	PROFILE_ZONE_ISR_INT0,			/* encodeur */
+	PROFILE_ZONE_ISR_TICK,			/* tick de 1 ms (TIMER1_COMPB_vect) */
+	PROFILE_ZONE_ISR_SERVO,			/* servomoteur (TIMER1_COMPA_vect) */
+	PROFILE_ZONE_ISR_UART0_RX,
+	PROFILE_ZONE_ISR_UART0_UDRE,
+	PROFILE_ZONE_ISR_UART1_RX,
+	PROFILE_ZONE_ISR_UART1_UDRE,
+	PROFILE_ZONE_NB
+
+}profile_zone_e;
+
+
+typedef enum{
+
+	PROFILE_COUNTER_FRAME = 0,		/* trames reçues */
+	PROFILE_COUNTER_LOOP,			/* tours de la boucle principale */
+	PROFILE_COUNTER_NB
+
+}profile_counter_e;
+
+
+typedef enum{
+
+	PROFILE_EVENT_MODE = 0,			/* changement de mode, valeur: a */
+	PROFILE_EVENT_TIME_OVER,		/* début du TIME OVER, valeur: secondes écoulées */
+	PROFILE_EVENT_NB
+
+}profile_event_e;
+
+#ifdef PROFILE
+
+#define PROFILE_BEGIN(zone)			uint16_t profile_begin_##zone = profile_now()
+#define PROFILE_END(zone)			profile_zone_end((zone), profile_begin_##zone)
+#define PROFILE_CALL(zone, ...)		do{ PROFILE_BEGIN(zone); __VA_ARGS__; PROFILE_END(zone); }while(0)
+#define PROFILE_COUNT(counter)		profile_count(counter)
+#define PROFILE_EVENT(event, value)	profile_event((event), (value))
+#define PROFILE_INIT()				profile_init()
+
+#else
+
+#define PROFILE_BEGIN(zone)			do{}while(0)
+#define PROFILE_END(zone)			do{}while(0)
+#define PROFILE_CALL(zone, ...)		do{ __VA_ARGS__; }while(0)
+#define PROFILE_COUNT(counter)		do{}while(0)
+#define PROFILE_EVENT(event, value)	do{}while(0)
+#define PROFILE_INIT()				do{}while(0)
+
+#endif
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+#ifdef PROFILE
+
+/**
+    \brief Lit l'instant présent pour le profilage
+    \return TCNT1, en pas du compteur 1 (µs à 8 MHz)
+
+	La lecture 16 bits passe par le registre TEMP partagé, d'où la section critique.
+*/
+static inline uint16_t profile_now(void){
+
+	uint16_t now;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		now = TCNT1;
+	}
+
+	return now;
+}
+
+/**
+    \brief Démarre l'UART de profilage et l'envoi périodique
+    \return rien.
+
+	À appeler après pwm1_init() et uart_init() des autres ports.
+*/
+void profile_init(void);
+
+/**
+    \brief Ferme une zone (utiliser PROFILE_END)
+	\param[in]	zone La zone
+	\param[in]	begin L'instant d'ouverture de la zone
+    \return rien.
+*/
+void profile_zone_end(profile_zone_e zone, uint16_t begin);
+
+/**
+    \brief Incrémente un compteur (utiliser PROFILE_COUNT)
+	\param[in]	counter Le compteur
+    \return rien.
+*/
+void profile_count(profile_counter_e counter);
+
+/**
+    \brief Note un événement (utiliser PROFILE_EVENT)
+	\param[in]	event L'événement
+	\param[in]	value La valeur associée
+    \return rien.
+*/
+void profile_event(profile_event_e event, uint16_t value);
+
+#endif /* PROFILE */
+
+#endif /* PROFILE_H_INCLUDED */
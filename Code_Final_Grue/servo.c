@@ -0,0 +1,207 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file servo.c
+	\brief Commande du servomoteur de la pince sur PD5 (OC1A)
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "servo.h"
+#include "driver.h"
+#include "profile.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+_Static_assert((uint32_t)SERVO_PERIOD_US * PWM1_PAS_PAR_MS / 1000UL <= 0xFFFF,
+	"La trame du servomoteur doit tenir dans les 16 bits du compteur 1 à F_CPU");
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static volatile uint16_t target_us;		// consigne demandée
+static volatile uint16_t width_us;		// largeur d'impulsion de la trame en cours
+static volatile uint16_t slew_us;		// pas maximal par trame (0 = pas de limite)
+static volatile bool pulse_high;		// état de OC1A après le dernier front
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static uint16_t next_width(void);
+
+/* ----------------------------------------------------------------------------
+Interrupts
+---------------------------------------------------------------------------- */
+
+/**
+    \brief OC1A vient de basculer, on programme le front suivant
+
+	Le front lui-même est déjà sorti au bon moment par le matériel, la latence de
+	cette interruption n'a donc aucun effet sur la largeur d'impulsion tant qu'elle
+	reste plus courte que l'impulsion.
+*/
+ISR(TIMER1_COMPA_vect){
+
+	PROFILE_BEGIN(PROFILE_ZONE_ISR_SERVO);
+
+	if(pulse_high == FALSE){
+
+		// Front montant: début d'une trame, c'est le seul moment où la largeur change
+		width_us = next_width();
+		OCR1A += PWM1_US(width_us);
+		pulse_high = TRUE;
+	}
+
+	else{
+
+		// Front descendant: le reste de la trame
+		OCR1A += PWM1_US(SERVO_PERIOD_US - width_us);
+		pulse_high = FALSE;
+	}
+
+	PROFILE_END(PROFILE_ZONE_ISR_SERVO);
+}
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void servo_init(uint16_t position_us){
+
+	if(position_us < SERVO_MIN_US){
+
+		position_us = SERVO_MIN_US;
+	}
+
+	else if(position_us > SERVO_MAX_US){
+
+		position_us = SERVO_MAX_US;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		target_us = position_us;
+		width_us = position_us;
+		slew_us = 0;
+		pulse_high = FALSE;
+
+		// Forcer OC1A à 0 avant de sortir la broche ("clear on compare match" + FOC1A)
+		TCCR1A = set_bit(TCCR1A, COM1A1);
+		TCCR1A = clear_bit(TCCR1A, COM1A0);
+		TCCR1C = set_bit(TCCR1C, FOC1A);
+
+		// Puis "toggle OC1A on compare match": le premier front montant dans 100 µs
+		TCCR1A = clear_bit(TCCR1A, COM1A1);
+		TCCR1A = set_bit(TCCR1A, COM1A0);
+		OCR1A = TCNT1 + PWM1_US(100);
+
+		DDRD = set_bit(DDRD, PD5);
+
+		TIFR1 = set_bit(0, OCF1A);
+		TIMSK1 = set_bit(TIMSK1, OCIE1A);
+	}
+}
+
+
+void servo_set_position(uint16_t position_us){
+
+	if(position_us < SERVO_MIN_US){
+
+		position_us = SERVO_MIN_US;
+	}
+
+	else if(position_us > SERVO_MAX_US){
+
+		position_us = SERVO_MAX_US;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		target_us = position_us;
+	}
+}
+
+
+uint16_t servo_get_position(void){
+
+	uint16_t position_us;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		position_us = width_us;
+	}
+
+	return position_us;
+}
+
+
+void servo_set_slew(uint16_t step_us){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		slew_us = step_us;
+	}
+}
+
+
+bool servo_is_moving(void){
+
+	bool moving;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		moving = (width_us != target_us);
+	}
+
+	return moving;
+}
+
+/* ----------------------------------------------------------------------------
+Static functions
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Calcule la largeur de la prochaine trame (appelée dans l'interruption)
+*/
+static uint16_t next_width(void){
+
+	uint16_t width = width_us;
+	uint16_t target = target_us;
+
+	if((slew_us == 0) || (width == target)){
+
+		return target;
+	}
+
+	if(target > width){
+
+		return (target - width > slew_us) ? width + slew_us : target;
+	}
+
+	return (width - target > slew_us) ? width - slew_us : target;
+}
@@ -0,0 +1,108 @@
+#ifndef SERVO_H_INCLUDED
+#define SERVO_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file servo.h
+	\brief Commande du servomoteur de la pince sur PD5 (OC1A)
+
+	Le signal est une trame de SERVO_PERIOD_US (20 ms) dont l'impulsion haute dure la
+	position demandée, avec une résolution de 1 µs. Les fronts sont produits par le
+	matériel (OC1A en mode "toggle on compare match" sur le compteur 1 libre, voir
+	pwm1_init()); l'interruption de comparaison A ne fait que programmer le front suivant.
+	Une nouvelle position n'est prise en compte qu'au début d'une trame, donc aucune
+	impulsion tronquée ne sort jamais.
+
+	La position peut être limitée en vitesse: à chaque trame, la largeur d'impulsion ne
+	s'approche de la consigne que d'au plus le pas fixé par servo_set_slew().
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Période de la trame du servomoteur, en µs
+*/
+#define SERVO_PERIOD_US		20000
+
+/**
+    \brief Plus petite largeur d'impulsion acceptée, en µs
+*/
+#define SERVO_MIN_US		500
+
+/**
+    \brief Plus grande largeur d'impulsion acceptée, en µs
+*/
+#define SERVO_MAX_US		2500
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Démarre la génération de la trame de 20 ms sur PD5
+	\param[in]	position_us La largeur d'impulsion initiale, en µs
+    \return rien.
+
+	pwm1_init() doit avoir été appelée avant. La position initiale est appliquée sans
+	limitation de vitesse.
+*/
+void servo_init(uint16_t position_us);
+
+/**
+    \brief Fixe la consigne de position du servomoteur
+	\param[in]	position_us La largeur d'impulsion voulue, en µs
+    \return rien.
+
+	La consigne est ramenée entre SERVO_MIN_US et SERVO_MAX_US. Elle est appliquée au
+	début de la prochaine trame, directement ou graduellement selon servo_set_slew().
+*/
+void servo_set_position(uint16_t position_us);
+
+/**
+    \brief Retourne la largeur d'impulsion présentement générée
+    \return La largeur d'impulsion de la trame en cours, en µs
+*/
+uint16_t servo_get_position(void);
+
+/**
+    \brief Limite la vitesse de déplacement du servomoteur
+	\param[in]	step_us La variation maximale de largeur d'impulsion par trame de 20 ms, en µs.
+				0 désactive la limitation.
+    \return rien.
+
+	Exe.: un pas de 20 µs fait passer la pince de 1000 µs à 2000 µs en 50 trames, donc en 1 s.
+*/
+void servo_set_slew(uint16_t step_us);
+
+/**
+    \brief Indique si le servomoteur n'a pas encore atteint sa consigne
+    \return TRUE si la largeur d'impulsion est encore en train de changer
+*/
+bool servo_is_moving(void);
+
+#endif /* SERVO_H_INCLUDED */
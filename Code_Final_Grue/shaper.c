@@ -0,0 +1,429 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file shaper.c
+	\brief Mise en forme des consignes de la flèche et du chariot contre le balancement
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "shaper.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+_Static_assert((MOTOR_FLECHE < SHAPER_NB) && (MOTOR_CHARIOT < SHAPER_NB) &&
+	(MOTOR_GLISSIERE >= SHAPER_NB), "Seules la flèche et le chariot sont mis en forme");
+
+_Static_assert((SHAPER_HISTORIQUE >= 2) && (SHAPER_HISTORIQUE <= 255),
+	"SHAPER_HISTORIQUE doit être entre 2 et 255");
+
+_Static_assert(SHAPER_AMORTISSEMENT_PCT <= SHAPER_AMORTISSEMENT_MAX,
+	"SHAPER_AMORTISSEMENT_PCT dépasse la table de K");
+
+#define IMPULSIONS_MAX		3
+
+/* Amplitude de 1: 15 bits de fraction */
+#define UN					32768UL
+
+/* pi.1000 / sqrt(9810 mm/s²), en ms par racine de mm, 8 bits de fraction */
+#define DEMI_PERIODE_K		8120UL
+
+typedef struct{
+
+	uint16_t k;				/* exp(-z.pi / sqrt(1 - z^2)), 15 bits de fraction */
+	uint16_t correction;	/* 1 / sqrt(1 - z^2), 12 bits de fraction */
+
+}amortissement_t;
+
+
+typedef struct{
+
+	uint16_t instant;		/* horloge de la mise en forme, en ms */
+	int16_t consigne;
+
+}echantillon_t;
+
+
+typedef struct{
+
+	echantillon_t historique[SHAPER_HISTORIQUE];
+	uint8_t recent;					/* indice de la consigne la plus récente */
+	uint8_t vue[IMPULSIONS_MAX];	/* consigne vue par chaque impulsion */
+	int16_t sortie;
+	bool change;					/* sortie à recalculer */
+
+}voie_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+/* Amortissement de 0 à SHAPER_AMORTISSEMENT_MAX % */
+static const amortissement_t table[SHAPER_AMORTISSEMENT_MAX + 1] PROGMEM = {
+
+	{32768, 4096}, {31755, 4096}, {30772, 4097}, {29819, 4098},
+	{28896, 4099}, {27999, 4101}, {27129, 4103}, {26285, 4106},
+	{25465, 4109}, {24669, 4113}, {23896, 4117}, {23145, 4121},
+	{22415, 4126}, {21705, 4131}, {21015, 4137}, {20345, 4143},
+	{19692, 4149}, {19058, 4157}, {18441, 4164}, {17841, 4172},
+	{17256, 4180}, {16688, 4189}, {16134, 4199}, {15595, 4209},
+	{15071, 4219}, {14560, 4230}, {14063, 4242}, {13579, 4254},
+	{13107, 4267}, {12648, 4280}, {12200, 4294},
+};
+
+static shaper_e type;
+static uint16_t cable_mm;
+static uint8_t amortissement_pct;
+
+static uint8_t nb_impulsions;
+static uint16_t retard[IMPULSIONS_MAX];		/* ms */
+static uint16_t amplitude[IMPULSIONS_MAX];	/* somme de UN */
+
+static volatile uint16_t horloge;
+static voie_t voies[SHAPER_NB];
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void impulsions(void);
+static void repos(voie_t* v, int16_t consigne);
+static bool lire_nombre(const char** texte, const char* fin, uint16_t* valeur);
+static uint16_t racine(uint32_t valeur);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void shaper_init(void){
+
+	horloge = 0;
+
+	for(uint8_t i = 0; i < SHAPER_NB; i++){
+
+		repos(&voies[i], 0);
+	}
+
+	shaper_configure(SHAPER_DEFAUT, SHAPER_CABLE_MM, SHAPER_AMORTISSEMENT_PCT);
+}
+
+
+void shaper_configure(shaper_e nouveau, uint16_t cable, uint8_t amortissement){
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+
+		type = nouveau;
+		cable_mm = cable;
+		amortissement_pct = (amortissement > SHAPER_AMORTISSEMENT_MAX) ?
+			SHAPER_AMORTISSEMENT_MAX : amortissement;
+
+		impulsions();
+
+		// La sortie rejoint la dernière consigne au prochain calcul
+		for(uint8_t i = 0; i < SHAPER_NB; i++){
+
+			voie_t* v = &voies[i];
+			int16_t sortie = v->sortie;
+
+			repos(v, v->historique[v->recent].consigne);
+			v->change = (v->sortie != sortie);
+			v->sortie = sortie;
+		}
+	}
+}
+
+
+void shaper_input(motor_e voie, int16_t consigne){
+
+	voie_t* v = &voies[voie];
+
+	if(consigne == v->historique[v->recent].consigne){
+
+		return;
+	}
+
+	uint8_t suivant = (v->recent + 1) % SHAPER_HISTORIQUE;
+
+	// Historique plein: la plus ancienne consigne est encore vue par la dernière impulsion
+	if(suivant == v->vue[nb_impulsions - 1]){
+
+		v->historique[v->recent].consigne = consigne;
+	}
+
+	else{
+
+		v->historique[suivant].instant = horloge;
+		v->historique[suivant].consigne = consigne;
+		v->recent = suivant;
+	}
+
+	v->vue[0] = v->recent;
+	v->change = TRUE;
+}
+
+
+void shaper_reset(motor_e voie, int16_t consigne){
+
+	repos(&voies[voie], consigne);
+}
+
+
+void shaper_tick(void){
+
+	horloge++;
+}
+
+
+bool shaper_output(motor_e voie, int16_t* sortie){
+
+	voie_t* v = &voies[voie];
+
+	// Chaque impulsion passe aux consignes qui ont au moins son retard
+	for(uint8_t k = 1; k < nb_impulsions; k++){
+
+		while(v->vue[k] != v->recent){
+
+			uint8_t suivant = (v->vue[k] + 1) % SHAPER_HISTORIQUE;
+
+			if((uint16_t)(horloge - v->historique[suivant].instant) < retard[k]){
+
+				break;
+			}
+
+			v->vue[k] = suivant;
+			v->change = TRUE;
+		}
+	}
+
+	if(!v->change){
+
+		return FALSE;
+	}
+
+	v->change = FALSE;
+
+	int32_t somme = 0;
+
+	for(uint8_t k = 0; k < nb_impulsions; k++){
+
+		somme += (int32_t)amplitude[k] * v->historique[v->vue[k]].consigne;
+	}
+
+	int16_t nouvelle = (somme + (int32_t)(UN / 2)) >> 15;
+
+	if(nouvelle == v->sortie){
+
+		return FALSE;
+	}
+
+	v->sortie = nouvelle;
+	*sortie = nouvelle;
+
+	return TRUE;
+}
+
+
+uint16_t shaper_get_duration_ms(void){
+
+	return retard[nb_impulsions - 1];
+}
+
+
+uint32_t shaper_get_stop_area(uint8_t duty, uint8_t seuil){
+
+	uint32_t aire = 0;
+	uint32_t reste = UN;
+
+	// Après l'arrêt, l'impulsion k laisse la part des impulsions suivantes jusqu'à son retard
+	for(uint8_t k = 1; k < nb_impulsions; k++){
+
+		reste -= amplitude[k - 1];
+
+		uint8_t sortie = (duty * reste + UN / 2) >> 15;
+
+		if(sortie > seuil){
+
+			aire += (uint32_t)(sortie - seuil) * (retard[k] - retard[k - 1]);
+		}
+	}
+
+	return aire;
+}
+
+
+bool shaper_command(const char* ligne, uint8_t longueur){
+
+	char texte[56];
+
+	if((longueur < 3) || (ligne[0] != '?') || (ligne[1] != 'H')){
+
+		return FALSE;
+	}
+
+	// ?H<shaper_e>,<cable mm>,<amortissement %>
+	if(longueur > 3){
+
+		const char* p = ligne + 2;
+		const char* fin = ligne + longueur - 1;
+		uint16_t nouveau, cable, amortissement;
+
+		if(!lire_nombre(&p, fin, &nouveau) || (nouveau > SHAPER_ZVD) || (*p++ != ',') ||
+			!lire_nombre(&p, fin, &cable) || (cable == 0) || (*p++ != ',') ||
+			!lire_nombre(&p, fin, &amortissement) || (p != fin)){
+
+			uart_put_string(UART_0, "shaper ?H<0..2>,<mm>,<%>\n");
+			return TRUE;
+		}
+
+		shaper_configure(nouveau, cable, (amortissement > 255) ? 255 : amortissement);
+	}
+
+	sprintf(texte, "shaper=%u cable=%u amortissement=%u duree=%u\n",
+		type, cable_mm, amortissement_pct, shaper_get_duration_ms());
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Retards et amplitudes du réglage courant (interruptions désactivées) */
+static void impulsions(void){
+
+	amortissement_t a;
+
+	memcpy_P(&a, &table[amortissement_pct], sizeof(a));
+
+	uint16_t demi = ((uint32_t)racine((uint32_t)cable_mm << 16) * DEMI_PERIODE_K) >> 16;
+
+	demi = ((uint32_t)demi * a.correction) >> 12;
+
+	// 1 / (1+K) et K / (1+K)
+	uint16_t direct = (UN * UN) / (UN + a.k);
+	uint16_t retenu = UN - direct;
+
+	retard[0] = 0;
+
+	switch(type){
+	case SHAPER_ZV:
+
+		nb_impulsions = 2;
+		retard[1] = demi;
+		amplitude[0] = direct;
+		amplitude[1] = retenu;
+		break;
+
+	case SHAPER_ZVD:
+
+		nb_impulsions = 3;
+		retard[1] = demi;
+		retard[2] = 2 * demi;
+		amplitude[0] = ((uint32_t)direct * direct) >> 15;
+		amplitude[2] = ((uint32_t)retenu * retenu) >> 15;
+		amplitude[1] = UN - amplitude[0] - amplitude[2];
+		break;
+
+	default:
+
+		nb_impulsions = 1;
+		amplitude[0] = UN;
+		break;
+	}
+}
+
+
+/* Une seule consigne, vue par toutes les impulsions */
+static void repos(voie_t* v, int16_t consigne){
+
+	v->recent = 0;
+	v->historique[0].instant = horloge;
+	v->historique[0].consigne = consigne;
+
+	for(uint8_t k = 0; k < IMPULSIONS_MAX; k++){
+
+		v->vue[k] = 0;
+	}
+
+	v->sortie = consigne;
+	v->change = FALSE;
+}
+
+
+/* Nombre décimal de 1 à 5 chiffres, jusqu'à fin */
+static bool lire_nombre(const char** texte, const char* fin, uint16_t* valeur){
+
+	const char* p = *texte;
+	uint32_t n = 0;
+
+	while((p < fin) && (*p >= '0') && (*p <= '9') && (p - *texte < 5)){
+
+		n = n * 10 + (*p++ - '0');
+	}
+
+	if((p == *texte) || (n > 0xFFFF)){
+
+		return FALSE;
+	}
+
+	*texte = p;
+	*valeur = n;
+
+	return TRUE;
+}
+
+
+/* Racine carrée entière, arrondie vers le bas */
+static uint16_t racine(uint32_t valeur){
+
+	uint32_t resultat = 0;
+	uint32_t bit = 1UL << 30;
+
+	while(bit > valeur){
+
+		bit >>= 2;
+	}
+
+	while(bit != 0){
+
+		if(valeur >= resultat + bit){
+
+			valeur -= resultat + bit;
+			resultat = (resultat >> 1) + bit;
+		}
+
+		else{
+
+			resultat >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return resultat;
+}
@@ -0,0 +1,183 @@
+#ifndef SHAPER_H_INCLUDED
+#define SHAPER_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file shaper.h
+	\brief Mise en forme des consignes de la flèche et du chariot contre le balancement
+
+	La charge pend au câble de la glissière comme un pendule. Un échelon de consigne de
+	la flèche ou du chariot la fait balancer à la fréquence du pendule, longtemps après
+	l'arrêt de l'axe. La consigne est donc convoluée avec une suite d'impulsions qui
+	s'annulent sur le balancement (zero vibration):
+
+		ZV     A0 = 1 / (1+K)          à 0
+		       A1 = K / (1+K)          à T/2
+
+		ZVD    A0 = 1 / (1+K)^2        à 0
+		       A1 = 2K / (1+K)^2       à T/2
+		       A2 = K^2 / (1+K)^2      à T
+
+		K = exp(-z.pi / sqrt(1 - z^2)), z l'amortissement du balancement
+
+	T est la période amortie du pendule, tirée de la longueur du câble L:
+
+		T/2 = pi.sqrt(L / g) / sqrt(1 - z^2)
+
+	Un déplacement dure T/2 (ZV) ou T (ZVD) de plus, mais la charge arrive sans
+	balancer. ZVD tolère mieux une longueur de câble mal connue (environ ±20 % au lieu
+	de ±5 %). Le mouvement de chaque axe est la somme des mouvements décalés: sans le
+	frottement, la position finale ne change pas. Le frottement retient l'axe aux petits
+	rapports cycliques des dernières marches: en mode automatique, l'encodeur arrête la
+	flèche (automation.h).
+
+	Les impulsions et la consigne sont en virgule fixe (amplitudes sur 15 bits de
+	fraction). La sortie est recalculée au tick de 1 ms (motor_tick()) ou à une nouvelle
+	consigne. Chaque voie garde les SHAPER_HISTORIQUE dernières consignes encore vues
+	par une impulsion; quand l'historique est plein (manette qui bouge sans arrêt), la
+	nouvelle consigne remplace la plus récente.
+
+	Le module est appelé par motor.c: motor_set() et motor_set_duty() passent par la
+	mise en forme pour MOTOR_FLECHE et MOTOR_CHARIOT, en mode manuel comme automatique.
+	motor_stop() arrête l'axe tout de suite, sans mise en forme.
+
+	La commande ?H reçue sur UART_0 renvoie:
+
+		shaper=<shaper_e> cable=<mm> amortissement=<%> duree=<ms ajoutées à un déplacement>
+
+	et ?H<shaper_e>,<cable mm>,<amortissement %> change le réglage, exe.: ?H2,400,2
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "motor.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+typedef enum{
+
+	SHAPER_AUCUN = 0,	/* consigne appliquée telle quelle */
+	SHAPER_ZV,
+	SHAPER_ZVD
+
+}shaper_e;
+
+/**
+    \brief Réglage au démarrage: câble de la glissière à mi-course
+*/
+#define SHAPER_DEFAUT				SHAPER_ZVD
+#define SHAPER_CABLE_MM				400
+#define SHAPER_AMORTISSEMENT_PCT	2
+
+/* Amortissement le plus fort de la table de K (shaper.c) */
+#define SHAPER_AMORTISSEMENT_MAX	30
+
+/* Consignes gardées par voie */
+#define SHAPER_HISTORIQUE			16
+
+/* Voies mises en forme: les axes de motor_e qui déplacent la charge à l'horizontale */
+#define SHAPER_NB					2
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Règle la mise en forme par défaut, voies au repos
+    \return rien.
+
+	Appelée par motor_init().
+*/
+void shaper_init(void);
+
+/**
+    \brief Change la mise en forme et oublie les consignes passées
+	\param[in]	type SHAPER_AUCUN, SHAPER_ZV ou SHAPER_ZVD
+	\param[in]	cable_mm La longueur du câble, du chariot au centre de la charge
+	\param[in]	amortissement_pct L'amortissement du balancement, plafonné à SHAPER_AMORTISSEMENT_MAX
+    \return rien.
+
+	Les voies passent tout de suite à leur dernière consigne: à appeler les axes
+	arrêtés.
+*/
+void shaper_configure(shaper_e type, uint16_t cable_mm, uint8_t amortissement_pct);
+
+/**
+    \brief Donne une nouvelle consigne à une voie (interruptions désactivées)
+	\param[in]	voie L'axe, MOTOR_FLECHE ou MOTOR_CHARIOT
+	\param[in]	consigne Le rapport cyclique signé, négatif pour la broche de direction à 1
+    \return rien.
+*/
+void shaper_input(motor_e voie, int16_t consigne);
+
+/**
+    \brief Remet une voie au repos sur une consigne, sans mise en forme
+	\param[in]	voie L'axe, MOTOR_FLECHE ou MOTOR_CHARIOT
+	\param[in]	consigne La consigne et la sortie de la voie
+    \return rien.
+*/
+void shaper_reset(motor_e voie, int16_t consigne);
+
+/**
+    \brief Avance l'horloge de la mise en forme
+    \return rien.
+
+	Doit être appelée à toutes les millisecondes, à partir de l'interruption du tick.
+*/
+void shaper_tick(void);
+
+/**
+    \brief Calcule la sortie d'une voie
+	\param[in]	voie L'axe, MOTOR_FLECHE ou MOTOR_CHARIOT
+	\param[out]	sortie Le rapport cyclique signé à appliquer
+    \return TRUE si la sortie a changé depuis le dernier appel
+*/
+bool shaper_output(motor_e voie, int16_t* sortie);
+
+/**
+    \brief Retourne le temps ajouté à chaque déplacement
+    \return L'instant de la dernière impulsion, en ms
+*/
+uint16_t shaper_get_duration_ms(void);
+
+/**
+    \brief Retourne ce qu'un axe parcourt encore quand sa consigne passe à 0
+	\param[in]	duty Le rapport cyclique avant l'arrêt
+	\param[in]	seuil Le rapport cyclique sous lequel le frottement retient l'axe
+    \return La somme du rapport cyclique au-dessus du seuil, en ms
+
+	La distance est vmax.aire / (255 * 1000) avec la vitesse vmax à 255 (kinematics.h).
+*/
+uint32_t shaper_get_stop_area(uint8_t duty, uint8_t seuil);
+
+/**
+    \brief Traite la commande ?H
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool shaper_command(const char* ligne, uint8_t longueur);
+
+#endif /* SHAPER_H_INCLUDED */
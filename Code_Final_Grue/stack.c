@@ -0,0 +1,126 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file stack.c
+	\brief Niveau maximal atteint par la pile et le tas
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/io.h>
+#include "stack.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Symboles de l'éditeur de liens et de avr-libc */
+extern uint8_t __data_start;
+extern uint8_t _end;
+extern uint8_t __stack;
+extern char* __brkval __attribute__((weak));	/* seulement si malloc() est lié */
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void paint(void) __attribute__((naked, used, section(".init1")));
+static uint8_t* heap_top(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+uint16_t stack_static_size(void){
+
+	return &_end - &__data_start;
+}
+
+
+uint16_t stack_free(void){
+
+	return (uint8_t*)SP - heap_top();
+}
+
+
+uint16_t stack_unused(void){
+
+	const uint8_t* p = heap_top();
+	uint16_t count = 0;
+
+	while((p <= &__stack) && (*p == STACK_PAINT)){
+
+		p++;
+		count++;
+	}
+
+	return count;
+}
+
+
+bool stack_command(const char* ligne, uint8_t longueur){
+
+	char texte[48];
+
+	if((longueur != 3) || (ligne[0] != '?') || (ligne[1] != 'M')){
+
+		return FALSE;
+	}
+
+	sprintf(texte, "ram statique=%u libre=%u jamais=%u\n", stack_static_size(), stack_free(),
+		stack_unused());
+	uart_put_string(UART_0, texte);
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/*
+	Exécutée avant l'initialisation du pointeur de pile et de r1 (.init2): en assembleur,
+	sans appel et sans utiliser la pile. Remplit de _end jusqu'à __stack (RAMEND) inclus.
+*/
+static void paint(void){
+
+	__asm__ volatile(
+		"	ldi r30, lo8(_end)			\n"
+		"	ldi r31, hi8(_end)			\n"
+		"	ldi r24, %0					\n"
+		"	ldi r25, hi8(__stack)		\n"
+		"	rjmp 2f						\n"
+		"1:	st Z+, r24					\n"
+		"2:	cpi r30, lo8(__stack)		\n"
+		"	cpc r31, r25				\n"
+		"	brlo 1b						\n"
+		"	breq 1b						\n"
+		:
+		: "i" (STACK_PAINT)
+	);
+}
+
+
+static uint8_t* heap_top(void){
+
+	return ((&__brkval != 0) && (__brkval != 0)) ? (uint8_t*)__brkval : &_end;
+}
@@ -0,0 +1,92 @@
+#ifndef STACK_H_INCLUDED
+#define STACK_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file stack.h
+	\brief Niveau maximal atteint par la pile et le tas
+
+	Avant même l'initialisation des variables (section .init1), toute la RAM entre la
+	fin des variables statiques (_end, après .data, .bss et .noinit) et le haut de la
+	pile est remplie du motif STACK_PAINT. La pile descend du haut de la RAM et le tas
+	(malloc, inutilisé ici) monte depuis _end: les octets qui ont encore le motif n'ont
+	jamais été touchés.
+
+	Plan de la RAM de l'ATmega324A (2 Ko, de 0x100 à 0x8FF):
+
+		.data .bss .noinit | tas -> ...... libre ...... <- pile | RAMEND
+
+	La commande ?M reçue sur UART_0 renvoie:
+
+		ram statique=<octets> libre=<octets> jamais=<octets>
+
+	statique est la taille des variables, libre l'espace entre le tas et la pile au
+	moment de la commande, et jamais le nombre d'octets que la pile n'a jamais atteints
+	depuis le démarrage (la marge réelle). Le rapport statique par module est fait par
+	tools/bench/mapreport.py.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define STACK_PAINT		0xC5
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Taille des variables statiques (.data, .bss et .noinit)
+    \return la taille en octets
+*/
+uint16_t stack_static_size(void);
+
+/**
+    \brief Espace libre entre le haut du tas et le pointeur de pile actuel
+    \return la taille en octets
+*/
+uint16_t stack_free(void);
+
+/**
+    \brief Nombre d'octets jamais touchés par la pile ni par le tas depuis le démarrage
+    \return la taille en octets
+
+	Parcourt la RAM depuis le haut du tas: le temps d'exécution est proportionnel à la
+	marge (environ 6 cycles par octet libre).
+*/
+uint16_t stack_unused(void);
+
+/**
+    \brief Traite la commande ?M
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était la commande, FALSE sinon
+*/
+bool stack_command(const char* ligne, uint8_t longueur);
+
+#endif /* STACK_H_INCLUDED */
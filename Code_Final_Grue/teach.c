@@ -0,0 +1,639 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file teach.c
+	\brief Apprentissage d'une session manuelle dans l'EEPROM et rejeu
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <avr/eeprom.h>
+#include "teach.h"
+#include "eeprom_map.h"
+#include "fifo.h"
+#include "timebase.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define EEPROM_MAGIC		0x54
+
+/* Drapeaux d'un enregistrement (voir teach.h) */
+#define FLAG_P				0x10
+#define FLAG_NIBBLE			0x20
+#define FLAG_LONG			0x40
+#define FLAG_INVALID		0x80
+#define FLAGS_CHAMPS		0x0F
+
+/* Champs, dans l'ordre des bits 0 à 3 */
+#define CHAMP_X				0
+#define CHAMP_Y				1
+#define CHAMP_G				2
+#define CHAMP_ANGLE			3
+#define NB_CHAMPS			4
+
+#define CLICS_TOUR			24		/* clics de l'encodeur par tour */
+
+#define DUREE_MAX			0xFFFF
+#define RECORD_MAX			(1 + 2 + NB_CHAMPS)
+
+#define FILE_TAILLE			32
+
+typedef struct{
+
+	uint8_t magic;
+	uint8_t reserve;
+	uint16_t octets;		/* taille des enregistrements */
+	uint16_t trames;		/* trames reçues pendant l'apprentissage */
+
+}teach_header_t;
+
+#define DONNEES_ADDR		(EEPROM_TEACH_ADDR + sizeof(teach_header_t))
+#define DONNEES_TAILLE		(EEPROM_TEACH_TAILLE - sizeof(teach_header_t))
+
+_Static_assert(FIFO_SIZE_IS_VALID(FILE_TAILLE), "FILE_TAILLE doit être une puissance de 2");
+_Static_assert(FILE_TAILLE >= 2 * RECORD_MAX + sizeof(teach_header_t), "FILE_TAILLE est trop petite");
+
+/* Enregistrement lu d'avance pendant le rejeu */
+typedef struct{
+
+	bool valide;
+	uint16_t duree;
+	uint8_t champs;
+	bool p;
+	uint8_t valeurs[NB_CHAMPS];
+
+}record_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static teach_state_e etat = TEACH_IDLE;
+
+/* Commandes courantes: dernières enregistrées, ou dernières rejouées */
+static uint8_t valeurs[NB_CHAMPS];
+static bool p_courant;
+
+/* File des octets à écrire dans l'EEPROM */
+static uint8_t file_buffer[FILE_TAILLE];
+static fifo_t file;
+static uint8_t en_attente = 0;
+static uint16_t ecriture_addr;
+static bool entete_attente = FALSE;
+
+/* Apprentissage */
+static uint32_t debut_ms;
+static uint32_t dernier_tick;		/* instant du dernier enregistrement */
+static uint16_t octets;
+static uint16_t trames;
+
+/* Rejeu */
+static uint16_t lecture_addr;
+static uint16_t fin_addr;
+static uint8_t vitesse;
+static uint32_t cumul_tick;			/* instant du dernier enregistrement rejoué */
+static uint32_t dernier_rendu;
+static record_t suivant;
+static bool repos_attente = FALSE;
+static uint16_t rejoues;
+static uint16_t erreur_max;
+static uint32_t erreur_somme;
+static uint8_t angle_max;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void teach_start(void);
+static void teach_stop(void);
+static void replay_start(uint8_t v);
+static void replay_stop(void);
+static bool write_record(const uint8_t* nouv, bool p, uint32_t duree, uint8_t champs);
+static bool push(const uint8_t* octets_record, uint8_t n);
+static void read_record(void);
+static void set_repos(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+teach_state_e teach_get_state(void){
+
+	return etat;
+}
+
+
+void teach_record(uint8_t x, uint8_t y, uint8_t g, uint8_t p, uint8_t angle){
+
+	if(etat != TEACH_RECORDING){
+
+		return;
+	}
+
+	uint8_t nouv[NB_CHAMPS] = {x, y, g, angle};
+	uint8_t champs = 0;
+	uint32_t tick = timebase_elapsed_ms(debut_ms) / TEACH_TICK_MS;
+
+	trames++;
+
+	for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+		if((nouv[i] != valeurs[i]) || (octets == 0)){
+
+			champs = set_bit(champs, i);
+		}
+	}
+
+	// Même commande: la plage en cours s'allonge, rien n'est écrit
+	if((champs == 0) && ((p != 0) == p_courant)){
+
+		return;
+	}
+
+	if(write_record(nouv, p != 0, tick - dernier_tick, champs) == FALSE){
+
+		teach_stop();
+		return;
+	}
+
+	dernier_tick = tick;
+}
+
+
+bool teach_replay(uint8_t* x, uint8_t* y, uint8_t* g, uint8_t* p, uint8_t angle){
+
+	bool rendre = FALSE;
+
+	if(repos_attente){
+
+		repos_attente = FALSE;
+		rendre = TRUE;
+	}
+
+	else if(etat != TEACH_REPLAYING){
+
+		return FALSE;
+	}
+
+	else{
+
+		uint32_t ecoule = timebase_elapsed_ms(debut_ms);
+
+		// Les enregistrements dont l'instant, divisé par la vitesse, est passé
+		while(suivant.valide &&
+			(ecoule * vitesse >= (cumul_tick + suivant.duree) * TEACH_TICK_MS)){
+
+			cumul_tick += suivant.duree;
+
+			for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+				valeurs[i] = suivant.valeurs[i];
+			}
+
+			p_courant = suivant.p;
+
+			// Retard sur l'instant prévu
+			uint32_t prevu = (cumul_tick * TEACH_TICK_MS) / vitesse;
+			uint16_t erreur = (ecoule - prevu > 0xFFFF) ? 0xFFFF : ecoule - prevu;
+
+			if(erreur > erreur_max){
+
+				erreur_max = erreur;
+			}
+
+			erreur_somme += erreur;
+			rejoues++;
+
+			// Écart avec la position de l'encodeur enregistrée
+			uint8_t ecart = (angle > valeurs[CHAMP_ANGLE]) ? angle - valeurs[CHAMP_ANGLE] : valeurs[CHAMP_ANGLE] - angle;
+
+			if(ecart > CLICS_TOUR / 2){
+
+				ecart = CLICS_TOUR - ecart;
+			}
+
+			if(ecart > angle_max){
+
+				angle_max = ecart;
+			}
+
+			rendre = TRUE;
+			read_record();
+		}
+
+		if(suivant.valide == FALSE){
+
+			replay_stop();
+		}
+
+		else if(timebase_elapsed_ms(dernier_rendu) >= TEACH_REPLAY_PERIODE_MS){
+
+			rendre = TRUE;
+		}
+	}
+
+	if(rendre){
+
+		*x = valeurs[CHAMP_X];
+		*y = valeurs[CHAMP_Y];
+		*g = valeurs[CHAMP_G];
+		*p = p_courant ? 1 : 0;
+		dernier_rendu = timebase_millis();
+	}
+
+	return rendre;
+}
+
+
+void teach_process(void){
+
+	if((en_attente > 0) && eeprom_is_ready()){
+
+		eeprom_write_byte((uint8_t*)ecriture_addr, fifo_pop(&file));
+		ecriture_addr++;
+		en_attente--;
+	}
+
+	// L'en-tête est écrit en dernier, après tous les enregistrements
+	if((en_attente == 0) && entete_attente){
+
+		teach_header_t header = {EEPROM_MAGIC, 0, octets, trames};
+
+		entete_attente = FALSE;
+		ecriture_addr = EEPROM_TEACH_ADDR;
+		push((const uint8_t*)&header, sizeof(header));
+	}
+}
+
+
+bool teach_command(const char* ligne, uint8_t longueur){
+
+	if((longueur < 3) || (longueur > 4) || (ligne[0] != '?')){
+
+		return FALSE;
+	}
+
+	if((ligne[1] == 'P') && ((longueur == 3) || ((ligne[2] >= '1') && (ligne[2] <= '9')))){
+
+		replay_start((longueur == 3) ? 1 : ligne[2] - '0');
+		return TRUE;
+	}
+
+	if(longueur != 3){
+
+		return FALSE;
+	}
+
+	switch(ligne[1]){
+	case 'T':
+
+		teach_start();
+		return TRUE;
+
+	case 'S':
+
+		if(etat == TEACH_RECORDING){
+
+			teach_stop();
+		}
+
+		else if(etat == TEACH_REPLAYING){
+
+			replay_stop();
+		}
+		return TRUE;
+
+	default:
+
+		return FALSE;
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void teach_start(void){
+
+	// En-tête invalide d'abord: une session interrompue ne sera pas rejouée
+	teach_header_t header = {0, 0, 0, 0};
+
+	if(etat == TEACH_REPLAYING){
+
+		replay_stop();
+	}
+
+	fifo_init(&file, file_buffer, FILE_TAILLE);
+	en_attente = 0;
+	entete_attente = FALSE;
+	ecriture_addr = EEPROM_TEACH_ADDR;
+	push((const uint8_t*)&header, sizeof(header));
+
+	set_repos();
+	debut_ms = timebase_millis();
+	dernier_tick = 0;
+	octets = 0;
+	trames = 0;
+	etat = TEACH_RECORDING;
+
+	uart_put_string(UART_0, "teach\n");
+}
+
+
+static void teach_stop(void){
+
+	char texte[72];	/* rapport: 66 octets au plus, \0 compris */
+	uint32_t tick = timebase_elapsed_ms(debut_ms) / TEACH_TICK_MS;
+
+	// Dernier enregistrement sans valeur: la durée de la dernière commande
+	if(octets > 0){
+
+		write_record(valeurs, p_courant, tick - dernier_tick, 0);
+	}
+
+	etat = TEACH_IDLE;
+	entete_attente = TRUE;
+
+	uint32_t brut = (uint32_t)trames * TEACH_BRUT_OCTETS;
+	uint16_t total = octets + sizeof(teach_header_t);
+
+	snprintf(texte, sizeof(texte), "teach trames=%u octets=%u brut=%lu ratio=%lu\n", trames, total,
+		(unsigned long)brut, (unsigned long)((brut * 100) / total));
+	uart_put_string(UART_0, texte);
+}
+
+
+static void replay_start(uint8_t v){
+
+	teach_header_t header;
+
+	if((etat != TEACH_IDLE) || (en_attente > 0) || entete_attente){
+
+		uart_put_string(UART_0, "replay occupe\n");
+		return;
+	}
+
+	eeprom_read_block(&header, (const void*)EEPROM_TEACH_ADDR, sizeof(header));
+
+	if((header.magic != EEPROM_MAGIC) || (header.octets == 0) || (header.octets > DONNEES_TAILLE)){
+
+		uart_put_string(UART_0, "replay vide\n");
+		return;
+	}
+
+	set_repos();
+	lecture_addr = DONNEES_ADDR;
+	fin_addr = DONNEES_ADDR + header.octets;
+	vitesse = v;
+	cumul_tick = 0;
+	rejoues = 0;
+	erreur_max = 0;
+	erreur_somme = 0;
+	angle_max = 0;
+	read_record();
+
+	debut_ms = timebase_millis();
+	dernier_rendu = debut_ms;
+	etat = TEACH_REPLAYING;
+
+	uart_put_string(UART_0, "replay\n");
+}
+
+
+static void replay_stop(void){
+
+	char texte[88];	/* rapport: 86 octets au plus, \0 compris */
+
+	snprintf(texte, sizeof(texte), "replay trames=%u duree=%lu erreur max=%u moy=%lu angle max=%u\n",
+		rejoues, (unsigned long)timebase_elapsed_ms(debut_ms), erreur_max,
+		(unsigned long)((rejoues > 0) ? erreur_somme / rejoues : 0), angle_max);
+	uart_put_string(UART_0, texte);
+
+	etat = TEACH_IDLE;
+	set_repos();
+	repos_attente = TRUE;
+}
+
+
+/* Code un enregistrement (voir teach.h) et le met dans la file */
+static bool write_record(const uint8_t* nouv, bool p, uint32_t duree, uint8_t champs){
+
+	uint8_t record[RECORD_MAX];
+	uint8_t n = 0;
+	uint8_t flags = champs | (p ? FLAG_P : 0);
+	bool nibble = (octets > 0);
+
+	// Plage plus longue que 2 octets de durée: des enregistrements sans valeur
+	while(duree > DUREE_MAX){
+
+		record[0] = (p_courant ? FLAG_P : 0) | FLAG_LONG;
+		record[1] = DUREE_MAX & 0xFF;
+		record[2] = DUREE_MAX >> 8;
+
+		if(push(record, 3) == FALSE){
+
+			return FALSE;
+		}
+
+		duree -= DUREE_MAX;
+	}
+
+	for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+		int16_t ecart = (int16_t)nouv[i] - valeurs[i];
+
+		if(read_bit(champs, i) && ((ecart < -8) || (ecart > 7))){
+
+			nibble = FALSE;
+		}
+	}
+
+	if(nibble){
+
+		flags |= FLAG_NIBBLE;
+	}
+
+	if(duree > 0xFF){
+
+		flags |= FLAG_LONG;
+	}
+
+	record[n++] = flags;
+	record[n++] = duree & 0xFF;
+
+	if(duree > 0xFF){
+
+		record[n++] = duree >> 8;
+	}
+
+	bool bas = TRUE;
+
+	for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+		if(read_bit(champs, i) == 0){
+
+			continue;
+		}
+
+		if(nibble){
+
+			uint8_t ecart = (nouv[i] - valeurs[i]) & 0x0F;
+
+			if(bas){
+
+				record[n++] = ecart;
+			}
+
+			else{
+
+				record[n - 1] |= ecart << 4;
+			}
+
+			bas = !bas;
+		}
+
+		else{
+
+			record[n++] = nouv[i];
+		}
+	}
+
+	if(push(record, n) == FALSE){
+
+		return FALSE;
+	}
+
+	for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+		valeurs[i] = nouv[i];
+	}
+
+	p_courant = p;
+
+	return TRUE;
+}
+
+
+/* Met n octets dans la file, à la suite des enregistrements */
+static bool push(const uint8_t* donnees, uint8_t n){
+
+	if((en_attente + n > FILE_TAILLE) ||
+		((etat == TEACH_RECORDING) && (octets + n > DONNEES_TAILLE))){
+
+		return FALSE;
+	}
+
+	for(uint8_t i = 0; i < n; i++){
+
+		fifo_push(&file, donnees[i]);
+	}
+
+	en_attente += n;
+
+	if(etat == TEACH_RECORDING){
+
+		octets += n;
+	}
+
+	return TRUE;
+}
+
+
+/* Lit l'enregistrement suivant dans l'EEPROM, à partir des valeurs courantes */
+static void read_record(void){
+
+	suivant.valide = FALSE;
+
+	if(lecture_addr >= fin_addr){
+
+		return;
+	}
+
+	uint8_t flags = eeprom_read_byte((const uint8_t*)lecture_addr++);
+
+	if(flags & FLAG_INVALID){
+
+		return;
+	}
+
+	suivant.duree = eeprom_read_byte((const uint8_t*)lecture_addr++);
+
+	if(flags & FLAG_LONG){
+
+		suivant.duree |= (uint16_t)eeprom_read_byte((const uint8_t*)lecture_addr++) << 8;
+	}
+
+	suivant.champs = flags & FLAGS_CHAMPS;
+	suivant.p = (flags & FLAG_P) ? TRUE : FALSE;
+
+	bool bas = TRUE;
+	uint8_t octet = 0;
+
+	for(uint8_t i = 0; i < NB_CHAMPS; i++){
+
+		suivant.valeurs[i] = valeurs[i];
+
+		if(read_bit(suivant.champs, i) == 0){
+
+			continue;
+		}
+
+		if(flags & FLAG_NIBBLE){
+
+			if(bas){
+
+				octet = eeprom_read_byte((const uint8_t*)lecture_addr++);
+			}
+
+			// Écart de 4 bits signé
+			int8_t ecart = bas ? (octet & 0x0F) : (octet >> 4);
+
+			if(ecart & 0x08){
+
+				ecart -= 16;
+			}
+
+			suivant.valeurs[i] = valeurs[i] + ecart;
+			bas = !bas;
+		}
+
+		else{
+
+			suivant.valeurs[i] = eeprom_read_byte((const uint8_t*)lecture_addr++);
+		}
+	}
+
+	suivant.valide = (lecture_addr <= fin_addr);
+}
+
+
+static void set_repos(void){
+
+	valeurs[CHAMP_X] = TEACH_X_REPOS;
+	valeurs[CHAMP_Y] = TEACH_Y_REPOS;
+	valeurs[CHAMP_G] = TEACH_G_REPOS;
+	valeurs[CHAMP_ANGLE] = 0;
+	p_courant = FALSE;
+}
@@ -0,0 +1,152 @@
+#ifndef TEACH_H_INCLUDED
+#define TEACH_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file teach.h
+	\brief Apprentissage d'une session manuelle dans l'EEPROM et rejeu
+
+	Pendant l'apprentissage, chaque trame de la manette (x, y, g, p) est enregistrée avec
+	l'angle de l'encodeur (clics) et son instant, en pas de TEACH_TICK_MS. Seuls les
+	changements sont écrits: une commande qui ne change pas pendant plusieurs trames
+	ne prend qu'un enregistrement, dont la durée couvre toute la période (codage par
+	plages). Chaque enregistrement:
+
+		drapeaux durée[1 ou 2] valeurs[...]
+
+		drapeaux	bit 0 à 3: x, y, g, angle présents
+					bit 4: p
+					bit 5: valeurs en écarts de 4 bits signés (-8 à 7) par rapport
+					       à l'enregistrement précédent, deux par octet, sinon en
+					       valeurs complètes d'un octet
+					bit 6: durée sur 2 octets, sinon 1
+					bit 7: toujours 0 (0xFF est l'EEPROM effacée)
+		durée		pas de TEACH_TICK_MS depuis l'enregistrement précédent
+		valeurs		les champs présents, dans l'ordre x, y, g, angle
+
+	Le premier enregistrement donne toutes les valeurs; le dernier, écrit à l'arrêt,
+	n'en donne aucune et sa durée est celle de la dernière commande.
+
+	Les enregistrements suivent l'en-tête à EEPROM_TEACH_ADDR (eeprom_map.h). Les
+	octets passent par une file et sont écrits un à la fois, quand l'EEPROM est prête
+	(3,4 ms par octet): la boucle principale n'attend jamais. L'en-tête est écrit en
+	dernier; une session interrompue (reset) reste donc invalide.
+
+	Le rejeu remplace les trames de la manette par les commandes enregistrées, chaque
+	enregistrement à son instant divisé par la vitesse (1 à 9). À vitesse 1, les
+	mouvements sont reproduits; plus vite, les durées raccourcissent mais les moteurs
+	ne vont pas plus vite: l'écart d'angle mesure alors la différence de position. À
+	la fin, les axes reviennent au repos (TEACH_X_REPOS, ...).
+
+	Commandes reçues sur UART_0:
+
+		?T		début de l'apprentissage (efface la session précédente)
+		?S		fin de l'apprentissage ou du rejeu
+		?P, ?Pn	rejeu à la vitesse n (1 par défaut)
+
+	Rapports envoyés sur UART_0, à la fin de l'apprentissage et du rejeu:
+
+		teach trames=<n> octets=<EEPROM> brut=<octets> ratio=<brut / octets, en %>
+		replay trames=<n> duree=<ms> erreur max=<ms> moy=<ms> angle max=<clics>
+
+	brut compte TEACH_BRUT_OCTETS par trame: la taille sans codage. L'erreur est le
+	retard de chaque enregistrement rejoué sur son instant prévu.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define TEACH_TICK_MS			10
+
+/* Trame sans codage: x, y, g, p, angle et un instant de 16 bits */
+#define TEACH_BRUT_OCTETS		7
+
+/* Commandes au repos, comme au démarrage de la grue */
+#define TEACH_X_REPOS			137
+#define TEACH_Y_REPOS			140
+#define TEACH_G_REPOS			100
+
+/* Période des commandes rendues pendant le rejeu, comme les trames de la manette */
+#define TEACH_REPLAY_PERIODE_MS	100
+
+typedef enum{
+
+	TEACH_IDLE = 0,
+	TEACH_RECORDING,
+	TEACH_REPLAYING
+
+}teach_state_e;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Retourne ce que fait le module
+    \return TEACH_IDLE, TEACH_RECORDING ou TEACH_REPLAYING
+*/
+teach_state_e teach_get_state(void);
+
+/**
+    \brief Enregistre une trame reçue de la manette, pendant l'apprentissage
+	\param[in]	x, y, g, p Les commandes de la trame
+	\param[in]	angle La position de l'encodeur (clics)
+    \return rien.
+
+	Sans effet hors de l'apprentissage. L'apprentissage s'arrête seul quand la zone de
+	l'EEPROM est pleine.
+*/
+void teach_record(uint8_t x, uint8_t y, uint8_t g, uint8_t p, uint8_t angle);
+
+/**
+    \brief Donne les commandes du rejeu, à la place de la trame de la manette
+	\param[out]	x, y, g, p Les commandes, changées seulement si la fonction retourne TRUE
+	\param[in]	angle La position actuelle de l'encodeur (clics)
+    \return TRUE si des commandes sont à appliquer maintenant
+
+	Retourne TRUE quand un enregistrement arrive à son instant, et au moins à toutes
+	les TEACH_REPLAY_PERIODE_MS. Sans effet hors du rejeu.
+*/
+bool teach_replay(uint8_t* x, uint8_t* y, uint8_t* g, uint8_t* p, uint8_t angle);
+
+/**
+    \brief Écrit dans l'EEPROM un octet en attente, si elle est prête
+    \return rien.
+
+	À appeler à chaque passage dans la boucle principale.
+*/
+void teach_process(void);
+
+/**
+    \brief Traite les commandes ?T, ?S et ?P
+	\param[in]	ligne La ligne lue par uart_get_line()
+	\param[in]	longueur Le nombre d'octets de la ligne, '\n' compris
+    \return TRUE si la ligne était une de ces commandes, FALSE sinon
+*/
+bool teach_command(const char* ligne, uint8_t longueur);
+
+#endif /* TEACH_H_INCLUDED */
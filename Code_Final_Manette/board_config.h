@@ -0,0 +1,86 @@
+#ifndef BOARD_CONFIG_H_INCLUDED
+#define BOARD_CONFIG_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file board_config.h
+	\brief Configuration des pilotes communs (Code_Commun) pour la manette
+
+	Voir Code_Commun/board.h pour la liste des choix.
+*/
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Pilotes: aucune sortie MLI, le compteur 1 ne sert que de base de temps */
+#define BOARD_HAS_PWM0			0
+#define BOARD_HAS_PWM2			0
+
+/* Options des pilotes */
+#define BOARD_HAS_PROFILE		0
+#define BOARD_UART_EOL_TIME		0
+
+/* Trames adressées à plusieurs grues sur UART_0 (voir BUS_GRUES dans main.c), comme le
+   board_config.h de la grue */
+#ifndef BOARD_UART_BUS
+#define BOARD_UART_BUS			0
+#endif
+
+/*
+	Pas de mode SLEEP_MODE_ADC: la base de temps retarderait de 3 conversions par trame
+	(0,6 %), plus que la dérive admise par la mesure de latence de la grue (latency.h),
+	pour 8 bits de résolution seulement. Les conversions se font en SLEEP_MODE_IDLE.
+*/
+#define BOARD_ADC_NOISE_REDUCTION	0
+
+/*
+	Brochage: axes y (PA1) et x (PA0) du joystick, glissière (PA3). La pince est le
+	bouton du joystick (PA2), lu en numérique.
+*/
+#define BOARD_ADC_PINS			((1 << PA0) | (1 << PA1) | (1 << PA3))
+
+#define BOARD_LCD_DATA_PORT		PORTC
+#define BOARD_LCD_DATA_DDR		DDRC
+#define BOARD_LCD_CTRL_PORT		PORTA
+#define BOARD_LCD_CTRL_DDR		DDRA
+#define BOARD_LCD_E_PIN			PA7
+#define BOARD_LCD_RW_PIN		PA6
+#define BOARD_LCD_RS_PIN		PA5
+
+/*
+	Taille des tampons de chaque port et de chaque sens: une puissance de 2 jusqu'à 128,
+	ou 0 pour retirer ce sens (voir uart.h).
+*/
+#ifndef UART_0_RX_BUFFER_SIZE
+#define UART_0_RX_BUFFER_SIZE	32	/* télémétrie de la grue (trame.h) */
+#endif
+#ifndef UART_0_TX_BUFFER_SIZE
+#define UART_0_TX_BUFFER_SIZE	16	/* trames vers la grue */
+#endif
+
+#ifndef UART_1_RX_BUFFER_SIZE
+#define UART_1_RX_BUFFER_SIZE	0	/* inutilisé */
+#endif
+#ifndef UART_1_TX_BUFFER_SIZE
+#define UART_1_TX_BUFFER_SIZE	0
+#endif
+
+#endif /* BOARD_CONFIG_H_INCLUDED */
@@ -13,11 +13,326 @@
 #include "lcd.h"
 #include "utils.h"
 #include "uart.h"
+#include "timebase.h"
+#include "soft_timer.h"
+#include "bench.h"
+#include "trame.h"
+#include "idle.h"
 #include <avr/interrupt.h>
 
 //Timer
 #include <time.h>     //For clock(),clock_t
 
+//Priode d'envoi des trames vers la grue
+#define PERIODE_TRAME_MS 100
+
+//Batterie de la grue inconnue aprs 4 trames de tlmtrie manques
+#define PERTE_TELEMETRIE_MS (4 * TRAME_BATT_PERIODE_MS)
+
+//START (PD5) tenu au moins ce temps: mode cartsien plutt qu'automatique
+#define APPUI_LONG_MS 1000
+
+#if BOARD_UART_BUS
+//Grues sur le bus, adresses 1  BUS_GRUES (voir trame.h). Se change  la compilation: -DBUS_GRUES=4
+#ifndef BUS_GRUES
+#define BUS_GRUES 3
+#endif
+
+//Une trame par crneau, aux grues  tour de rle: chacune reoit la sienne  toutes les
+//PERIODE_TRAME_MS, ou moins souvent si le dbit ne laisse pas BUS_GRUES crneaux par priode
+#define BUS_CRENEAU_MIN_MS TRAME_BUS_CRENEAU_MS(UART_BAUDRATE_BPS(DEFAULT_BAUDRATE))
+#define BUS_CRENEAU_MS (PERIODE_TRAME_MS / BUS_GRUES > BUS_CRENEAU_MIN_MS ? PERIODE_TRAME_MS / BUS_GRUES : BUS_CRENEAU_MIN_MS)
+
+_Static_assert(BUS_GRUES >= 1 && BUS_GRUES <= TRAME_BUS_GRUES_MAX, "BUS_GRUES: de 1  TRAME_BUS_GRUES_MAX");
+
+#define GRUES BUS_GRUES
+#define PERIODE_ENVOI_MS BUS_CRENEAU_MS
+#else
+#define GRUES 1
+#define PERIODE_ENVOI_MS PERIODE_TRAME_MS
+#endif
+
+soft_timer_t trame_timer;
+char str[40];
+char str2[40];
+uint8_t t = 0;
+uint8_t seq[GRUES];	//un numro de trame par grue: chacune compte ses trames perdues
+
+//Tlmtrie de chaque grue (voir trame.h)
+char telemetrie[TRAME_BATT_LONGUEUR_BUS];
+uint8_t telemetrie_index = 0;
+trame_batterie_e batterie_etat[GRUES];
+uint16_t batterie_mv[GRUES];
+uint32_t batterie_recue[GRUES];
+
+#if BOARD_UART_BUS
+//Grue de la dernire trame, et grue commande par le joystick: 0 pour toutes, sinon son adresse
+uint8_t bus_adresse = 0;
+uint8_t bus_cible = 0;
+uint8_t bus_pince[BUS_GRUES];	//dernire commande de pince de chaque grue
+uint8_t bus_mode[BUS_GRUES];	//dernier mode choisi pour chaque grue
+bool bus_bouton = FALSE;
+bool bus_arret = FALSE;			//bouton d'arrt tenu  la trame prcdente
+bool bus_choisie = FALSE;		//une grue a t choisie depuis l'appui du bouton d'arrt
+#endif
+
+// tick de 1 ms sur la comparaison B du compteur 1
+ISR (TIMER1_COMPB_vect){
+	OCR1B += PWM1_TICK_PAS;
+	timebase_tick();
+}
+
+// lecture des octets reus de la grue, sans attendre de ligne complte
+static void telemetrie_lire(void){
+	
+	while (uart_is_rx_buffer_empty(UART_0) == FALSE){
+		
+		uint8_t octet = uart_get_byte(UART_0);
+		
+		//Les lignes trop longues (rponses des commandes ?x) sont ignores jusqu'au '\n'
+		if (octet != '\n'){
+			if (telemetrie_index < TRAME_BATT_LONGUEUR_BUS - 1)
+			telemetrie[telemetrie_index] = octet;
+			if (telemetrie_index < 255)
+			telemetrie_index++;
+			continue;
+		}
+		
+		//Sans adresse: une seule grue (la premire); avec: la grue qui rpond
+		uint8_t grue = GRUES;
+		if (telemetrie_index == TRAME_BATT_LONGUEUR - 1 && telemetrie[0] == TRAME_BATT_DEBUT)
+		grue = 0;
+#if BOARD_UART_BUS
+		else if (telemetrie_index == TRAME_BATT_LONGUEUR_BUS - 1 && telemetrie[0] == TRAME_BATT_DEBUT)
+		grue = TRAME_DECODE_7(telemetrie[TRAME_BATT_ADRESSE]) - 1;
+#endif
+		
+		if (grue < GRUES){
+			batterie_etat[grue] = TRAME_DECODE_7(telemetrie[TRAME_BATT_ETAT]);
+			batterie_mv[grue] = TRAME_DECODE_14(telemetrie[TRAME_BATT_MV_BAS], telemetrie[TRAME_BATT_MV_HAUT]);
+			batterie_recue[grue] = timebase_millis();
+		}
+		
+		telemetrie_index = 0;
+	}
+	
+	for (uint8_t i = 0; i < GRUES; i++){
+		if (batterie_etat[i] != TRAME_BATTERIE_INCONNUE && timebase_elapsed_ms(batterie_recue[i]) > PERTE_TELEMETRIE_MS)
+		batterie_etat[i] = TRAME_BATTERIE_INCONNUE;
+	}
+}
+
+// batterie affiche: celle de la grue commande, ou la pire de toutes
+static uint8_t batterie_affichee(void){
+	
+	uint8_t grue = 0;
+	
+#if BOARD_UART_BUS
+	if (bus_cible != 0)
+	return bus_cible - 1;
+	
+	for (uint8_t i = 1; i < GRUES; i++){
+		if (batterie_etat[i] > batterie_etat[grue] ||
+			(batterie_etat[i] == batterie_etat[grue] && batterie_mv[i] < batterie_mv[grue]))
+		grue = i;
+	}
+#endif
+	
+	return grue;
+}
+
+#if BOARD_UART_BUS
+// bouton d'arrt (PD7) tenu: chaque appui du bouton du joystick passe  la grue suivante
+// (toutes, puis 1  BUS_GRUES); la pince ne suit pas le bouton pendant le choix et le mode
+// ne change pas (voir trame_cb())
+static bool bus_choix(void){
+	
+	bool choix = !read_bit(PIND, PD7);
+	bool bouton = !read_bit(PINA, PA2);
+	
+	if (choix && bouton && !bus_bouton){
+		bus_cible = (bus_cible + 1) % (BUS_GRUES + 1);
+		bus_choisie = TRUE;
+	}
+	
+	bus_bouton = bouton;
+	return choix;
+}
+
+// le mode choisi ne va qu' la grue commande, ou  toutes
+static void bus_mode_choisir(uint8_t a){
+	
+	for (uint8_t i = 0; i < BUS_GRUES; i++){
+		if (bus_cible == 0 || bus_cible == i + 1)
+		bus_mode[i] = a;
+	}
+}
+#endif
+
+// lecture des commandes et envoi d'une trame,  toutes les PERIODE_ENVOI_MS
+static void trame_cb(void* arg){
+	
+	BENCH_MARK(BENCH_MARK_FRAME);
+	
+	//Grue de cette trame (0 sans bus), et cran mis  jour une fois par tour des grues
+	uint8_t grue = 0;
+	bool afficher = TRUE;
+#if BOARD_UART_BUS
+	bus_adresse = (bus_adresse % BUS_GRUES) + 1;
+	grue = bus_adresse - 1;
+	afficher = (bus_adresse == BUS_GRUES);
+	bool choix = bus_choix();
+#endif
+	
+	//Instant de la lecture des commandes, pour la mesure de latence de la grue
+	uint16_t temps = timebase_millis() & TRAME_TEMPS_MASQUE;
+	
+	//Une valeur de 10 ('\n') couperait la trame en deux: elle est remplace avant l'envoi
+	//Moteur en x (chariot)
+	uint8_t y = adc_read(PA1);
+	if (y == '\n')
+	y = 11;
+	
+	//Moteur en y (Tourner la fleche)
+	uint8_t x = adc_read(PA0);
+	if(x == '\n')
+	x = 11;
+	
+	//Moteur Glissiere
+	uint8_t g = adc_read(PA3);
+	if (g == '\n')
+	g = 11;
+	
+	//Servomoteur pour la Pince
+	uint8_t p = read_bit(PINA, PA2);
+	
+#if BOARD_UART_BUS
+	//Une autre grue que celle choisie reoit le joystick au neutre et garde sa pince
+	if (bus_cible != 0 && bus_cible != bus_adresse){
+		y = TRAME_NEUTRE_Y;
+		x = TRAME_NEUTRE_X;
+		g = TRAME_NEUTRE_G;
+		p = bus_pince[grue];
+	}
+	else if (choix)
+	p = bus_pince[grue];
+	bus_pince[grue] = p;
+	
+	uart_put_address(UART_0, bus_adresse);
+#endif
+	
+	uart_put_byte(UART_0, y);
+	uart_put_byte(UART_0, x);
+	uart_put_byte(UART_0, g);
+	uart_put_byte(UART_0, p);
+	
+	//Temps
+	t = t + 12;
+	
+	//Programme automation
+	bool auto_start = read_bit(PIND, PD5);
+	bool auto_stop = read_bit(PIND, PD7);
+	static uint8_t a_start = 0;	//garde le dernier mode choisi quand aucun bouton n'est appuy
+	static char mode[40] = "";	//gard jusqu' son affichage
+	static bool start_prec = FALSE;	//START appuy  la trame prcdente
+	static bool start_tenu = FALSE;	//appui de START pas encore dcid
+	static uint32_t start_ms;
+	bool manuel = (auto_stop == FALSE);
+	bool automatique = FALSE;
+	bool cartesien = FALSE;
+	
+#if BOARD_UART_BUS
+	//Le bouton d'arrt tenu sert aussi  choisir la grue (bus_choix()): le mode manuel est
+	//choisi  son relchement, si aucune grue n'a t choisie
+	manuel = (choix == FALSE && bus_arret && !bus_choisie);
+	if (choix == FALSE)
+	bus_choisie = FALSE;
+	bus_arret = choix;
+#endif
+	
+	//START dcide  son relchement (mode auto) ou aprs APPUI_LONG_MS (mode cartsien, le
+	//joystick dplace la charge en X et Y). STOP passe avant: il annule l'appui de START, qui
+	//doit tre relch puis appuy de nouveau
+	if (auto_start == FALSE && !start_prec){
+		start_tenu = TRUE;
+		start_ms = timebase_millis();
+	}
+	start_prec = (auto_start == FALSE);
+	
+	if (auto_stop == FALSE)
+	start_tenu = FALSE;
+	else if (start_tenu && auto_start == FALSE && timebase_elapsed_ms(start_ms) >= APPUI_LONG_MS){
+		cartesien = TRUE;
+		start_tenu = FALSE;
+	}
+	else if (start_tenu && auto_start == TRUE){
+		automatique = TRUE;
+		start_tenu = FALSE;
+	}
+	
+	if (manuel){
+		a_start = TRAME_MODE_MANUEL;
+		sprintf(mode, "mode man");
+	}
+	
+	else if (cartesien) {
+		a_start = TRAME_MODE_CARTESIEN;
+		sprintf(mode, "mode xy");
+	}
+	
+	else if (automatique) {
+		a_start = TRAME_MODE_AUTO;
+		sprintf(mode, "mode auto");
+	}
+	
+#if BOARD_UART_BUS
+	if (manuel || cartesien || automatique)
+	bus_mode_choisir(a_start);
+	uart_put_byte(UART_0, bus_mode[grue]);
+#else
+	uart_put_byte(UART_0, a_start);
+#endif
+	
+	//Numro de trame et instant de lecture (voir trame.h)
+	uart_put_byte(UART_0, TRAME_CODE_7(seq[grue]));
+	uart_put_byte(UART_0, TRAME_CODE_7(temps));
+	uart_put_byte(UART_0, TRAME_CODE_7(temps >> 7));
+	seq[grue]++;
+	
+	uart_put_byte(UART_0, '\n');
+	
+	if (!afficher)
+	return;
+	
+	//Affichage du mode choisi
+	if (mode[0] != '\0'){
+		lcd_clear_display();
+		lcd_set_cursor_position(7,1);
+		lcd_write_string(mode);
+		mode[0] = '\0';
+	}
+	
+	//Affichage LCD Moteur x, y et batterie de la grue
+	uint8_t b = batterie_affichee();
+	if (batterie_etat[b] == TRAME_BATTERIE_INCONNUE)
+	sprintf(str,"x%3d y%3d  --.-%c", x, y, TRAME_BATT_SYMBOLE(batterie_etat[b]));
+	else
+	sprintf(str,"x%3d y%3d  %2u.%u%c", x, y, batterie_mv[b] / 1000, (batterie_mv[b] % 1000) / 100,
+		TRAME_BATT_SYMBOLE(batterie_etat[b]));
+	lcd_set_cursor_position(0,0);
+	lcd_write_string(str);
+	
+	//Affichage LCD Glissiere, Pince, et grue commande sur un bus (* pour toutes)
+#if BOARD_UART_BUS
+	sprintf(str2, "g%3d G%c", g, bus_cible ? '0' + bus_cible : '*');
+#else
+	sprintf(str2, "g: %3d", g);
+#endif
+	lcd_set_cursor_position(0,1);
+	lcd_write_string(str2);
+	lcd_set_cursor_position(15,1);
+}
+
 int main(void)
 {
 	
@@ -38,94 +353,35 @@ int main(void)
 	PORTD = set_bit(PORTD, PD7);
 	
 	
-	lcd_init();
+	//Envoi des trames et base de temps d'abord, LCD en arrire-plan (lcd_process() dans la boucle)
 	uart_init(UART_0);
+	pwm1_init();
 	sei();
-	char str[40];
-	char str2[40];
+	lcd_begin();
 	adc_init();
-	uint8_t t = 0;
+	
+	for (uint8_t i = 0; i < GRUES; i++){
+		seq[i] = 0;
+		batterie_etat[i] = TRAME_BATTERIE_INCONNUE;
+#if BOARD_UART_BUS
+		bus_pince[i] = 1;	//bouton relch
+#endif
+	}
+	
+	//Envoi priodique des trames, sans bloquer la boucle principale
+	soft_timer_init(&trame_timer, trame_cb, NULL);
+	soft_timer_start(&trame_timer, 0, PERIODE_ENVOI_MS);
 	
 	while (1)
 	{
+		BENCH_MARK(BENCH_MARK_LOOP);
+		soft_timer_process();
+		telemetrie_lire();
+		lcd_process();
 		
-		//Moteur en x (chariot)
-		uint8_t y = adc_read(PA1);
-		uart_put_byte(UART_0, y);
-		if (y == 10)
-		y = 11;
-		
-		//Moteur en y (Tourner la fleche)
-		uint8_t x = adc_read(PA0);
-		uart_put_byte(UART_0, x);
-		if(x == 10)
-		x = 11;
-		
-		//Moteur Glissiere
-		uint8_t g = adc_read(PA3);
-		uart_put_byte(UART_0, g);
-		if (g == 10)
-		g = 11;
-		
-		//Servomoteur pour la Pince
-		uint8_t p = read_bit(PINA, PA2);
-		uart_put_byte(UART_0, p);
-		
-		//Temps
-		t = t + 12;
-		
-		//Programme automation
-		bool auto_start = read_bit(PIND, PD5);
-		bool auto_stop = read_bit(PIND, PD7);
-		uint8_t a_start;
-		uint8_t a_stop;
-		char mode[40];
-		
-		if (auto_start == FALSE) {
-			a_start = 1;
-			a_stop = 0;
-			//Affichage
-			lcd_clear_display();
-			sprintf(mode, "mode auto");
-			lcd_set_cursor_position(7,1);
-			lcd_write_string(mode);
-			
-			if (auto_stop == FALSE){
-				a_start = 0;
-				a_stop = 1;
-				//Affichage
-				lcd_clear_display();
-				sprintf(mode, "mode man");
-				lcd_set_cursor_position(7,1);
-				lcd_write_string(mode);
-			}
-		}
-		
-		if (auto_stop == FALSE){
-			a_start = 0;
-			a_stop=1;
-			//Affichage
-			lcd_clear_display();
-			sprintf(mode, "mode man");
-			lcd_set_cursor_position(7,1);
-			lcd_write_string(mode);
-		}
-		
-		uart_put_byte(UART_0, a_start);
-		uart_put_byte(UART_0, '\n');
-		
-		
-		//Affichage LCD Moteur x, y
-		sprintf(str,"x: %3d, y: %3d", x, y);
-		lcd_set_cursor_position(0,0);
-		lcd_write_string(str);
-		
-		//Affichage LCD Glissiere, Pince
-		sprintf(str2, "g: %3d", g);
-		lcd_set_cursor_position(0,1);
-		lcd_write_string(str2);
-		lcd_set_cursor_position(15,1);
-		//DELAY
-		_delay_ms(100);
+		//Veille jusqu'au prochain tick de 1 ms ou octet reu: tout le travail est fait par les minuteries
+		cli();
+		idle_sleep(SLEEP_MODE_IDLE);
+		sei();
 	}
 }
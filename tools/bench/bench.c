@@ -0,0 +1,668 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file bench.c
+	\brief Banc de mesure des microprogrammes de la grue et de la manette sous simavr
+
+	Le programme charge l'image ELF dans un ATmega324A simulé à 8 MHz, lui envoie un
+	scénario de stimuli (trames UART, impulsions de l'encodeur, tensions de l'ADC) et
+	mesure au cycle près:
+
+	- la durée de chaque interruption, de l'entrée dans le vecteur jusqu'au RETI;
+	- la période de la boucle principale (marqueur BENCH_MARK_LOOP);
+	- pour la grue, le délai entre la fin de réception d'une trame (bit d'arrêt du '\n')
+	  et la première écriture dans un registre OCR des moteurs;
+	- pour la manette, la période d'envoi des trames (marqueur BENCH_MARK_FRAME);
+	- la part des cycles passés en veille (voir Code_Commun/idle.h);
+	- la taille en flash et en RAM de l'image.
+
+	Le résultat est écrit en JSON sur la sortie standard.
+
+	Avec -s, les stimuli intégrés sont remplacés par un scénario lu d'un fichier (voir
+	scenario.h). Avec -v, les broches sont enregistrées dans un fichier VCD (voir trace.h).
+
+	Usage: bench [-m mcu] [-t durée_ms] [-s scénario] [-v trace.vcd] grue|manette image.elf
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "sim_io.h"
+#include "sim_interrupts.h"
+#include "sim_cycle_timers.h"
+#include "sim_time.h"
+#include "avr_uart.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+
+#include "bench.h"
+#include "scenario.h"
+#include "trace.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define F_CPU				8000000UL
+
+/* Adresses dans l'espace de données de l'ATmega324A */
+#define ADDR_GPIOR0			0x3E
+#define ADDR_OCR0A			0x47
+#define ADDR_OCR0B			0x48
+#define ADDR_OCR2B			0xB4
+
+#define NB_VECTORS			31
+#define VECTOR_USART0_RX	20
+
+/* Une trame de la manette vers la grue: y, x, g, p, a, '\n' */
+#define FRAME_SIZE			6
+#define FRAME_PERIOD_MS		100
+#define FIRST_FRAME_MS		200
+
+#define ENCODER_PERIOD_MS	50
+#define ENCODER_PULSE_MS	1
+
+/* Tension de la batterie de la grue sur ADC4, après le diviseur: 12 V */
+#define BATTERY_ADC4_MV		2977
+
+/* Octets envoyés à UART_0 pas encore reçus par le microprogramme */
+#define RX_QUEUE_SIZE		4096
+
+typedef enum{
+
+	TARGET_GRUE = 0,
+	TARGET_MANETTE
+
+}target_e;
+
+
+typedef struct{
+
+	uint64_t* v;
+	size_t n;
+	size_t cap;
+
+}samples_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static const char* vector_name[NB_VECTORS] = {
+
+	"RESET", "INT0_vect", "INT1_vect", "INT2_vect",
+	"PCINT0_vect", "PCINT1_vect", "PCINT2_vect", "PCINT3_vect",
+	"WDT_vect", "TIMER2_COMPA_vect", "TIMER2_COMPB_vect", "TIMER2_OVF_vect",
+	"TIMER1_CAPT_vect", "TIMER1_COMPA_vect", "TIMER1_COMPB_vect", "TIMER1_OVF_vect",
+	"TIMER0_COMPA_vect", "TIMER0_COMPB_vect", "TIMER0_OVF_vect", "SPI_STC_vect",
+	"USART0_RX_vect", "USART0_UDRE_vect", "USART0_TX_vect", "ANALOG_COMP_vect",
+	"ADC_vect", "EE_READY_vect", "TWI_vect", "SPM_READY_vect",
+	"USART1_RX_vect", "USART1_UDRE_vect", "USART1_TX_vect"
+};
+
+/* Vecteurs toujours présents dans le rapport, même s'ils n'ont jamais été appelés */
+static const uint8_t reported_vectors[] = {1, 13, 14, 15, 20, 21};
+
+static avr_t* avr = NULL;
+static target_e target;
+
+static samples_t isr_cycles[NB_VECTORS];
+static avr_cycle_count_t isr_start[NB_VECTORS];
+
+static samples_t loop_cycles;
+static avr_cycle_count_t last_loop = 0;
+
+static samples_t frame_cycles;
+static avr_cycle_count_t last_frame = 0;
+
+static samples_t latency_cycles;
+static uint32_t rx_bytes = 0;
+static uint8_t rx_queue[RX_QUEUE_SIZE];
+static uint32_t rx_queue_in = 0;
+static uint32_t rx_queue_out = 0;
+static avr_cycle_count_t frame_end = 0;
+static int waiting_pwm = 0;
+
+static uint32_t tx_bytes = 0;
+static avr_irq_t* uart_input = NULL;
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void samples_add(samples_t* s, uint64_t value){
+
+	if(s->n == s->cap){
+
+		s->cap = s->cap ? s->cap * 2 : 256;
+		s->v = realloc(s->v, s->cap * sizeof(uint64_t));
+
+		if(s->v == NULL){
+
+			perror("realloc");
+			exit(1);
+		}
+	}
+
+	s->v[s->n++] = value;
+}
+
+
+static int compare_u64(const void* a, const void* b){
+
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+
+/* Écrit un objet JSON: nombre, min, max, moyenne, centiles et histogramme par puissances de 2 */
+static void print_samples(const char* name, samples_t* s, const char* indent, int last){
+
+	printf("%s\"%s\": {\"count\": %zu", indent, name, s->n);
+
+	if(s->n != 0){
+
+		uint64_t sum = 0;
+		size_t bucket[65] = {0};
+
+		qsort(s->v, s->n, sizeof(uint64_t), compare_u64);
+
+		for(size_t i = 0; i < s->n; i++){
+
+			uint8_t b = 0;
+
+			sum += s->v[i];
+
+			while((b < 64) && ((1ULL << b) < s->v[i])){
+
+				b++;
+			}
+
+			bucket[b]++;
+		}
+
+		printf(", \"min\": %llu, \"max\": %llu, \"mean\": %.1f",
+			(unsigned long long)s->v[0], (unsigned long long)s->v[s->n - 1], (double)sum / s->n);
+		printf(", \"p50\": %llu, \"p90\": %llu, \"p99\": %llu",
+			(unsigned long long)s->v[(s->n - 1) * 50 / 100],
+			(unsigned long long)s->v[(s->n - 1) * 90 / 100],
+			(unsigned long long)s->v[(s->n - 1) * 99 / 100]);
+
+		printf(", \"histogram\": [");
+
+		int first = 1;
+
+		for(int b = 0; b < 65; b++){
+
+			if(bucket[b] != 0){
+
+				printf("%s{\"le\": %llu, \"n\": %zu}", first ? "" : ", ",
+					(unsigned long long)(b < 64 ? (1ULL << b) : UINT64_MAX), bucket[b]);
+				first = 0;
+			}
+		}
+
+		printf("]");
+	}
+
+	printf("}%s\n", last ? "" : ",");
+}
+
+
+static int is_reported(int vector){
+
+	if(isr_cycles[vector].n != 0){
+
+		return 1;
+	}
+
+	for(size_t i = 0; i < sizeof(reported_vectors); i++){
+
+		if(reported_vectors[i] == vector){
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+static void isr_running_hook(struct avr_irq_t* irq, uint32_t value, void* param){
+
+	intptr_t vector = (intptr_t)param;
+
+	if(value){
+
+		isr_start[vector] = avr->cycle;
+	}
+
+	else if(isr_start[vector] != 0){
+
+		samples_add(&isr_cycles[vector], avr->cycle - isr_start[vector]);
+		isr_start[vector] = 0;
+	}
+}
+
+
+/* Un octet envoyé à UART_0: simavr le livre au rythme du débit, dans l'ordre */
+static void uart_input_hook(struct avr_irq_t* irq, uint32_t value, void* param){
+
+	rx_queue[rx_queue_in++ % RX_QUEUE_SIZE] = value;
+}
+
+
+/* Un octet reçu par UART_0: l'interruption RX devient en attente au bit d'arrêt */
+static void rx_pending_hook(struct avr_irq_t* irq, uint32_t value, void* param){
+
+	uint8_t byte = 0;
+
+	if(value == 0){
+
+		return;
+	}
+
+	rx_bytes++;
+
+	if(rx_queue_out != rx_queue_in){
+
+		byte = rx_queue[rx_queue_out++ % RX_QUEUE_SIZE];
+	}
+
+	// Une trame se termine par '\n'
+	if((target == TARGET_GRUE) && (byte == '\n')){
+
+		frame_end = avr->cycle;
+		waiting_pwm = 1;
+	}
+}
+
+
+static void marker_write(struct avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param){
+
+	avr->data[addr] = v;
+
+	trace_mark(v);
+
+	switch(v){
+
+	case BENCH_MARK_LOOP:
+
+		if(last_loop != 0){
+
+			samples_add(&loop_cycles, avr->cycle - last_loop);
+		}
+
+		last_loop = avr->cycle;
+		break;
+
+	case BENCH_MARK_FRAME:
+
+		if(last_frame != 0){
+
+			samples_add(&frame_cycles, avr->cycle - last_frame);
+		}
+
+		last_frame = avr->cycle;
+		break;
+
+	default:
+		break;
+	}
+}
+
+
+/* Le module des compteurs garde son propre traitement de l'écriture: on ne fait que noter */
+static void ocr_write(struct avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param){
+
+	if(waiting_pwm){
+
+		samples_add(&latency_cycles, avr->cycle - frame_end);
+		waiting_pwm = 0;
+	}
+}
+
+
+static void tx_hook(struct avr_irq_t* irq, uint32_t value, void* param){
+
+	tx_bytes++;
+}
+
+
+static void set_pin(char port, int pin, int level){
+
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), pin), level);
+}
+
+
+/* Grue: une trame toutes les 100 ms, le chariot alterne entre deux vitesses dans le même sens */
+static avr_cycle_count_t send_frame(struct avr_t* avr, avr_cycle_count_t when, void* param){
+
+	static uint32_t n = 0;
+	uint8_t x = (n & 1) ? 220 : 180;
+	uint8_t frame[FRAME_SIZE] = {140, x, 100, 0, 0, '\n'};
+
+	for(int i = 0; i < FRAME_SIZE; i++){
+
+		avr_raise_irq(uart_input, frame[i]);
+	}
+
+	n++;
+
+	return when + avr_usec_to_cycles(avr, FRAME_PERIOD_MS * 1000UL);
+}
+
+
+/* Grue: impulsion sur INT0 (PD2), sens horaire (PD3 au niveau haut) */
+static avr_cycle_count_t encoder_pulse(struct avr_t* avr, avr_cycle_count_t when, void* param){
+
+	static int level = 0;
+
+	level = !level;
+	set_pin('D', 2, level);
+
+	return when + avr_usec_to_cycles(avr,
+		(level ? ENCODER_PULSE_MS : ENCODER_PERIOD_MS - ENCODER_PULSE_MS) * 1000UL);
+}
+
+
+/* Manette: le joystick du chariot balaie lentement toute la plage */
+static avr_cycle_count_t sweep_joystick(struct avr_t* avr, avr_cycle_count_t when, void* param){
+
+	static uint32_t mv = 0;
+
+	mv = (mv + 125) % 5000;
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC1), mv);
+
+	return when + avr_usec_to_cycles(avr, 50000);
+}
+
+
+static void setup_grue(int builtin){
+
+	// Fins de course et broche PA3 au repos, encodeur au repos
+	set_pin('A', 0, 1);
+	set_pin('A', 1, 1);
+	set_pin('A', 3, 1);
+	set_pin('D', 2, 0);
+	set_pin('D', 3, 1);
+
+	avr_register_io_write(avr, ADDR_OCR0A, ocr_write, NULL);
+	avr_register_io_write(avr, ADDR_OCR0B, ocr_write, NULL);
+	avr_register_io_write(avr, ADDR_OCR2B, ocr_write, NULL);
+
+	// Batterie chargée (voir Code_Final_Grue/battery.h)
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC4), BATTERY_ADC4_MV);
+
+	if(!builtin){
+
+		return;
+	}
+
+	avr_cycle_timer_register_usec(avr, FIRST_FRAME_MS * 1000UL, send_frame, NULL);
+	avr_cycle_timer_register_usec(avr, FIRST_FRAME_MS * 1000UL, encoder_pulse, NULL);
+}
+
+
+static void setup_manette(int builtin){
+
+	// Boutons relâchés (niveau haut)
+	set_pin('A', 2, 1);
+	set_pin('D', 5, 1);
+	set_pin('D', 7, 1);
+
+	// Joysticks au centre
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0), 2500);
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC1), 2500);
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC3), 2500);
+
+	if(!builtin){
+
+		return;
+	}
+
+	avr_cycle_timer_register_usec(avr, FIRST_FRAME_MS * 1000UL, sweep_joystick, NULL);
+}
+
+
+static void usage(const char* prog){
+
+	fprintf(stderr, "usage: %s [-m mcu] [-t duree_ms] [-s scenario] [-v trace.vcd] grue|manette image.elf\n",
+		prog);
+	exit(2);
+}
+
+/* ----------------------------------------------------------------------------
+Main
+---------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[]){
+
+	const char* mcu = "atmega324a";
+	uint32_t sim_ms = 2000;
+	const char* scenario = NULL;
+	const char* vcd = NULL;
+	elf_firmware_t f;
+	int opt;
+
+	while((opt = getopt(argc, argv, "m:t:s:v:")) != -1){
+
+		switch(opt){
+
+		case 'm':
+			mcu = optarg;
+			break;
+
+		case 't':
+			sim_ms = strtoul(optarg, NULL, 0);
+			break;
+
+		case 's':
+			scenario = optarg;
+			break;
+
+		case 'v':
+			vcd = optarg;
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if(argc - optind != 2){
+
+		usage(argv[0]);
+	}
+
+	if(strcmp(argv[optind], "grue") == 0){
+
+		target = TARGET_GRUE;
+	}
+
+	else if(strcmp(argv[optind], "manette") == 0){
+
+		target = TARGET_MANETTE;
+	}
+
+	else{
+
+		usage(argv[0]);
+	}
+
+	if((scenario != NULL) && (scenario_load(scenario) != 0)){
+
+		return 1;
+	}
+
+	memset(&f, 0, sizeof(f));
+
+	if(elf_read_firmware(argv[optind + 1], &f) != 0){
+
+		fprintf(stderr, "%s: impossible de lire %s\n", argv[0], argv[optind + 1]);
+		return 1;
+	}
+
+	strncpy(f.mmcu, mcu, sizeof(f.mmcu) - 1);
+	f.frequency = F_CPU;
+
+	avr = avr_make_mcu_by_name(f.mmcu);
+
+	if(avr == NULL){
+
+		fprintf(stderr, "%s: microcontrôleur %s inconnu de simavr\n", argv[0], f.mmcu);
+		return 1;
+	}
+
+	avr_init(avr);
+	avr_load_firmware(avr, &f);
+	avr->log = LOG_WARNING;
+	avr->vcc = 5000;
+	avr->avcc = 5000;
+	avr->aref = 5000;
+
+	// Mesure de toutes les interruptions
+	for(intptr_t v = 1; v < NB_VECTORS; v++){
+
+		avr_irq_t* irq = avr_get_interrupt_irq(avr, v);
+
+		if(irq != NULL){
+
+			avr_irq_register_notify(irq + AVR_INT_IRQ_RUNNING, isr_running_hook, (void*)v);
+		}
+	}
+
+	avr_irq_register_notify(avr_get_interrupt_irq(avr, VECTOR_USART0_RX) + AVR_INT_IRQ_PENDING,
+		rx_pending_hook, NULL);
+
+	avr_register_io_write(avr, ADDR_GPIOR0, marker_write, NULL);
+
+	// UART_0: pas d'écho sur la console, on compte les octets envoyés
+	uint32_t flags = 0;
+
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+
+	uart_input = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+	avr_irq_register_notify(uart_input, uart_input_hook, NULL);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+		tx_hook, NULL);
+
+	if((vcd != NULL) && (trace_start(avr, vcd, target == TARGET_GRUE) != 0)){
+
+		return 1;
+	}
+
+	if(target == TARGET_GRUE){
+
+		setup_grue(scenario == NULL);
+	}
+
+	else{
+
+		setup_manette(scenario == NULL);
+	}
+
+	if(scenario != NULL){
+
+		scenario_start(avr);
+	}
+
+	avr_cycle_count_t end = avr_usec_to_cycles(avr, sim_ms * 1000ULL);
+	int state = cpu_Running;
+
+	// Cycles passés en veille (instruction SLEEP), que simavr saute jusqu'au prochain événement
+	avr_cycle_count_t sleep_cycles = 0;
+
+	while((avr->cycle < end) && (state != cpu_Done) && (state != cpu_Crashed)){
+
+		avr_cycle_count_t before = avr->cycle;
+		int previous = state;
+
+		state = avr_run(avr);
+
+		if(previous == cpu_Sleeping){
+
+			sleep_cycles += avr->cycle - before;
+		}
+	}
+
+	trace_stop();
+
+	// Rapport
+	printf("{\n");
+	printf("  \"firmware\": \"%s\",\n", target == TARGET_GRUE ? "grue" : "manette");
+	printf("  \"mcu\": \"%s\",\n", f.mmcu);
+	printf("  \"f_cpu\": %lu,\n", F_CPU);
+	printf("  \"sim_ms\": %u,\n", sim_ms);
+	printf("  \"crashed\": %s,\n", state == cpu_Crashed ? "true" : "false");
+	printf("  \"memory\": {\"flash\": %u, \"data\": %u, \"bss\": %u, \"ram\": %u},\n",
+		f.flashsize, f.datasize, f.bsssize, f.datasize + f.bsssize);
+
+	printf("  \"isr\": {\n");
+
+	int nb = 0;
+
+	for(int v = 1; v < NB_VECTORS; v++){
+
+		nb += is_reported(v);
+	}
+
+	for(int v = 1; v < NB_VECTORS; v++){
+
+		if(is_reported(v)){
+
+			print_samples(vector_name[v], &isr_cycles[v], "    ", --nb == 0);
+		}
+	}
+
+	printf("  },\n");
+
+	print_samples("loop", &loop_cycles, "  ", 0);
+
+	if(target == TARGET_GRUE){
+
+		print_samples("frame_to_pwm", &latency_cycles, "  ", 0);
+	}
+
+	else{
+
+		print_samples("frame_period", &frame_cycles, "  ", 0);
+	}
+
+	printf("  \"sleep\": {\"cycles\": %llu, \"permille\": %llu},\n",
+		(unsigned long long)sleep_cycles, (unsigned long long)(sleep_cycles * 1000 / avr->cycle));
+	printf("  \"uart0\": {\"rx_bytes\": %u, \"tx_bytes\": %u}\n", rx_bytes, tx_bytes);
+	printf("}\n");
+
+	return state == cpu_Crashed ? 1 : 0;
+}
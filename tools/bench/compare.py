@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Compare deux rapports JSON du banc de mesure (bench).
+
+Usage: compare.py [--fail-above POURCENT] reference.json courant.json
+
+Affiche chaque mesure qui a changé. Avec --fail-above, le code de retour est 1 si une
+mesure de coût (moyenne, maximum, centiles, taille mémoire) augmente de plus du
+pourcentage donné.
+"""
+
+import argparse
+import json
+import sys
+
+# Mesures où une augmentation est une régression
+COST_KEYS = {"min", "max", "mean", "p50", "p90", "p99", "flash", "data", "bss", "ram"}
+
+
+def leaves(node, path=""):
+    """Retourne les valeurs numériques du rapport, indexées par leur chemin."""
+    out = {}
+    if isinstance(node, dict):
+        for key, value in node.items():
+            if key == "histogram":
+                continue
+            out.update(leaves(value, path + "." + key if path else key))
+    elif isinstance(node, (int, float)) and not isinstance(node, bool):
+        out[path] = node
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--fail-above", type=float, default=None)
+    parser.add_argument("reference")
+    parser.add_argument("current")
+    args = parser.parse_args()
+
+    with open(args.reference) as f:
+        ref = leaves(json.load(f))
+    with open(args.current) as f:
+        cur = leaves(json.load(f))
+
+    regression = False
+
+    for path in sorted(set(ref) | set(cur)):
+        a = ref.get(path)
+        b = cur.get(path)
+        if a == b:
+            continue
+        if a is None or b is None:
+            print("%-40s %12s -> %12s" % (path, a, b))
+            continue
+        delta = (b - a) * 100.0 / a if a else float("inf")
+        flag = ""
+        if (args.fail_above is not None and path.split(".")[-1] in COST_KEYS
+                and delta > args.fail_above):
+            flag = "  <-- régression"
+            regression = True
+        print("%-40s %12g -> %12g  %+7.1f %%%s" % (path, a, b, delta, flag))
+
+    return 1 if regression else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Taille de chaque module d'un microprogramme, lue dans le fichier .map de avr-ld.
+
+Usage: mapreport.py [--ram 2048] fichier.map [dossier_su]
+
+Pour chaque objet (ou bibliothèque): octets de .text (flash), .data (RAM et flash,
+chaînes constantes comprises), .bss et .noinit (RAM). Avec le dossier des fichiers
+.su produits par -fstack-usage (make memory), ajoute la plus grande pile d'une fonction
+du module.
+
+La pile réelle est la somme des piles de la chaîne d'appels la plus profonde, plus les
+interruptions qui s'y ajoutent: la colonne pile est une borne basse. La mesure en
+marche est donnée par la commande ?M de la grue (Code_Final_Grue/stack.h).
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+SECTIONS = [".text", ".data", ".bss", ".noinit"]
+
+OUTPUT_RE = re.compile(r"^(\.\w+)\b")
+INPUT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+INPUT_NAME_RE = re.compile(r"^ (\.\S+|COMMON)(.*)$")
+
+
+def module_name(path):
+    """Nom court: l'objet sans .o, ou la bibliothèque pour un membre d'archive."""
+    path = path.strip()
+    archive = re.match(r"(.*\.a)\((.*)\)$", path)
+    if archive:
+        return os.path.basename(archive.group(1))
+    name = os.path.basename(path)
+    return name[:-2] if name.endswith(".o") else name
+
+
+def parse_map(path):
+    sizes = defaultdict(lambda: dict.fromkeys(SECTIONS, 0))
+    in_map = False
+    output = None
+    pending = None
+
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+
+            out = OUTPUT_RE.match(line)
+            if out:
+                output = out.group(1)
+                pending = None
+                continue
+
+            # Nom de la section d'entrée seul sur sa ligne quand il est trop long
+            name = INPUT_NAME_RE.match(line)
+            if name:
+                rest = name.group(2)
+                if not rest.strip():
+                    pending = name.group(1)
+                    continue
+                line = rest
+            elif pending is None:
+                continue
+            pending = None
+
+            entry = INPUT_RE.match(line)
+            if entry and output in SECTIONS:
+                size = int(entry.group(2), 16)
+                if size:
+                    sizes[module_name(entry.group(3))][output] += size
+    return sizes
+
+
+def parse_stack(folder):
+    stack = {}
+    for entry in sorted(os.listdir(folder)):
+        if not entry.endswith(".su"):
+            continue
+        best = (0, "")
+        with open(os.path.join(folder, entry)) as f:
+            for line in f:
+                fields = line.rstrip("\n").split("\t")
+                if len(fields) >= 2:
+                    function = fields[0].rsplit(":", 1)[-1]
+                    best = max(best, (int(fields[1]), function))
+        stack[entry[:-3]] = best
+    return stack
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--ram", type=int, default=2048)
+    parser.add_argument("map")
+    parser.add_argument("su", nargs="?")
+    args = parser.parse_args()
+
+    sizes = parse_map(args.map)
+    stack = parse_stack(args.su) if args.su else {}
+
+    print(args.map)
+    print("%-24s %6s %6s %6s %6s  %s" % ("module", "text", "data", "bss", "noinit", "pile max"))
+    totals = dict.fromkeys(SECTIONS, 0)
+    for module in sorted(sizes, key=lambda m: -(sizes[m][".data"] + sizes[m][".bss"] + sizes[m][".noinit"])):
+        s = sizes[module]
+        for key in SECTIONS:
+            totals[key] += s[key]
+        frame = stack.get(module)
+        frame_text = "%4u %s" % frame if frame else ""
+        print("%-24s %6u %6u %6u %6u  %s" % (module, s[".text"], s[".data"], s[".bss"], s[".noinit"], frame_text))
+
+    ram = totals[".data"] + totals[".bss"] + totals[".noinit"]
+    print("%-24s %6u %6u %6u %6u" % ("total", totals[".text"], totals[".data"], totals[".bss"], totals[".noinit"]))
+    print("RAM statique %u / %u octets, reste %u pour la pile et le tas" % (ram, args.ram, args.ram - ram))
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
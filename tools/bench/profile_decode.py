@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Décode les envois du profilage de la grue (Code_Final_Grue/profile.c).
+
+Usage: profile_decode.py [--baud 9600] source
+
+La source est un port série (exe.: /dev/ttyUSB0, demande pyserial) ou un fichier
+contenant les octets reçus. Chaque envoi valide est affiché: nombre de passages, durée
+min, max et moyenne de chaque zone en µs, les compteurs et le tampon circulaire.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+VERSION = 1
+
+ZONES = ["frame", "motor", "lcd", "sprintf", "isr_int0", "isr_tick", "isr_servo",
+         "isr_uart0_rx", "isr_uart0_udre", "isr_uart1_rx", "isr_uart1_udre"]
+COUNTERS = ["frame", "loop"]
+EVENTS = ["mode", "time_over"]
+
+HEADER = struct.Struct("<BBBBBH")   # 'P' version nb_zones nb_counters nb_ring now
+ZONE = struct.Struct("<HHHI")       # count min max sum
+COUNTER = struct.Struct("<H")
+RING = struct.Struct("<HBH")        # time id value
+
+
+def name(names, index, prefix):
+    return names[index] if index < len(names) else "%s%d" % (prefix, index)
+
+
+def parse(buf):
+    """Retourne (envoi, octets consommés), ou (None, octets à sauter) si invalide,
+    ou (None, 0) s'il manque des octets."""
+    if len(buf) < len(SYNC) + HEADER.size:
+        return None, 0
+    tag, version, nb_zones, nb_counters, nb_ring, now = HEADER.unpack_from(buf, 2)
+    if tag != ord("P") or version != VERSION:
+        return None, 1
+    size = (len(SYNC) + HEADER.size + nb_zones * ZONE.size + nb_counters * COUNTER.size
+            + nb_ring * RING.size + 1)
+    if len(buf) < size:
+        return None, 0
+    if sum(buf[2:size - 1]) & 0xFF != buf[size - 1]:
+        return None, 1
+
+    offset = len(SYNC) + HEADER.size
+    dump = {"now": now, "zones": {}, "counters": {}, "ring": []}
+    for i in range(nb_zones):
+        count, vmin, vmax, total = ZONE.unpack_from(buf, offset)
+        offset += ZONE.size
+        dump["zones"][name(ZONES, i, "zone")] = (count, vmin, vmax, total)
+    for i in range(nb_counters):
+        (value,) = COUNTER.unpack_from(buf, offset)
+        offset += COUNTER.size
+        dump["counters"][name(COUNTERS, i, "counter")] = value
+    for _ in range(nb_ring):
+        dump["ring"].append(RING.unpack_from(buf, offset))
+        offset += RING.size
+    return dump, size
+
+
+def show(dump):
+    print("--- now=%u" % dump["now"])
+    print("%-16s %7s %7s %7s %9s" % ("zone", "count", "min", "max", "mean"))
+    for zone, (count, vmin, vmax, total) in dump["zones"].items():
+        if count:
+            print("%-16s %7u %7u %7u %9.1f" % (zone, count, vmin, vmax, total / count))
+    print("counters: " + ", ".join("%s=%u" % kv for kv in dump["counters"].items()))
+    for time, ident, value in dump["ring"]:
+        if ident & 0x80:
+            print("  %5u event %-10s %u" % (time, name(EVENTS, ident & 0x7F, "event"), value))
+        else:
+            print("  %5u zone  %-10s %u us" % (time, name(ZONES, ident, "zone"), value))
+    sys.stdout.flush()
+
+
+def chunks(args):
+    if args.source.startswith("/dev/"):
+        import serial
+        port = serial.Serial(args.source, args.baud, timeout=1)
+        while True:
+            yield port.read(256)
+    else:
+        with open(args.source, "rb") as f:
+            yield f.read()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("source")
+    args = parser.parse_args()
+
+    buf = bytearray()
+    for chunk in chunks(args):
+        buf += chunk
+        while True:
+            start = buf.find(SYNC)
+            if start < 0:
+                del buf[:max(0, len(buf) - 1)]
+                break
+            del buf[:start]
+            dump, used = parse(buf)
+            if used == 0:
+                break
+            del buf[:used]
+            if dump is not None:
+                show(dump)
+
+
+if __name__ == "__main__":
+    main()
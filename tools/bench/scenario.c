@@ -0,0 +1,373 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file scenario.c
+	\brief Scénario de stimuli lu d'un fichier texte et rejoué pendant la simulation
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "sim_avr.h"
+#include "sim_irq.h"
+#include "sim_io.h"
+#include "sim_time.h"
+#include "sim_cycle_timers.h"
+#include "avr_uart.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+
+#include "scenario.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define LINE_SIZE		256
+#define MAX_BYTES		32
+
+typedef enum{
+
+	EVENT_UART = 0,
+	EVENT_PIN,
+	EVENT_ADC
+
+}event_type_e;
+
+
+typedef struct{
+
+	uint32_t at_ms;
+	size_t seq;				/* ordre dans le fichier */
+	event_type_e type;
+	char port;
+	uint8_t pin;
+	uint32_t value;
+	uint8_t bytes[MAX_BYTES];
+	uint8_t nb_bytes;
+
+}event_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static event_t* events = NULL;
+static size_t nb_events = 0;
+static size_t cap_events = 0;
+static size_t next_event = 0;
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void add_event(const event_t* e){
+
+	if(nb_events == cap_events){
+
+		cap_events = cap_events ? cap_events * 2 : 64;
+		events = realloc(events, cap_events * sizeof(event_t));
+
+		if(events == NULL){
+
+			perror("realloc");
+			exit(1);
+		}
+	}
+
+	events[nb_events] = *e;
+	events[nb_events].seq = nb_events;
+	nb_events++;
+}
+
+
+static int compare_events(const void* a, const void* b){
+
+	const event_t* x = a;
+	const event_t* y = b;
+
+	// Même instant: l'ordre du fichier est gardé
+	if(x->at_ms != y->at_ms){
+
+		return (x->at_ms > y->at_ms) - (x->at_ms < y->at_ms);
+	}
+
+	return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+
+/* Lit les octets d'une commande frame ou uart, retourne le nombre lu ou -1 */
+static int parse_bytes(char* args, uint8_t* bytes){
+
+	int n = 0;
+	char* tok;
+
+	while((tok = strtok(args, " \t\r\n")) != NULL){
+
+		char* end;
+		unsigned long v = strtoul(tok, &end, 0);
+
+		args = NULL;
+
+		if((*end != '\0') || (v > 255) || (n == MAX_BYTES)){
+
+			return -1;
+		}
+
+		bytes[n++] = v;
+	}
+
+	return n;
+}
+
+
+static int parse_line(char* line, event_t* e, uint32_t* period_ms, uint32_t* count){
+
+	char* time = strtok(line, " \t\r\n");
+	char* cmd = strtok(NULL, " \t\r\n");
+	char* args = strtok(NULL, "");
+	char* end;
+
+	if((time == NULL) || (cmd == NULL)){
+
+		return -1;
+	}
+
+	memset(e, 0, sizeof(*e));
+	*period_ms = 0;
+	*count = 1;
+
+	e->at_ms = strtoul(time, &end, 10);
+
+	if(*end == '+'){
+
+		*period_ms = strtoul(end + 1, &end, 10);
+
+		if(*end != '*'){
+
+			return -1;
+		}
+
+		*count = strtoul(end + 1, &end, 10);
+	}
+
+	if(*end != '\0'){
+
+		return -1;
+	}
+
+	if(args == NULL){
+
+		args = "";
+	}
+
+	if(strcmp(cmd, "frame") == 0){
+
+		e->type = EVENT_UART;
+
+		if(parse_bytes(args, e->bytes) != 5){
+
+			return -1;
+		}
+
+		e->bytes[5] = '\n';
+		e->nb_bytes = 6;
+	}
+
+	else if(strcmp(cmd, "uart") == 0){
+
+		int n = parse_bytes(args, e->bytes);
+
+		if(n <= 0){
+
+			return -1;
+		}
+
+		e->type = EVENT_UART;
+		e->nb_bytes = n;
+	}
+
+	else if(strcmp(cmd, "pin") == 0){
+
+		char pin[8];
+		unsigned level;
+
+		if((sscanf(args, "%7s %u", pin, &level) != 2) || (strlen(pin) != 2) || (level > 1)){
+
+			return -1;
+		}
+
+		e->type = EVENT_PIN;
+		e->port = toupper((unsigned char)pin[0]);
+		e->pin = pin[1] - '0';
+		e->value = level;
+
+		if((e->port < 'A') || (e->port > 'D') || (e->pin > 7)){
+
+			return -1;
+		}
+	}
+
+	else if(strcmp(cmd, "adc") == 0){
+
+		unsigned channel;
+		unsigned mv;
+
+		if((sscanf(args, "%u %u", &channel, &mv) != 2) || (channel > 7)){
+
+			return -1;
+		}
+
+		e->type = EVENT_ADC;
+		e->pin = channel;
+		e->value = mv;
+	}
+
+	else{
+
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void run_event(avr_t* avr, const event_t* e){
+
+	switch(e->type){
+
+	case EVENT_UART:
+
+		for(uint8_t i = 0; i < e->nb_bytes; i++){
+
+			avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT), e->bytes[i]);
+		}
+		break;
+
+	case EVENT_PIN:
+
+		avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(e->port), e->pin), e->value);
+		break;
+
+	case EVENT_ADC:
+
+		avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0 + e->pin), e->value);
+		break;
+	}
+}
+
+
+static avr_cycle_count_t run_events(struct avr_t* avr, avr_cycle_count_t when, void* param){
+
+	uint32_t now_ms = events[next_event].at_ms;
+
+	while((next_event < nb_events) && (events[next_event].at_ms == now_ms)){
+
+		run_event(avr, &events[next_event]);
+		next_event++;
+	}
+
+	if(next_event == nb_events){
+
+		return 0;
+	}
+
+	return when + avr_usec_to_cycles(avr, (events[next_event].at_ms - now_ms) * 1000UL);
+}
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int scenario_load(const char* path){
+
+	FILE* file = fopen(path, "r");
+	char line[LINE_SIZE];
+	unsigned line_no = 0;
+
+	if(file == NULL){
+
+		perror(path);
+		return -1;
+	}
+
+	while(fgets(line, sizeof(line), file) != NULL){
+
+		char* p = line;
+		event_t e;
+		uint32_t period_ms;
+		uint32_t count;
+
+		line_no++;
+
+		// Un # commence un commentaire jusqu'à la fin de la ligne
+		if(strchr(p, '#') != NULL){
+
+			*strchr(p, '#') = '\0';
+		}
+
+		while(isspace((unsigned char)*p)){
+
+			p++;
+		}
+
+		if(*p == '\0'){
+
+			continue;
+		}
+
+		if(parse_line(p, &e, &period_ms, &count) != 0){
+
+			fprintf(stderr, "%s:%u: ligne invalide\n", path, line_no);
+			fclose(file);
+			return -1;
+		}
+
+		for(uint32_t i = 0; i < count; i++){
+
+			add_event(&e);
+			e.at_ms += period_ms;
+		}
+	}
+
+	fclose(file);
+
+	qsort(events, nb_events, sizeof(event_t), compare_events);
+
+	return 0;
+}
+
+
+void scenario_start(avr_t* avr){
+
+	next_event = 0;
+
+	if(nb_events != 0){
+
+		avr_cycle_timer_register(avr, avr_usec_to_cycles(avr, events[0].at_ms * 1000UL),
+			run_events, NULL);
+	}
+}
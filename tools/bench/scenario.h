@@ -0,0 +1,68 @@
+#ifndef SCENARIO_H_INCLUDED
+#define SCENARIO_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file scenario.h
+	\brief Scénario de stimuli lu d'un fichier texte et rejoué pendant la simulation
+
+	Une ligne par événement. Un # commence un commentaire et les lignes vides sont
+	ignorées:
+
+		<temps> <commande> <arguments...>
+
+	Le temps est en ms depuis le démarrage. La forme début+période*nombre répète
+	l'événement: 200+100*20 le place à 200, 300, ..., 2100 ms.
+
+	Commandes:
+
+		frame y x g p a		trame de la manette sur UART_0 (le '\n' est ajouté)
+		uart o1 o2 ...		octets bruts sur UART_0 (décimal ou 0x..)
+		pin <port><bit> n	niveau d'une broche d'entrée, exe.: pin D2 1
+		adc <canal> mV		tension sur une entrée de l'ADC
+
+	Exe.: voir scenarios/grue_chariot.txt
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include "sim_avr.h"
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Lit un fichier de scénario
+	\param[in]	path Le fichier à lire
+    \return 0, ou -1 en cas d'erreur (le message indique la ligne fautive)
+*/
+int scenario_load(const char* path);
+
+/**
+    \brief Programme les événements du scénario dans le simulateur
+	\param[in]	avr Le microcontrôleur simulé, après avr_load_firmware()
+    \return rien.
+*/
+void scenario_start(avr_t* avr);
+
+#endif /* SCENARIO_H_INCLUDED */
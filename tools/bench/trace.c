@@ -0,0 +1,198 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file trace.c
+	\brief Trace des broches en fichier VCD (GTKWave) pendant la simulation
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "sim_avr.h"
+#include "sim_irq.h"
+#include "sim_io.h"
+#include "sim_vcd_file.h"
+#include "avr_ioport.h"
+#include "avr_timer.h"
+#include "avr_uart.h"
+
+#include "trace.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Vidage du fichier VCD toutes les 10 ms de temps simulé */
+#define FLUSH_PERIOD_US		10000
+
+typedef struct{
+
+	char port;
+	uint8_t pin;
+	const char* name;
+
+}pin_signal_t;
+
+
+typedef struct{
+
+	char timer;
+	uint8_t irq;
+	const char* name;
+
+}pwm_signal_t;
+
+enum{
+
+	MARK_IRQ_VALUE = 0,
+	MARK_IRQ_STROBE,
+	MARK_IRQ_COUNT
+};
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static const pin_signal_t crane_pins[] = {
+
+	{'B', 3, "pb3_fleche"},
+	{'B', 4, "pb4_chariot"},
+	{'D', 6, "pd6_glissiere"},
+	{'D', 5, "pd5_servo"},
+	{'B', 0, "pb0_dir_glissiere"},
+	{'B', 1, "pb1_dir_fleche"},
+	{'B', 2, "pb2_dir_chariot"},
+	{'D', 2, "pd2_int0"},
+	{'D', 3, "pd3_enc_dir"},
+};
+
+static const pwm_signal_t crane_pwm[] = {
+
+	{'0', TIMER_IRQ_OUT_PWM0, "pwm_fleche"},
+	{'0', TIMER_IRQ_OUT_PWM1, "pwm_chariot"},
+	{'2', TIMER_IRQ_OUT_PWM1, "pwm_glissiere"},
+};
+
+static const pin_signal_t controller_pins[] = {
+
+	{'A', 2, "pa2_pince"},
+	{'D', 5, "pd5_auto_start"},
+	{'D', 7, "pd7_auto_stop"},
+};
+
+static const pin_signal_t common_pins[] = {
+
+	{'A', 7, "pa7_lcd_e"},
+};
+
+static const char* mark_names[MARK_IRQ_COUNT] = {"8>mark", "mark_strobe"};
+
+static avr_vcd_t vcd;
+static avr_irq_t* mark_irq = NULL;
+static uint8_t strobe = 0;
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void add_pins(avr_t* avr, const pin_signal_t* pins, size_t nb){
+
+	for(size_t i = 0; i < nb; i++){
+
+		avr_vcd_add_signal(&vcd,
+			avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(pins[i].port), pins[i].pin),
+			1, pins[i].name);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int trace_start(avr_t* avr, const char* path, int crane){
+
+	if(avr_vcd_init(avr, path, &vcd, FLUSH_PERIOD_US) != 0){
+
+		fprintf(stderr, "trace: impossible d'ouvrir %s\n", path);
+		return -1;
+	}
+
+	if(crane){
+
+		add_pins(avr, crane_pins, sizeof(crane_pins) / sizeof(crane_pins[0]));
+
+		for(size_t i = 0; i < sizeof(crane_pwm) / sizeof(crane_pwm[0]); i++){
+
+			avr_vcd_add_signal(&vcd,
+				avr_io_getirq(avr, AVR_IOCTL_TIMER_GETIRQ(crane_pwm[i].timer), crane_pwm[i].irq),
+				8, crane_pwm[i].name);
+		}
+	}
+
+	else{
+
+		add_pins(avr, controller_pins, sizeof(controller_pins) / sizeof(controller_pins[0]));
+	}
+
+	add_pins(avr, common_pins, sizeof(common_pins) / sizeof(common_pins[0]));
+
+	avr_vcd_add_signal(&vcd, avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT),
+		8, "uart0_rx");
+	avr_vcd_add_signal(&vcd, avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+		8, "uart0_tx");
+
+	// Signaux propres au banc pour les marqueurs du microprogramme
+	mark_irq = avr_alloc_irq(&avr->irq_pool, 0, MARK_IRQ_COUNT, mark_names);
+
+	avr_vcd_add_signal(&vcd, mark_irq + MARK_IRQ_VALUE, 8, "mark");
+	avr_vcd_add_signal(&vcd, mark_irq + MARK_IRQ_STROBE, 1, "mark_strobe");
+
+	avr_vcd_start(&vcd);
+
+	return 0;
+}
+
+
+void trace_mark(uint8_t id){
+
+	if(mark_irq == NULL){
+
+		return;
+	}
+
+	strobe = !strobe;
+	avr_raise_irq(mark_irq + MARK_IRQ_VALUE, id);
+	avr_raise_irq(mark_irq + MARK_IRQ_STROBE, strobe);
+}
+
+
+void trace_stop(void){
+
+	if(mark_irq == NULL){
+
+		return;
+	}
+
+	avr_vcd_close(&vcd);
+	mark_irq = NULL;
+}
@@ -0,0 +1,83 @@
+#ifndef TRACE_H_INCLUDED
+#define TRACE_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file trace.h
+	\brief Trace des broches en fichier VCD (GTKWave) pendant la simulation
+
+	Signaux enregistrés pour la grue:
+
+		pb3_fleche, pb4_chariot, pd6_glissiere	broches MLI des moteurs
+		pwm_fleche, pwm_chariot, pwm_glissiere	rapport cyclique vu par simavr (8 bits)
+		pd5_servo								signal du servomoteur
+		pb0_dir_glissiere, pb1_dir_fleche,
+		pb2_dir_chariot							directions
+		pd2_int0, pd3_enc_dir					encodeur
+
+	Pour la manette: pa2_pince, pd5_auto_start, pd7_auto_stop.
+
+	Pour les deux cartes:
+
+		uart0_rx, uart0_tx		octets de UART_0 (8 bits). simavr simule l'UART à
+								l'octet: la valeur change au bit d'arrêt et les broches
+								RXD0/TXD0 ne basculent pas bit par bit.
+		pa7_lcd_e				strobe E de l'afficheur
+		mark					dernier marqueur BENCH_MARK() (voir bench.h)
+		mark_strobe				change d'état à chaque marqueur, pour voir deux
+								marqueurs identiques de suite
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdint.h>
+#include "sim_avr.h"
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Ouvre le fichier VCD et commence l'enregistrement
+	\param[in]	avr Le microcontrôleur simulé, après avr_init()
+	\param[in]	path Le fichier VCD à écrire
+	\param[in]	crane Non nul pour les signaux de la grue, 0 pour ceux de la manette
+    \return 0, ou -1 si le fichier n'a pu être ouvert
+*/
+int trace_start(avr_t* avr, const char* path, int crane);
+
+/**
+    \brief Ajoute un marqueur BENCH_MARK() dans la trace
+	\param[in]	id Le marqueur écrit par le microprogramme
+    \return rien.
+
+	Sans effet si la trace n'est pas démarrée.
+*/
+void trace_mark(uint8_t id);
+
+/**
+    \brief Termine l'enregistrement et ferme le fichier VCD
+    \return rien.
+*/
+void trace_stop(void);
+
+#endif /* TRACE_H_INCLUDED */
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Taille en flash, en RAM et en EEPROM de chaque image, lue avec avr-size.
+
+Usage: sizes.py [--flash 32768] [--ram 2048] [--eeprom 1024] out/<carte>-<configuration>/<carte>.elf...
+
+Flash: .text et .data (valeurs initiales). RAM: .data, .bss et .noinit, sans la pile ni
+le tas. Chaque ligne donne aussi l'écart avec la première configuration de la même carte
+(debug avec make sizes). Le détail par module est donné par tools/bench/mapreport.py.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+
+def sections(elf):
+    out = subprocess.run(["avr-size", "-A", elf], check=True, capture_output=True, text=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(".") and fields[1].isdigit():
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def config_name(elf):
+    """out/grue-release/grue.elf -> ("grue", "grue-release")"""
+    folder = os.path.basename(os.path.dirname(os.path.abspath(elf)))
+    board = os.path.splitext(os.path.basename(elf))[0]
+    return board, folder or board
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--flash", type=int, default=32768)
+    parser.add_argument("--ram", type=int, default=2048)
+    parser.add_argument("--eeprom", type=int, default=1024)
+    parser.add_argument("elf", nargs="+")
+    args = parser.parse_args()
+
+    print("%-20s %6s %6s %7s %5s %6s %7s %6s" %
+          ("configuration", "flash", "%", "écart", "RAM", "%", "écart", "EEPROM"))
+    first = {}
+    for elf in args.elf:
+        board, name = config_name(elf)
+        s = sections(elf)
+        flash = s.get(".text", 0) + s.get(".data", 0)
+        ram = s.get(".data", 0) + s.get(".bss", 0) + s.get(".noinit", 0)
+        eeprom = s.get(".eeprom", 0)
+        ref_flash, ref_ram = first.setdefault(board, (flash, ram))
+        print("%-20s %6u %5.1f%% %+7d %5u %5.1f%% %+7d %6u" %
+              (name, flash, 100.0 * flash / args.flash, flash - ref_flash,
+               ram, 100.0 * ram / args.ram, ram - ref_ram, eeprom))
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,346 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file bus.c
+	\brief Débit du bus de plusieurs grues, de 1 à TRAME_BUS_GRUES_MAX grues
+
+	Le harnais est la grue d'adresse 1, compilée avec BOARD_UART_BUS à 1. Pour chaque
+	nombre de grues, la manette est simulée pendant -t secondes de bus: une trame par
+	créneau, précédée de l'adresse de la grue, à tour de rôle comme main.c de la manette
+	(créneau de max(PERIODE_TRAME_MS / grues, TRAME_BUS_CRENEAU_MS()), DEFAULT_BAUDRATE).
+
+	Une trame sur TRONQUEE_PERIODE adressées à la grue 1 perd ses deux derniers octets:
+	l'adresse suivante doit la terminer, et la grue la rejeter. Chaque trame décodée doit
+	être la dernière trame complète envoyée à la grue 1: une autre est étrangère.
+
+	La grue 1 répond à chaque trame décodée par une trame de télémétrie. Les sorties des
+	grues sont reliées: son émetteur ne doit tenir TXD0 (TXEN0 à 1) que pendant sa
+	réponse, et la relâcher dès le dernier octet parti.
+
+	Par nombre de grues, le résultat donne la période de mise à jour de chaque grue,
+	l'occupation du bus (sortie de la manette, et réponses des grues à toutes les
+	TRAME_BATT_PERIODE_MS au plus), et les interruptions de réception de la grue 1 avec
+	le filtrage de l'USART (MPCM0) et sans. Il est écrit en JSON sur la sortie standard;
+	le code de retour est 1 pour une trame perdue ou étrangère, une commande hors plage,
+	une erreur de nb_line ou TXD0 tenue hors d'une réponse.
+
+	Usage: bus [-t secondes] [-s graine]
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "harness.h"
+#include "trame.h"
+#include "uart.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#if !BOARD_UART_BUS
+#error "bus.c se compile avec -DBOARD_UART_BUS=1"
+#endif
+
+/* Comme main.c de la manette */
+#define PERIODE_TRAME_MS	100
+#define BPS					UART_BAUDRATE_BPS(DEFAULT_BAUDRATE)
+#define CRENEAU_MIN_MS		TRAME_BUS_CRENEAU_MS(BPS)
+
+#define GRUE				1
+#define TRONQUEE_PERIODE	50
+
+typedef struct{
+
+	unsigned long sent;			/* trames complètes adressées à la grue 1 */
+	unsigned long truncated;	/* trames tronquées adressées à la grue 1 */
+	unsigned long decoded;
+	unsigned long dropped;
+	unsigned long foreign;
+	unsigned long replies;		/* réponses de la grue 1 */
+	unsigned long tx_held;		/* TXD0 tenue au repos, ou relâchée pendant une réponse */
+
+}frames_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static command_frame_t attendue;
+static bool attendue_libre = FALSE;
+static frames_t frames;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog);
+static bool run(unsigned grues, unsigned long duree_ms, bool dernier);
+static void frame(uint8_t adresse, uint8_t seq, bool tronquee, command_frame_t* trame);
+static uint8_t valeur(void);
+static void loop(void);
+static void reply(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int main(int argc, char** argv){
+
+	unsigned long secondes = 60;
+	unsigned seed = 1;
+	bool erreur = FALSE;
+	int opt;
+
+	while((opt = getopt(argc, argv, "t:s:")) != -1){
+
+		switch(opt){
+		case 't':
+			secondes = strtoul(optarg, NULL, 0);
+			break;
+
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if(secondes == 0){
+
+		usage(argv[0]);
+	}
+
+	srand(seed);
+
+	printf("[\n");
+
+	for(unsigned grues = 1; grues <= TRAME_BUS_GRUES_MAX; grues++){
+
+		if(!run(grues, secondes * 1000, grues == TRAME_BUS_GRUES_MAX)){
+
+			erreur = TRUE;
+		}
+	}
+
+	printf("]\n");
+
+	return erreur ? 1 : 0;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog){
+
+	fprintf(stderr, "usage: %s [-t secondes] [-s graine]\n", prog);
+	exit(2);
+}
+
+
+/* Un nombre de grues: la manette envoie ses trames pendant duree_ms, résultat en JSON */
+static bool run(unsigned grues, unsigned long duree_ms, bool dernier){
+
+	unsigned creneau_ms = (PERIODE_TRAME_MS / grues > CRENEAU_MIN_MS) ? PERIODE_TRAME_MS / grues : CRENEAU_MIN_MS;
+	unsigned periode_ms = grues * creneau_ms;
+	unsigned long creneaux = duree_ms / creneau_ms;
+	uint8_t seq[TRAME_BUS_GRUES_MAX + 1] = {0};
+	unsigned long envoyes = 0;
+	command_frame_t trame;
+
+	harness_init();
+	uart_set_address(UART_0, GRUE);
+
+	memset(&frames, 0, sizeof(frames));
+	attendue_libre = FALSE;
+
+	// Adressée et sans rien à envoyer: TXD0 relâchée tout de suite
+	frames.tx_held += harness_tx_enabled();
+
+	for(unsigned long k = 0; k < creneaux; k++){
+
+		uint8_t adresse = (k % grues) + 1;
+		bool tronquee = FALSE;
+
+		if(adresse == GRUE){
+
+			tronquee = ((frames.sent + frames.truncated) % TRONQUEE_PERIODE) == TRONQUEE_PERIODE - 1;
+		}
+
+		frame(adresse, seq[adresse]++, tronquee, &trame);
+		envoyes += 1 + (tronquee ? TRAME_LONGUEUR - 2 : TRAME_LONGUEUR);
+
+		if(adresse == GRUE){
+
+			if(tronquee){
+
+				frames.truncated++;
+			}
+
+			else{
+
+				// Une trame complète encore attendue est perdue
+				frames.dropped += attendue_libre;
+				frames.sent++;
+				attendue = trame;
+				attendue_libre = TRUE;
+			}
+		}
+
+		loop();
+	}
+
+	// Une dernière adresse termine une trame tronquée en fin de mesure
+	harness_receive_bus(UART_BROADCAST, TRUE);
+	loop();
+
+	frames.dropped += attendue_libre;
+
+	const harness_stats_t* s = harness_get_stats();
+	double secondes = (double)(creneaux * creneau_ms) / 1000;
+
+	// Une grue répond à la première trame après TRAME_BATT_PERIODE_MS (bus.h de la grue)
+	unsigned reponse_ms = ((TRAME_BATT_PERIODE_MS + periode_ms - 1) / periode_ms) * periode_ms;
+	double bus_bits_s = envoyes * TRAME_BUS_BITS / secondes;
+	double reponses_bits_s = grues * TRAME_BATT_LONGUEUR_BUS * TRAME_BUS_BITS * 1000.0 / reponse_ms;
+
+	printf("  {\n");
+	printf("    \"cranes\": %u,\n", grues);
+	printf("    \"bps\": %lu,\n", (unsigned long)BPS);
+	printf("    \"slot_ms\": %u,\n", creneau_ms);
+	printf("    \"period_ms\": %u,\n", periode_ms);
+	printf("    \"update_hz\": %.2f,\n", 1000.0 / periode_ms);
+	printf("    \"bus_bytes_per_s\": %.0f,\n", envoyes / secondes);
+	printf("    \"bus_load_pct\": %.1f,\n", 100.0 * bus_bits_s / BPS);
+	printf("    \"reply_ms\": %u,\n", reponse_ms);
+	printf("    \"reply_load_pct\": %.1f,\n", 100.0 * reponses_bits_s / BPS);
+	printf("    \"crane\": {\"frames_per_s\": %.2f, \"rx_isr_per_s\": %.1f, \"rx_isr_per_s_unfiltered\": %.1f},\n",
+		frames.decoded / secondes, (s->rx_bytes - s->filtered) / secondes, s->rx_bytes / secondes);
+	printf("    \"frames\": {\"sent\": %lu, \"truncated\": %lu, \"rejected\": %u, \"dropped\": %lu, \"foreign\": %lu},\n",
+		frames.sent, frames.truncated, s->invalid, frames.dropped, frames.foreign);
+	printf("    \"tx\": {\"replies\": %lu, \"held\": %lu},\n", frames.replies, frames.tx_held);
+	printf("    \"pwm_errors\": %u,\n", s->pwm_errors);
+	printf("    \"line_errors\": %u\n", s->line_errors);
+	printf("  }%s\n", dernier ? "" : ",");
+
+	return (frames.dropped == 0) && (frames.foreign == 0) && (s->invalid == frames.truncated) &&
+		(frames.tx_held == 0) && (s->pwm_errors == 0) && (s->line_errors == 0);
+}
+
+
+/* Adresse puis trame de commande, comme trame_cb() de la manette */
+static void frame(uint8_t adresse, uint8_t seq, bool tronquee, command_frame_t* trame){
+
+	uint16_t temps = rand() & TRAME_TEMPS_MASQUE;
+	uint8_t octets[TRAME_LONGUEUR];
+
+	// y à '?' ferait prendre la trame pour une commande ?x (command.c): cette perte ne
+	// vient pas du bus, replay la mesure déjà
+	do{
+		trame->y = valeur();
+	}while(trame->y == '?');
+
+	trame->x = valeur();
+	trame->g = valeur();
+	trame->p = rand() & 1;
+	trame->a = TRAME_MODE_MANUEL;
+	trame->has_seq = TRUE;
+	trame->seq = seq & TRAME_SEQ_MASQUE;
+
+	octets[TRAME_Y] = trame->y;
+	octets[TRAME_X] = trame->x;
+	octets[TRAME_G] = trame->g;
+	octets[TRAME_P] = trame->p;
+	octets[TRAME_A] = trame->a;
+	octets[TRAME_SEQ] = TRAME_CODE_7(seq);
+	octets[TRAME_TEMPS_BAS] = TRAME_CODE_7(temps);
+	octets[TRAME_TEMPS_HAUT] = TRAME_CODE_7(temps >> 7);
+	octets[TRAME_LONGUEUR - 1] = '\n';
+
+	harness_receive_bus(adresse, TRUE);
+
+	for(uint8_t i = 0; i < (tronquee ? TRAME_LONGUEUR - 2 : TRAME_LONGUEUR); i++){
+
+		harness_receive_bus(octets[i], FALSE);
+	}
+}
+
+
+/* Une valeur du joystick, jamais '\n' (remplacée par la manette) */
+static uint8_t valeur(void){
+
+	uint8_t v = rand();
+
+	return (v == '\n') ? 11 : v;
+}
+
+
+/* La boucle principale de la grue lit les lignes reçues pendant le créneau */
+static void loop(void){
+
+	command_frame_t trame;
+	int type;
+
+	while((type = harness_loop(&trame)) >= 0){
+
+		if(type != COMMAND_FRAME){
+
+			continue;
+		}
+
+		frames.decoded++;
+
+		if(attendue_libre && (trame.y == attendue.y) && (trame.x == attendue.x) && (trame.g == attendue.g) &&
+			(trame.p == attendue.p) && (trame.seq == attendue.seq)){
+
+			attendue_libre = FALSE;
+		}
+
+		else{
+
+			frames.foreign++;
+		}
+
+		reply();
+	}
+}
+
+
+/* Télémétrie de la grue 1, comme battery_send_telemetry(): TXD0 tenue pendant l'envoi */
+static void reply(void){
+
+	char texte[TRAME_BATT_LONGUEUR_BUS + 1] = {TRAME_BATT_DEBUT, TRAME_CODE_7(TRAME_BATTERIE_OK),
+		TRAME_CODE_7(0), TRAME_CODE_7(0), TRAME_CODE_7(GRUE), '\n', '\0'};
+
+	uart_put_string(UART_0, texte);
+
+	bool tenue = harness_tx_enabled();
+	uint16_t octets = harness_transmit();
+
+	frames.replies++;
+	frames.tx_held += !tenue || harness_tx_enabled() || (octets != TRAME_BATT_LONGUEUR_BUS);
+}
@@ -0,0 +1,184 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file fuzz.c
+	\brief Cible de fuzzing guidé par la couverture du chemin de réception de la grue
+
+	Le premier octet de l'entrée donne le nombre d'octets reçus entre deux passages
+	dans la boucle principale (1 à 64); les suivants sont le flux reçu. Après le flux,
+	la cible envoie un '\n' puis une trame valide connue, un octet par passage, comme
+	une manette qui reprend après une coupure. L'exécution s'arrête (abort) si:
+
+	- une commande des moteurs ou de la pince sort de la correspondance de command.h;
+	- nb_line du tampon diffère du nombre de '\n' qu'il contient;
+	- la trame connue n'est pas décodée telle quelle: la réception est désynchronisée.
+
+	Une boucle sans fin dans uart_get_line() est signalée par le délai de libFuzzer
+	(-timeout), une lecture hors tampon par AddressSanitizer.
+
+	Compilée avec -DFUZZ_STANDALONE, la cible lit ses entrées de fichiers ou de
+	l'entrée standard: pour rejouer un cas trouvé sans clang, ou pour AFL.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include "harness.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define PAQUET_MAX	64
+
+/* Trame valide envoyée après le flux */
+static const uint8_t reprise[TRAME_LONGUEUR] = {
+
+	140, 137, 100, 0, 0, TRAME_CODE_7(5), TRAME_CODE_7(0), TRAME_CODE_7(0), '\n'
+};
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void check(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size){
+
+	command_frame_t trame;
+
+	if(size == 0){
+
+		return 0;
+	}
+
+	size_t paquet = 1 + data[0] % PAQUET_MAX;
+
+	harness_init();
+
+	for(size_t i = 1; i < size; i += paquet){
+
+		for(size_t j = i; (j < i + paquet) && (j < size); j++){
+
+			harness_receive(data[j]);
+		}
+
+		harness_loop(&trame);
+		check();
+	}
+
+	while(harness_loop(&trame) >= 0){
+
+		check();
+	}
+
+	// Reprise: un '\n' termine la ligne en cours, puis la trame connue
+	bool recue = FALSE;
+	int type;
+
+	harness_receive('\n');
+	harness_loop(&trame);
+
+	for(size_t i = 0; i < sizeof(reprise); i++){
+
+		harness_receive(reprise[i]);
+
+		while((type = harness_loop(&trame)) >= 0){
+
+			recue = (type == COMMAND_FRAME) && trame.has_seq && (trame.seq == 5) &&
+				(trame.x == 137) && (trame.y == 140) && (trame.g == 100);
+		}
+
+		check();
+	}
+
+	if(!recue){
+
+		fprintf(stderr, "trame de reprise non reçue: réception désynchronisée\n");
+		abort();
+	}
+
+	return 0;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void check(void){
+
+	const harness_stats_t* s = harness_get_stats();
+
+	if(s->pwm_errors != 0){
+
+		fprintf(stderr, "commande hors correspondance (command.h)\n");
+		abort();
+	}
+
+	if(s->line_errors != 0){
+
+		fprintf(stderr, "nb_line différent du nombre de '\\n' du tampon\n");
+		abort();
+	}
+}
+
+#ifdef FUZZ_STANDALONE
+
+static void run(FILE* f){
+
+	static uint8_t data[1 << 16];
+	size_t n = fread(data, 1, sizeof(data), f);
+
+	LLVMFuzzerTestOneInput(data, n);
+}
+
+
+int main(int argc, char** argv){
+
+	if(argc < 2){
+
+		run(stdin);
+	}
+
+	for(int i = 1; i < argc; i++){
+
+		FILE* f = fopen(argv[i], "rb");
+
+		if(f == NULL){
+
+			fprintf(stderr, "%s: impossible de lire %s\n", argv[0], argv[i]);
+			return 2;
+		}
+
+		run(f);
+		fclose(f);
+	}
+
+	return 0;
+}
+
+#endif /* FUZZ_STANDALONE */
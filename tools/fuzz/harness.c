@@ -0,0 +1,340 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file harness.c
+	\brief Chemin de réception de la grue sur Linux, avec une USART simulée
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "harness.h"
+
+/* uart.c est compilé ici plutôt qu'à part: le harnais lit ainsi l'état de rx_fifo_0
+   (plein, nombre de lignes) sans rien ajouter à l'interface du pilote */
+#include "uart.c"
+
+#include "motor.h"
+#include "servo.h"
+#include "kinematics.h"
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+volatile uint8_t avr_io[256];
+
+static harness_stats_t stats;
+
+/* Dernière commande reçue par les moteurs et la pince */
+static uint8_t duty[MOTOR_NB];
+static bool dir[MOTOR_NB];
+static uint16_t pince;
+
+/* Commande attendue selon la correspondance de command.h */
+static uint8_t ref_duty[MOTOR_NB];
+static bool ref_dir[MOTOR_NB];
+static uint16_t ref_pince;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void reference(uint8_t x, uint8_t y, uint8_t g, uint8_t p);
+static void reference_set(motor_e motor, bool sens, int valeur);
+static uint8_t count_lines(void);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void harness_init(void){
+
+	memset((void*)avr_io, 0, sizeof(avr_io));
+	memset(&stats, 0, sizeof(stats));
+
+	memset(duty, 0, sizeof(duty));
+	memset(ref_duty, 0, sizeof(ref_duty));
+
+	for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+		dir[i] = FALSE;
+		ref_dir[i] = FALSE;
+	}
+
+	pince = COMMAND_PINCE_OUVERTE_US;
+	ref_pince = COMMAND_PINCE_OUVERTE_US;
+
+	uart_init(UART_0);
+	sei();
+}
+
+
+void harness_receive(uint8_t byte){
+
+	stats.rx_bytes++;
+
+	if(fifo_is_full(&rx_fifo_0)){
+
+		if(fifo_nb_line(&rx_fifo_0) == 0){
+
+			stats.resync++;
+		}
+
+		else{
+
+			stats.overflow++;
+		}
+	}
+
+	UDR0 = byte;
+	USART0_RX_vect();
+
+	if(fifo_nb_line(&rx_fifo_0) != count_lines()){
+
+		stats.line_errors++;
+	}
+}
+
+
+#if BOARD_UART_BUS
+void harness_receive_bus(uint8_t byte, bool adresse){
+
+	if(!adresse && read_bit(UCSR0A, MPCM0)){
+
+		stats.rx_bytes++;
+		stats.filtered++;
+		return;
+	}
+
+	UCSR0B = adresse ? set_bit(UCSR0B, RXB80) : clear_bit(UCSR0B, RXB80);
+	harness_receive(byte);
+}
+
+
+uint16_t harness_transmit(void){
+
+	uint16_t octets = 0;
+
+	while(read_bit(UCSR0B, UDRIE0)){
+
+		USART0_UDRE_vect();
+		octets++;
+	}
+
+	return octets;
+}
+
+
+bool harness_tx_enabled(void){
+
+	return read_bit(UCSR0B, TXEN0) != 0;
+}
+#endif
+
+
+int harness_loop(command_frame_t* trame){
+
+	char msg[HARNESS_LINE_SIZE];
+
+	if(uart_rx_buffer_nb_line(UART_0) <= 0){
+
+		return -1;
+	}
+
+	uint8_t longueur = uart_get_line(UART_0, msg, HARNESS_LINE_SIZE);
+	command_e type = command_parse(msg, longueur, trame);
+
+	stats.lines++;
+
+	switch(type){
+	case COMMAND_FRAME:
+
+		stats.frames++;
+
+		command_apply(trame->x, trame->y, trame->g, trame->p);
+		reference(trame->x, trame->y, trame->g, trame->p);
+
+		if((memcmp(duty, ref_duty, sizeof(duty)) != 0) || (pince != ref_pince)){
+
+			stats.pwm_errors++;
+		}
+
+		for(uint8_t i = 0; i < MOTOR_NB; i++){
+
+			if((ref_duty[i] != 0) && (dir[i] != ref_dir[i])){
+
+				stats.pwm_errors++;
+			}
+		}
+		break;
+
+	case COMMAND_QUERY:
+
+		stats.queries++;
+		break;
+
+	default:
+
+		stats.invalid++;
+		break;
+	}
+
+	if(fifo_nb_line(&rx_fifo_0) != count_lines()){
+
+		stats.line_errors++;
+	}
+
+	return type;
+}
+
+
+uint16_t harness_pending(void){
+
+	if(fifo_is_full(&rx_fifo_0)){
+
+		return (uint16_t)rx_fifo_0.mask + 1;
+	}
+
+	return (rx_fifo_0.in_offset - rx_fifo_0.out_offset) & rx_fifo_0.mask;
+}
+
+
+const harness_stats_t* harness_get_stats(void){
+
+	return &stats;
+}
+
+/* ----------------------------------------------------------------------------
+Remplacement des pilotes de la grue
+---------------------------------------------------------------------------- */
+
+void motor_set(motor_e motor, bool sens, uint8_t rapport){
+
+	dir[motor] = sens;
+	duty[motor] = rapport;
+}
+
+
+void motor_set_duty(motor_e motor, uint8_t rapport){
+
+	duty[motor] = rapport;
+}
+
+
+void servo_set_position(uint16_t position_us){
+
+	pince = position_us;
+}
+
+
+/* Mode cartésien: sans position de la grue, la vitesse dans le plan passe telle quelle */
+void kinematics_jog(int16_t vx, int16_t vy, kinematics_jog_t* jog){
+
+	jog->chariot = vx;
+	jog->fleche = vy;
+}
+
+
+uint32_t timebase_micros(void){
+
+	return 0;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Correspondance de command.h, en entiers: aucun calcul ne peut déborder sur 8 bits */
+static void reference(uint8_t x, uint8_t y, uint8_t g, uint8_t p){
+
+	if(x == 137){
+
+		ref_duty[MOTOR_CHARIOT] = 0;
+	}
+
+	else if(x < 135){
+
+		reference_set(MOTOR_CHARIOT, TRUE, 255 - 2 * (int)x);
+	}
+
+	else if(x >= 140){
+
+		reference_set(MOTOR_CHARIOT, FALSE, x);
+	}
+
+	if(y == 140){
+
+		ref_duty[MOTOR_FLECHE] = 0;
+	}
+
+	else if(y < 130){
+
+		reference_set(MOTOR_FLECHE, TRUE, 255 - 2 * (int)y);
+	}
+
+	else if(y > 145){
+
+		reference_set(MOTOR_FLECHE, FALSE, y);
+	}
+
+	if((g > 50) && (g < 205)){
+
+		ref_duty[MOTOR_GLISSIERE] = 0;
+	}
+
+	else if(g > 205){
+
+		reference_set(MOTOR_GLISSIERE, TRUE, g);
+	}
+
+	else if(g <= 50){
+
+		reference_set(MOTOR_GLISSIERE, FALSE, 255 - 2 * (int)g);
+	}
+
+	ref_pince = (p == 1) ? COMMAND_PINCE_FERMEE_US : COMMAND_PINCE_OUVERTE_US;
+}
+
+
+static void reference_set(motor_e motor, bool sens, int valeur){
+
+	ref_dir[motor] = sens;
+	ref_duty[motor] = (valeur < 0) ? 0 : (valeur > 255) ? 255 : valeur;
+}
+
+
+/* Nombre de '\n' entre les index de sortie et d'entrée du tampon de réception */
+static uint8_t count_lines(void){
+
+	uint16_t n = harness_pending();
+	uint8_t lignes = 0;
+
+	for(uint16_t i = 0; i < n; i++){
+
+		if(rx_fifo_0.ptr[(rx_fifo_0.out_offset + i) & rx_fifo_0.mask] == FIFO_LINE_SEPERATOR){
+
+			lignes++;
+		}
+	}
+
+	return lignes;
+}
@@ -0,0 +1,134 @@
+#ifndef HARNESS_H_INCLUDED
+#define HARNESS_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file harness.h
+	\brief Chemin de réception de la grue sur Linux, avec une USART simulée
+
+	Le harnais compile sans changement Code_Commun/uart.c, Code_Commun/fifo.c et
+	Code_Final_Grue/command.c. Chaque octet reçu passe par l'interruption de réception
+	USART0_RX_vect(), comme sur la carte; chaque passage dans la boucle principale lit
+	au plus une ligne avec uart_get_line(UART_0, msg, 40) et la décode comme main.c.
+
+	Les moteurs et la pince sont remplacés par des fonctions qui gardent la dernière
+	commande. Après chaque trame, elle est comparée à la correspondance de command.h,
+	recalculée ici en entiers: un écart est un rapport cyclique hors plage.
+
+	Le harnais vérifie aussi, à chaque octet, que nb_line du tampon de réception est
+	égal au nombre de '\n' qu'il contient.
+
+	Compilé avec -DBOARD_UART_BUS=1, l'USART simulée reçoit aussi des caractères de 9
+	bits (harness_receive_bus()) et jette les données en mode multiprocesseur (MPCM0),
+	comme le matériel.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdint.h>
+#include "board.h"
+#include "command.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Taille du tampon de ligne de main.c */
+#define HARNESS_LINE_SIZE	40
+
+typedef struct{
+
+	uint32_t rx_bytes;		/* octets reçus par l'USART */
+	uint32_t filtered;		/* données jetées par l'USART sans interruption (MPCM0) */
+	uint32_t lines;			/* lignes rendues par uart_get_line() */
+	uint32_t frames;		/* lignes décodées en trame */
+	uint32_t queries;		/* commandes ?x */
+	uint32_t invalid;		/* lignes ignorées par command_parse() */
+	uint32_t overflow;		/* octets perdus: tampon plein avec une ligne en attente */
+	uint32_t resync;		/* lignes incomplètes jetées: tampon plein sans '\n' */
+	uint32_t pwm_errors;	/* commandes des moteurs ou de la pince hors correspondance */
+	uint32_t line_errors;	/* nb_line différent du nombre de '\n' du tampon */
+
+}harness_stats_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Initialise l'USART simulée, les moteurs et les compteurs
+    \return rien.
+*/
+void harness_init(void);
+
+/**
+    \brief Reçoit un octet: écrit UDR0 et appelle l'interruption de réception
+	\param[in]	byte L'octet reçu
+    \return rien.
+*/
+void harness_receive(uint8_t byte);
+
+#if BOARD_UART_BUS
+/**
+    \brief Reçoit un caractère de 9 bits sur le bus
+	\param[in]	byte L'octet reçu
+	\param[in]	adresse TRUE si le 9e bit est à 1 (adresse d'une carte)
+    \return rien.
+
+	En mode multiprocesseur (MPCM0 à 1), une donnée est jetée sans interruption.
+*/
+void harness_receive_bus(uint8_t byte, bool adresse);
+
+/**
+    \brief Envoie le tampon de transmission: appelle l'interruption UDRE tant qu'elle est active
+    \return Le nombre d'octets envoyés
+*/
+uint16_t harness_transmit(void);
+
+/**
+    \brief Indique si l'émetteur de UART_0 tient TXD0 (TXEN0 à 1)
+    \return TRUE si l'émetteur est activé
+*/
+bool harness_tx_enabled(void);
+#endif
+
+/**
+    \brief Un passage dans la boucle principale de la grue
+	\param[out]	trame Les commandes appliquées, si la ligne était une trame
+    \return COMMAND_FRAME, COMMAND_QUERY ou COMMAND_INVALID pour une ligne lue, -1
+			si aucune ligne n'était en attente
+*/
+int harness_loop(command_frame_t* trame);
+
+/**
+    \brief Retourne le nombre d'octets en attente dans le tampon de réception
+    \return Le nombre d'octets
+*/
+uint16_t harness_pending(void);
+
+/**
+    \brief Retourne les compteurs depuis harness_init()
+    \return Les compteurs
+*/
+const harness_stats_t* harness_get_stats(void);
+
+#endif /* HARNESS_H_INCLUDED */
@@ -0,0 +1,434 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file replay.c
+	\brief Rejeu à pleine vitesse d'un flux d'octets dans le chemin de réception de la grue
+
+	Le flux vient de fichiers de capture (exe.: cat /dev/ttyUSB0 > capture.bin sur le
+	lien de la manette) ou, sans fichier, d'un générateur qui mêle aux trames valides:
+
+	- d'anciennes trames de TRAME_LONGUEUR_SIMPLE octets et des commandes ?L;
+	- des trames tronquées, suivies sans '\n' de la trame suivante;
+	- des trames dont une valeur vaut '\n', comme l'envoyait l'ancienne manette;
+	- des rafales d'octets aléatoires et des lignes plus longues que le tampon.
+
+	Les octets arrivent par paquets de -r octets entre deux passages dans la boucle
+	principale (1 par défaut: la boucle suit le lien). Un paquet plus gros simule une
+	boucle retardée, par exemple par l'écriture de l'écran.
+
+	Pour le flux généré, chaque trame décodée est cherchée parmi les trames valides
+	envoyées: celles sautées sont perdues, une trame décodée qui n'a pas été envoyée est
+	altérée. Le résultat est écrit en JSON sur la sortie standard; le code de retour est
+	1 si une commande hors plage ou une erreur de nb_line a été vue.
+
+	Usage: replay [-n trames] [-s graine] [-r paquet] [-w flux.bin] [capture...]
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "harness.h"
+#include "board_config.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Une trame décodée est cherchée parmi les ATTENDUES_FENETRE trames valides qui
+   suivent la dernière trouvée */
+#define ATTENDUES_FENETRE	4096
+
+typedef struct{
+
+	uint8_t* data;
+	size_t n;
+	size_t taille;
+
+}flux_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static flux_t flux;
+
+/* Trames valides du flux généré, dans l'ordre d'envoi */
+static command_frame_t* attendues = NULL;
+static size_t attendues_taille = 0;
+static size_t attendues_prochaine = 0;
+
+static unsigned long envoyees = 0;
+static unsigned long perdues = 0;
+static unsigned long alterees = 0;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog);
+static void flux_add(uint8_t byte);
+static int flux_read(const char* nom);
+static void generate(unsigned long trames);
+static uint8_t valeur(void);
+static void frame(command_frame_t* trame, bool simple, bool garder);
+static void match(const command_frame_t* trame);
+static bool same(const command_frame_t* a, const command_frame_t* b);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int main(int argc, char** argv){
+
+	unsigned long trames = 100000;
+	unsigned seed = 1;
+	unsigned long paquet = 1;
+	const char* sortie = NULL;
+	int opt;
+
+	while((opt = getopt(argc, argv, "n:s:r:w:")) != -1){
+
+		switch(opt){
+		case 'n':
+			trames = strtoul(optarg, NULL, 0);
+			break;
+
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'r':
+			paquet = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'w':
+			sortie = optarg;
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if(paquet == 0){
+
+		usage(argv[0]);
+	}
+
+	bool capture = (optind < argc);
+
+	for(int i = optind; i < argc; i++){
+
+		if(flux_read(argv[i]) != 0){
+
+			fprintf(stderr, "%s: impossible de lire %s\n", argv[0], argv[i]);
+			return 2;
+		}
+	}
+
+	if(!capture){
+
+		srand(seed);
+		generate(trames);
+	}
+
+	if(sortie != NULL){
+
+		FILE* f = fopen(sortie, "wb");
+
+		if((f == NULL) || (fwrite(flux.data, 1, flux.n, f) != flux.n)){
+
+			fprintf(stderr, "%s: impossible d'écrire %s\n", argv[0], sortie);
+			return 2;
+		}
+
+		fclose(f);
+	}
+
+	harness_init();
+
+	command_frame_t trame;
+	clock_t debut = clock();
+
+	for(size_t i = 0; i < flux.n; i += paquet){
+
+		for(size_t j = i; (j < i + paquet) && (j < flux.n); j++){
+
+			harness_receive(flux.data[j]);
+		}
+
+		if(harness_loop(&trame) == COMMAND_FRAME){
+
+			match(&trame);
+		}
+	}
+
+	// Fin du flux: la boucle principale vide le tampon
+	int type;
+
+	while((type = harness_loop(&trame)) >= 0){
+
+		if(type == COMMAND_FRAME){
+
+			match(&trame);
+		}
+	}
+
+	double secondes = (double)(clock() - debut) / CLOCKS_PER_SEC;
+	const harness_stats_t* s = harness_get_stats();
+
+	if(secondes <= 0){
+
+		secondes = 1e-9;
+	}
+
+	perdues += envoyees - attendues_prochaine;
+
+	printf("{\n");
+	printf("  \"source\": \"%s\",\n", capture ? "capture" : "generated");
+	printf("  \"rx_buffer\": %u,\n", UART_0_RX_BUFFER_SIZE);
+	printf("  \"burst\": %lu,\n", paquet);
+	printf("  \"bytes\": %u,\n", s->rx_bytes);
+	printf("  \"seconds\": %.3f,\n", secondes);
+	printf("  \"bytes_per_s\": %.0f,\n", s->rx_bytes / secondes);
+	printf("  \"lines_per_s\": %.0f,\n", s->lines / secondes);
+	printf("  \"lines\": {\"total\": %u, \"frames\": %u, \"queries\": %u, \"invalid\": %u},\n",
+		s->lines, s->frames, s->queries, s->invalid);
+	printf("  \"rx\": {\"overflow\": %u, \"resync\": %u, \"pending\": %u},\n",
+		s->overflow, s->resync, harness_pending());
+
+	if(!capture){
+
+		printf("  \"frames\": {\"sent\": %lu, \"dropped\": %lu, \"garbled\": %lu},\n",
+			envoyees, perdues, alterees);
+	}
+
+	printf("  \"pwm_errors\": %u,\n", s->pwm_errors);
+	printf("  \"line_errors\": %u\n", s->line_errors);
+	printf("}\n");
+
+	return ((s->pwm_errors != 0) || (s->line_errors != 0)) ? 1 : 0;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog){
+
+	fprintf(stderr, "usage: %s [-n trames] [-s graine] [-r paquet] [-w flux.bin] [capture...]\n",
+		prog);
+	exit(2);
+}
+
+
+static void flux_add(uint8_t byte){
+
+	if(flux.n == flux.taille){
+
+		flux.taille = (flux.taille == 0) ? 4096 : 2 * flux.taille;
+		flux.data = realloc(flux.data, flux.taille);
+
+		if(flux.data == NULL){
+
+			perror("realloc");
+			exit(2);
+		}
+	}
+
+	flux.data[flux.n++] = byte;
+}
+
+
+static int flux_read(const char* nom){
+
+	FILE* f = fopen(nom, "rb");
+	int c;
+
+	if(f == NULL){
+
+		return -1;
+	}
+
+	while((c = fgetc(f)) != EOF){
+
+		flux_add(c);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+
+/* Flux de test: chaque tirage ajoute une trame valide ou un cas de désynchronisation */
+static void generate(unsigned long trames){
+
+	command_frame_t trame;
+
+	for(unsigned long i = 0; i < trames; i++){
+
+		int tirage = rand() % 100;
+
+		if(tirage < 65){
+
+			frame(&trame, FALSE, TRUE);
+		}
+
+		else if(tirage < 70){
+
+			frame(&trame, TRUE, TRUE);
+		}
+
+		else if(tirage < 75){
+
+			flux_add('?');
+			flux_add('L');
+			flux_add('\n');
+		}
+
+		else if(tirage < 85){
+
+			// Trame tronquée: la suivante s'y colle jusqu'à son '\n'
+			size_t avant = flux.n;
+
+			frame(&trame, FALSE, FALSE);
+			flux.n = avant + 1 + rand() % (TRAME_LONGUEUR - 1);
+		}
+
+		else if(tirage < 93){
+
+			// Une valeur vaut '\n': la ligne est coupée en deux
+			size_t avant = flux.n;
+
+			frame(&trame, FALSE, FALSE);
+			flux.data[avant + rand() % TRAME_SEQ] = '\n';
+		}
+
+		else if(tirage < 97){
+
+			// Rafale d'octets aléatoires, '\n' compris
+			int n = 1 + rand() % (2 * UART_0_RX_BUFFER_SIZE);
+
+			for(int j = 0; j < n; j++){
+
+				flux_add(rand());
+			}
+		}
+
+		else{
+
+			// Ligne plus longue que le tampon, sans '\n'
+			int n = UART_0_RX_BUFFER_SIZE + rand() % UART_0_RX_BUFFER_SIZE;
+
+			for(int j = 0; j < n; j++){
+
+				flux_add(valeur());
+			}
+		}
+	}
+}
+
+
+/* Valeur d'un axe comme l'envoie la manette: jamais '\n' */
+static uint8_t valeur(void){
+
+	uint8_t v = rand();
+
+	return (v == '\n') ? v + 1 : v;
+}
+
+
+/* Ajoute une trame au flux, gardée comme attendue si garder est TRUE */
+static void frame(command_frame_t* trame, bool simple, bool garder){
+
+	static uint8_t seq = 0;
+	uint16_t temps = rand();
+
+	trame->y = valeur();
+	trame->x = valeur();
+	trame->g = valeur();
+	trame->p = rand() & 1;
+	trame->a = rand() % TRAME_MODE_NB;
+	trame->has_seq = !simple;
+	trame->seq = simple ? 0 : seq;
+
+	flux_add(trame->y);
+	flux_add(trame->x);
+	flux_add(trame->g);
+	flux_add(trame->p);
+	flux_add(trame->a);
+
+	if(!simple){
+
+		flux_add(TRAME_CODE_7(seq));
+		flux_add(TRAME_CODE_7(temps));
+		flux_add(TRAME_CODE_7(temps >> 7));
+		seq = (seq + 1) & 0x7F;
+	}
+
+	flux_add('\n');
+
+	if(garder){
+
+		if(envoyees == attendues_taille){
+
+			attendues_taille = (attendues_taille == 0) ? 1024 : 2 * attendues_taille;
+			attendues = realloc(attendues, attendues_taille * sizeof(command_frame_t));
+
+			if(attendues == NULL){
+
+				perror("realloc");
+				exit(2);
+			}
+		}
+
+		attendues[envoyees++] = *trame;
+	}
+}
+
+
+/* Cherche la trame décodée parmi les attendues; celles d'avant sont perdues */
+static void match(const command_frame_t* trame){
+
+	for(size_t i = attendues_prochaine;
+		(i < envoyees) && (i < attendues_prochaine + ATTENDUES_FENETRE); i++){
+
+		if(same(trame, &attendues[i])){
+
+			perdues += i - attendues_prochaine;
+			attendues_prochaine = i + 1;
+			return;
+		}
+	}
+
+	alterees++;
+}
+
+
+static bool same(const command_frame_t* a, const command_frame_t* b){
+
+	return (a->y == b->y) && (a->x == b->x) && (a->g == b->g) && (a->p == b->p) &&
+		(a->a == b->a) && (a->has_seq == b->has_seq) && (a->seq == b->seq);
+}
@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+"""Planificateur hors ligne du mode automatique de la grue.
+
+Usage: planner.py [-o automation_plan.h] [--shaper shaper.h] quilles.txt
+
+Le fichier d'entrée donne les limites de chaque axe et les points à visiter (voir
+quilles.txt). Chaque axe suit un profil trapézoïdal: accélération jusqu'à sa vitesse,
+palier, puis décélération après la coupure de la commande. Entre deux points, les
+trois axes partent ensemble et le déplacement dure autant que l'axe le plus lent.
+
+Avec --shaper, le plan tient compte de la mise en forme contre le balancement de
+Code_Final_Grue/shaper.h: chaque déplacement dure la dernière impulsion de plus, et
+la flèche est coupée plus tôt du retard moyen des impulsions.
+
+L'ordre de visite des quilles qui minimise le temps total est cherché exactement
+(programmation dynamique sur les sous-ensembles, Held-Karp), du départ à l'arrivée.
+
+Le plan est écrit en table de segments pour Code_Final_Grue/automation.c (en flash)
+et le rapport JSON sur la sortie standard: ordre, déplacements, temps de cycle
+prévu et comparaison avec la séquence écrite à la main de main.c.
+"""
+
+import argparse
+import re
+import itertools
+import json
+import math
+import sys
+
+AXES = ("fleche", "chariot", "glissiere")
+MOTOR = {"fleche": "MOTOR_FLECHE", "chariot": "MOTOR_CHARIOT", "glissiere": "MOTOR_GLISSIERE"}
+
+# Pas de l'encodeur de la flèche: 24 clics par tour
+ENCODEUR_PAS = 15
+
+# Quilles au-delà desquelles la recherche exacte devient trop longue
+QUILLES_MAX = 14
+
+# Segment de la flèche ou du chariot arrêté à sa cible (encodeur, course estimée):
+# la durée n'est qu'un garde-fou. Le frottement retient l'axe aux petits rapports
+# cycliques de la mise en forme.
+MARGE_CIBLE = 1.5
+
+# sizeof(automation_step_t) sur AVR (automation.h, sans remplissage):
+# debut_ms 2 + fin_ms 2 + axe 1 + sens 1 + duty 1 + cible 2 + quille 1
+OCTETS_PAR_PAS = 10
+
+# Séquence écrite à la main (main.c avant le plan): (axe, début s, fin s)
+SEQUENCE_MANUELLE = [
+    ("fleche", 0, 2),
+    ("chariot", 3, 7), ("fleche", 10, 15),
+    ("chariot", 15, 22), ("fleche", 22, 25),
+    ("chariot", 25, 32), ("fleche", 32, 35),
+    ("chariot", 35, 42), ("fleche", 42, 45),
+    ("chariot", 45, 52), ("fleche", 52, 55),
+    ("fleche", 55, 58),
+]
+
+
+class Erreur(Exception):
+    pass
+
+
+def lire(chemin):
+    """Lit les axes, le départ, les quilles et l'arrivée d'un fichier d'entrée."""
+    axes = {}
+    quilles = []
+    depart = None
+    arrivee = None
+
+    with open(chemin) as f:
+        for no, ligne in enumerate(f, 1):
+            mots = ligne.split("#", 1)[0].split()
+            if not mots:
+                continue
+            try:
+                if mots[0] == "axe" and len(mots) == 5 and mots[1] in AXES:
+                    vitesse, acceleration, duty = float(mots[2]), float(mots[3]), int(mots[4])
+                    if vitesse <= 0 or acceleration <= 0 or not 0 < duty < 256:
+                        raise ValueError
+                    axes[mots[1]] = {"vitesse": vitesse, "acceleration": acceleration,
+                                     "duty": duty}
+                elif mots[0] in ("depart", "arrivee") and len(mots) == 4:
+                    point = [float(v) for v in mots[1:]]
+                    if mots[0] == "depart":
+                        depart = point
+                    else:
+                        arrivee = point
+                elif mots[0] == "quille" and len(mots) in (5, 6):
+                    quilles.append({"numero": int(mots[1]),
+                                    "point": [float(v) for v in mots[2:5]],
+                                    "pause_ms": int(mots[5]) if len(mots) == 6 else 0})
+                else:
+                    raise ValueError
+            except ValueError:
+                raise Erreur("%s:%d: ligne invalide" % (chemin, no))
+
+    if set(axes) != set(AXES) or depart is None or not quilles:
+        raise Erreur("%s: il faut les trois axes, le départ et au moins une quille" % chemin)
+    if len(quilles) > QUILLES_MAX:
+        raise Erreur("%s: plus de %d quilles" % (chemin, QUILLES_MAX))
+
+    for point in [depart, arrivee] + [q["point"] for q in quilles]:
+        if point is not None and not 0 <= point[0] < 360:
+            raise Erreur("%s: angle hors de 0 à 359°" % chemin)
+
+    return axes, depart, quilles, arrivee
+
+
+def mise_en_forme(chemin):
+    """Durée ajoutée et retard moyen (s) des impulsions du réglage par défaut de shaper.h."""
+    valeurs = {}
+    with open(chemin) as f:
+        for nom, valeur in re.findall(r"#define\s+(SHAPER_\w+)\s+(\w+)", f.read()):
+            valeurs[nom] = valeur
+
+    try:
+        cable = int(valeurs["SHAPER_CABLE_MM"])
+        z = int(valeurs["SHAPER_AMORTISSEMENT_PCT"]) / 100.0
+        type = valeurs["SHAPER_DEFAUT"]
+    except (KeyError, ValueError):
+        raise Erreur("%s: réglage par défaut de la mise en forme introuvable" % chemin)
+
+    k = math.exp(-z * math.pi / math.sqrt(1 - z * z))
+    demi = math.pi * math.sqrt(cable / 9810.0) / math.sqrt(1 - z * z)
+
+    if type == "SHAPER_ZV":
+        impulsions = [(1 / (1 + k), 0.0), (k / (1 + k), demi)]
+    elif type == "SHAPER_ZVD":
+        impulsions = [(1 / (1 + k) ** 2, 0.0), (2 * k / (1 + k) ** 2, demi),
+                      (k * k / (1 + k) ** 2, 2 * demi)]
+    else:
+        impulsions = [(1.0, 0.0)]
+
+    return {"type": type, "duree": impulsions[-1][1],
+            "retard": sum(a * t for a, t in impulsions)}
+
+
+def profil(distance, axe):
+    """Durée de commande et durée totale d'un déplacement trapézoïdal (s)."""
+    v = axe["vitesse"]
+    a = axe["acceleration"]
+    d = abs(distance)
+    if d == 0:
+        return 0.0, 0.0
+    if d >= v * v / a:
+        # Trapèze: commande jusqu'au début de la décélération
+        return d / v, d / v + v / a
+    # Triangle: la vitesse maximale n'est pas atteinte
+    t = math.sqrt(d / a)
+    return t, 2 * t
+
+
+def duree(a, b, axes):
+    """Durée d'un déplacement de a à b, les trois axes en même temps."""
+    return max(profil(b[i] - a[i], axes[nom])[1] for i, nom in enumerate(AXES))
+
+
+def ordre_optimal(axes, depart, quilles, arrivee):
+    """Held-Karp: ordre des quilles qui minimise le temps du départ à l'arrivée."""
+    n = len(quilles)
+    points = [q["point"] for q in quilles]
+    pause = [q["pause_ms"] / 1000.0 for q in quilles]
+
+    meilleur = {}
+    for j in range(n):
+        meilleur[(1 << j, j)] = (duree(depart, points[j], axes) + pause[j], None)
+
+    for taille in range(2, n + 1):
+        for sous in itertools.combinations(range(n), taille):
+            masque = sum(1 << j for j in sous)
+            for j in sous:
+                avant = masque & ~(1 << j)
+                meilleur[(masque, j)] = min(
+                    (meilleur[(avant, k)][0] + duree(points[k], points[j], axes) + pause[j], k)
+                    for k in sous if k != j)
+
+    tous = (1 << n) - 1
+    fin = min(range(n), key=lambda j: meilleur[(tous, j)][0] +
+              (duree(points[j], arrivee, axes) if arrivee else 0))
+
+    ordre = []
+    masque, j = tous, fin
+    while j is not None:
+        ordre.append(j)
+        masque, j = masque & ~(1 << j), meilleur[(masque, j)][1]
+    return ordre[::-1]
+
+
+def planifier(axes, depart, quilles, arrivee, forme):
+    """Déplacements et segments du plan, dans l'ordre optimal."""
+    ordre = ordre_optimal(axes, depart, quilles, arrivee)
+    etapes = [(quilles[j]["numero"], quilles[j]["point"], quilles[j]["pause_ms"]) for j in ordre]
+    if arrivee:
+        etapes.append((max(q["numero"] for q in quilles) + 1, arrivee, 0))
+
+    t = 0.0
+    position = depart
+    deplacements = []
+    segments = []
+
+    for numero, point, pause_ms in etapes:
+        dt = duree(position, point, axes)
+        lent = None
+        for i, nom in enumerate(AXES):
+            distance = point[i] - position[i]
+            commande, total = profil(distance, axes[nom])
+            if total == dt and distance != 0:
+                lent = nom
+            if distance == 0:
+                continue
+            v = axes[nom]["vitesse"]
+            a = axes[nom]["acceleration"]
+            cible = None
+            if nom in ("fleche", "chariot"):
+                # Coupure avant le point visé, de la distance de freinage et de la
+                # course faite pendant le retard moyen de la mise en forme
+                vitesse = min(v, commande * a)
+                freinage = vitesse ** 2 / (2 * a) + vitesse * forme["retard"]
+                coupure = point[i] - math.copysign(freinage, distance)
+                if nom == "fleche":
+                    cible = int(round(coupure / ENCODEUR_PAS)) * ENCODEUR_PAS
+                else:
+                    # Course estimée par kinematics.h, en mm
+                    cible = int(round(coupure))
+                # Cible déjà dépassée au départ (sous un pas de l'encodeur pour la
+                # flèche): seule la durée arrête l'axe
+                if (cible - position[i]) * distance <= 0:
+                    cible = None
+                else:
+                    commande *= MARGE_CIBLE
+            segments.append({"debut_ms": int(round(t * 1000)),
+                             "fin_ms": int(round((t + commande) * 1000)),
+                             "axe": nom, "sens": distance < 0,
+                             "duty": axes[nom]["duty"], "cible": cible, "quille": numero})
+        # La dernière impulsion de la mise en forme arrive après la fin de la commande
+        dt += forme["duree"]
+        deplacements.append({"quille": numero, "debut_s": round(t, 3),
+                             "duree_s": round(dt, 3), "axe_limitant": lent})
+        t += dt + pause_ms / 1000.0
+        position = point
+
+    segments.sort(key=lambda s: (s["debut_ms"], AXES.index(s["axe"])))
+    return ordre, deplacements, segments, t
+
+
+def entete(segments, cycle_s, source):
+    """Table de segments pour Code_Final_Grue/automation.c."""
+    if max(s["fin_ms"] for s in segments) > 0xFFFF:
+        raise Erreur("le plan dure plus de 65 s: les instants ne tiennent pas sur 16 bits")
+
+    lignes = [
+        "#ifndef AUTOMATION_PLAN_H_INCLUDED",
+        "#define AUTOMATION_PLAN_H_INCLUDED",
+        "",
+        "/*",
+        "\t __ ___  __",
+        "\t|_   |  (_",
+        "\t|__  |  __)",
+        "",
+        "\tMIT License",
+        "",
+        "\tCopyright (c) 2018\tÉcole de technologie supérieure",
+        "",
+        "\tPermission is hereby granted, free of charge, to any person obtaining a copy",
+        "\tof this software and associated documentation files (the \"Software\"), to deal",
+        "\tin the Software without restriction, including without limitation the rights",
+        "\tto use, copy, modify and/or merge copies of the Software, and to permit persons",
+        "\tto whom the Software is furnished to do so, subject to the following conditions:",
+        "",
+        "\tThe above copyright notice and this permission notice shall be included in all",
+        "\tcopies or substantial portions of the Software.",
+        "*/",
+        "/**",
+        "\t\\file automation_plan.h",
+        "\t\\brief Plan du mode automatique, généré par tools/planner/planner.py",
+        "",
+        "\tSource: %s. Ne pas modifier: relancer make -C tools/planner." % source,
+        "*/",
+        "",
+        "#include <avr/pgmspace.h>",
+        "#include \"automation.h\"",
+        "",
+        "#define AUTOMATION_PLAN_NB\t\t%d" % len(segments),
+        "#define AUTOMATION_PLAN_CYCLE_MS\t%d" % int(round(cycle_s * 1000)),
+        "",
+        "static const automation_step_t automation_plan[AUTOMATION_PLAN_NB] PROGMEM = {",
+        "",
+        "\t/* début  fin    axe               sens   duty  cible  quille */",
+    ]
+    for s in segments:
+        cible = "AUTOMATION_SANS_CIBLE" if s["cible"] is None else "%d" % s["cible"]
+        lignes.append("\t{ %-6s %-6s %-17s %-6s %-5s %-6s %d }," % (
+            "%d," % s["debut_ms"], "%d," % s["fin_ms"], MOTOR[s["axe"]] + ",",
+            ("TRUE," if s["sens"] else "FALSE,"), "%d," % s["duty"], cible + ",",
+            s["quille"]))
+    lignes += ["};", "", "#endif /* AUTOMATION_PLAN_H_INCLUDED */", ""]
+    return "\n".join(lignes)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-o", "--output", help="table C à écrire (automation_plan.h)")
+    parser.add_argument("--shaper", help="shaper.h: mise en forme appliquée par la grue")
+    parser.add_argument("quilles")
+    args = parser.parse_args()
+
+    try:
+        axes, depart, quilles, arrivee = lire(args.quilles)
+        forme = mise_en_forme(args.shaper) if args.shaper else \
+            {"type": "SHAPER_AUCUN", "duree": 0.0, "retard": 0.0}
+        ordre, deplacements, segments, cycle = planifier(axes, depart, quilles, arrivee, forme)
+        texte = entete(segments, cycle, args.quilles.split("/")[-1])
+    except (Erreur, OSError) as e:
+        print(e, file=sys.stderr)
+        return 2
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(texte)
+
+    manuel = max(fin for _, _, fin in SEQUENCE_MANUELLE)
+    rapport = {
+        "order": [quilles[j]["numero"] for j in ordre],
+        "moves": [{"to": d["quille"], "start_s": d["debut_s"], "duration_s": d["duree_s"],
+                   "limiting_axis": d["axe_limitant"]} for d in deplacements],
+        "shaper": {"type": forme["type"], "added_per_move_s": round(forme["duree"], 3)},
+        "segments": len(segments),
+        "table_bytes": len(segments) * OCTETS_PAR_PAS,
+        "planned_cycle_s": round(cycle, 2),
+        "manual_cycle_s": manuel,
+        "gain_pct": round((manuel - cycle) * 100.0 / manuel, 1),
+    }
+    print(json.dumps(rapport, indent=2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,18 @@
+/* EEPROM de l'ATmega324A: les fonctions sont définies par l'outil. L'EEPROM est
+   prête quand EEPE est à 0 dans EECR, comme avec avr-libc. */
+#ifndef SHIM_AVR_EEPROM_H
+#define SHIM_AVR_EEPROM_H
+#include <stdint.h>
+#include <stddef.h>
+#include <avr/io.h>
+#define EEMEM
+uint8_t eeprom_read_byte(const uint8_t* p);
+uint16_t eeprom_read_word(const uint16_t* p);
+void eeprom_read_block(void* dst, const void* src, size_t n);
+void eeprom_write_byte(uint8_t* p, uint8_t v);
+void eeprom_update_byte(uint8_t* p, uint8_t v);
+void eeprom_update_word(uint16_t* p, uint16_t v);
+void eeprom_update_block(const void* src, void* dst, size_t n);
+#define eeprom_is_ready() (!(EECR & _BV(EEPE)))
+#define eeprom_busy_wait() do{}while(!eeprom_is_ready())
+#endif
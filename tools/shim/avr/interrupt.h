@@ -0,0 +1,14 @@
+/* ISR() définit une fonction ordinaire, appelée par l'outil pour simuler
+   l'interruption (exe.: USART0_RX_vect() pour un octet reçu). sei() et cli()
+   changent seulement SREG. */
+#ifndef SHIM_AVR_INTERRUPT_H
+#define SHIM_AVR_INTERRUPT_H
+#include <avr/io.h>
+#define sei() (SREG |= 0x80)
+#define cli() (SREG &= (uint8_t)~0x80)
+#define ISR(vector, ...) void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector) void vector(void); void vector(void){}
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define reti() return
+#endif
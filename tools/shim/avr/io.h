@@ -0,0 +1,269 @@
+/* Registres de l'ATmega324A pour la compilation sur Linux (tools/fuzz, tools/twin):
+   chaque registre est un octet de avr_io[], défini par l'outil. Avec SHIM_HOOKS,
+   chaque accès passe par shim_reg(), qui peut avancer le temps simulé et tenir à
+   jour les registres des périphériques. Les vecteurs d'interruption sont des
+   fonctions ordinaires (voir avr/interrupt.h). */
+#ifndef SHIM_AVR_IO_H
+#define SHIM_AVR_IO_H
+#include <stdint.h>
+extern volatile uint8_t avr_io[256];
+#ifdef SHIM_HOOKS
+volatile uint8_t* shim_reg(uint8_t adresse);
+#define _SFR_MEM8(a) (*shim_reg(a))
+#define _SFR_MEM16(a) (*(volatile uint16_t*)shim_reg(a))
+#else
+#define _SFR_MEM8(a) (avr_io[(a)])
+#define _SFR_MEM16(a) (*(volatile uint16_t*)&avr_io[(a)])
+#endif
+#define _BV(b) (1 << (b))
+#define PINA _SFR_MEM8(0x20)
+#define DDRA _SFR_MEM8(0x21)
+#define PORTA _SFR_MEM8(0x22)
+#define PINB _SFR_MEM8(0x23)
+#define DDRB _SFR_MEM8(0x24)
+#define PORTB _SFR_MEM8(0x25)
+#define PINC _SFR_MEM8(0x26)
+#define DDRC _SFR_MEM8(0x27)
+#define PORTC _SFR_MEM8(0x28)
+#define PIND _SFR_MEM8(0x29)
+#define DDRD _SFR_MEM8(0x2A)
+#define PORTD _SFR_MEM8(0x2B)
+#define TIFR0 _SFR_MEM8(0x35)
+#define TIFR1 _SFR_MEM8(0x36)
+#define TIFR2 _SFR_MEM8(0x37)
+#define EIFR _SFR_MEM8(0x3C)
+#define EIMSK _SFR_MEM8(0x3D)
+#define GPIOR0 _SFR_MEM8(0x3E)
+#define EECR _SFR_MEM8(0x3F)
+#define EEDR _SFR_MEM8(0x40)
+#define EEAR _SFR_MEM16(0x41)
+#define GPIOR1 _SFR_MEM8(0x4A)
+#define GPIOR2 _SFR_MEM8(0x4B)
+#define TCCR0A _SFR_MEM8(0x44)
+#define TCCR0B _SFR_MEM8(0x45)
+#define TCNT0 _SFR_MEM8(0x46)
+#define OCR0A _SFR_MEM8(0x47)
+#define OCR0B _SFR_MEM8(0x48)
+#define SMCR _SFR_MEM8(0x53)
+#define MCUSR _SFR_MEM8(0x54)
+#define MCUCR _SFR_MEM8(0x55)
+#define SP _SFR_MEM16(0x5D)
+#define SREG _SFR_MEM8(0x5F)
+#define SREG_I 7
+#define WDTCSR _SFR_MEM8(0x60)
+#define PRR0 _SFR_MEM8(0x64)
+#define EICRA _SFR_MEM8(0x69)
+#define TIMSK0 _SFR_MEM8(0x6E)
+#define TIMSK1 _SFR_MEM8(0x6F)
+#define TIMSK2 _SFR_MEM8(0x70)
+#define ADC _SFR_MEM16(0x78)
+#define ADCL _SFR_MEM8(0x78)
+#define ADCH _SFR_MEM8(0x79)
+#define ADCSRA _SFR_MEM8(0x7A)
+#define ADCSRB _SFR_MEM8(0x7B)
+#define ADMUX _SFR_MEM8(0x7C)
+#define DIDR0 _SFR_MEM8(0x7E)
+#define TCCR1A _SFR_MEM8(0x80)
+#define TCCR1B _SFR_MEM8(0x81)
+#define TCCR1C _SFR_MEM8(0x82)
+#define TCNT1 _SFR_MEM16(0x84)
+#define ICR1 _SFR_MEM16(0x86)
+#define OCR1A _SFR_MEM16(0x88)
+#define OCR1B _SFR_MEM16(0x8A)
+#define TCCR2A _SFR_MEM8(0xB0)
+#define TCCR2B _SFR_MEM8(0xB1)
+#define TCNT2 _SFR_MEM8(0xB2)
+#define OCR2A _SFR_MEM8(0xB3)
+#define OCR2B _SFR_MEM8(0xB4)
+#define ASSR _SFR_MEM8(0xB6)
+#define UCSR0A _SFR_MEM8(0xC0)
+#define UCSR0B _SFR_MEM8(0xC1)
+#define UCSR0C _SFR_MEM8(0xC2)
+#define UBRR0 _SFR_MEM16(0xC4)
+#define UDR0 _SFR_MEM8(0xC6)
+#define UCSR1A _SFR_MEM8(0xC8)
+#define UCSR1B _SFR_MEM8(0xC9)
+#define UCSR1C _SFR_MEM8(0xCA)
+#define UBRR1 _SFR_MEM16(0xCC)
+#define UDR1 _SFR_MEM8(0xCE)
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC7 7
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define WGM00 0
+#define WGM01 1
+#define COM0B0 4
+#define COM0B1 5
+#define COM0A0 6
+#define COM0A1 7
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define WGM02 3
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOV0 0
+#define OCF0A 1
+#define OCF0B 2
+#define WGM10 0
+#define WGM11 1
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+#define FOC1A 7
+#define FOC1B 6
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define ICIE1 5
+#define TOV1 0
+#define OCF1A 1
+#define OCF1B 2
+#define ICF1 5
+#define WGM20 0
+#define WGM21 1
+#define COM2B0 4
+#define COM2B1 5
+#define COM2A0 6
+#define COM2A1 7
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define WGM22 3
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOV2 0
+#define OCF2A 1
+#define OCF2B 2
+#define MUX0 0
+#define ADLAR 5
+#define REFS0 6
+#define REFS1 7
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE 3
+#define ADIF 4
+#define ADATE 5
+#define ADSC 6
+#define ADEN 7
+#define MPCM0 0
+#define U2X0 1
+#define UPE0 2
+#define DOR0 3
+#define FE0 4
+#define UDRE0 5
+#define TXC0 6
+#define RXC0 7
+#define TXB80 0
+#define RXB80 1
+#define UCSZ02 2
+#define TXEN0 3
+#define RXEN0 4
+#define UDRIE0 5
+#define TXCIE0 6
+#define RXCIE0 7
+#define UCPOL0 0
+#define UCSZ00 1
+#define UCSZ01 2
+#define USBS0 3
+#define UPM00 4
+#define UPM01 5
+#define UMSEL00 6
+#define UMSEL01 7
+#define MPCM1 0
+#define U2X1 1
+#define UPE1 2
+#define DOR1 3
+#define FE1 4
+#define UDRE1 5
+#define TXC1 6
+#define RXC1 7
+#define TXB81 0
+#define RXB81 1
+#define UCSZ12 2
+#define TXEN1 3
+#define RXEN1 4
+#define UDRIE1 5
+#define TXCIE1 6
+#define RXCIE1 7
+#define UCPOL1 0
+#define UCSZ10 1
+#define UCSZ11 2
+#define USBS1 3
+#define UPM10 4
+#define UPM11 5
+#define UMSEL10 6
+#define UMSEL11 7
+#define INT0 0
+#define INT1 1
+#define INT2 2
+#define INTF0 0
+#define ISC00 0
+#define ISC01 1
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+#define JTRF 4
+#define SE 0
+#define SM0 1
+#define SM1 2
+#define SM2 3
+#define EEMPE 2
+#define EEPE 1
+#define RAMEND 0x08FF
+#define RAMSTART 0x0100
+#define E2END 0x03FF
+#define FLASHEND 0x7FFF
+#define INT0_vect __vector_1
+#define TIMER2_COMPA_vect __vector_9
+#define TIMER2_COMPB_vect __vector_10
+#define TIMER2_OVF_vect __vector_11
+#define TIMER1_CAPT_vect __vector_12
+#define TIMER1_COMPA_vect __vector_13
+#define TIMER1_COMPB_vect __vector_14
+#define TIMER1_OVF_vect __vector_15
+#define TIMER0_COMPA_vect __vector_16
+#define TIMER0_COMPB_vect __vector_17
+#define TIMER0_OVF_vect __vector_18
+#define USART0_RX_vect __vector_20
+#define USART0_UDRE_vect __vector_21
+#define USART0_TX_vect __vector_22
+#define ADC_vect __vector_24
+#define EE_READY_vect __vector_25
+#define USART1_RX_vect __vector_28
+#define USART1_UDRE_vect __vector_29
+#define USART1_TX_vect __vector_30
+#define WDT_vect __vector_8
+#endif
@@ -0,0 +1,19 @@
+/* Veille: avec SHIM_HOOKS, sleep_cpu() laisse l'outil avancer le temps simulé
+   jusqu'à la prochaine interruption */
+#ifndef SHIM_AVR_SLEEP_H
+#define SHIM_AVR_SLEEP_H
+#include <avr/io.h>
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC (1<<SM0)
+#define SLEEP_MODE_PWR_DOWN (1<<SM1)
+#define set_sleep_mode(m) (SMCR = (SMCR & ~0x0E) | (m))
+#define sleep_enable() (SMCR |= 1)
+#define sleep_disable() (SMCR &= (uint8_t)~1)
+#ifdef SHIM_HOOKS
+void shim_sleep(void);
+#define sleep_cpu() shim_sleep()
+#else
+#define sleep_cpu() do{}while(0)
+#endif
+#define sleep_mode() do{ sleep_enable(); sleep_cpu(); sleep_disable(); }while(0)
+#endif
@@ -0,0 +1,23 @@
+/* Chien de garde: avec SHIM_HOOKS, l'outil compte les délais dépassés */
+#ifndef SHIM_AVR_WDT_H
+#define SHIM_AVR_WDT_H
+#define WDTO_15MS 0
+#define WDTO_30MS 1
+#define WDTO_60MS 2
+#define WDTO_120MS 3
+#define WDTO_250MS 4
+#define WDTO_500MS 5
+#define WDTO_1S 6
+#define WDTO_2S 7
+#ifdef SHIM_HOOKS
+void shim_wdt_enable(int delai);
+void shim_wdt_reset(void);
+#define wdt_enable(t) shim_wdt_enable(t)
+#define wdt_disable() shim_wdt_enable(-1)
+#define wdt_reset() shim_wdt_reset()
+#else
+#define wdt_enable(t) do{(void)(t);}while(0)
+#define wdt_disable() do{}while(0)
+#define wdt_reset() do{}while(0)
+#endif
+#endif
@@ -0,0 +1,10 @@
+/* ATOMIC_BLOCK() sauvegarde et rend SREG, comme avr-libc, sans interruption réelle */
+#ifndef SHIM_UTIL_ATOMIC_H
+#define SHIM_UTIL_ATOMIC_H
+#include <avr/interrupt.h>
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define NONATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type) for (uint8_t __s = SREG, __t = (cli(), 1); __t; __t = 0, SREG = __s)
+#define NONATOMIC_BLOCK(type) for (uint8_t __s = SREG, __t = (sei(), 1); __t; __t = 0, SREG = __s)
+#endif
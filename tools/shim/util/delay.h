@@ -0,0 +1,12 @@
+/* Attentes en ms et en us, converties en cycles de F_CPU */
+#ifndef SHIM_UTIL_DELAY_H
+#define SHIM_UTIL_DELAY_H
+#include <util/delay_basic.h>
+#ifdef SHIM_HOOKS
+static inline void _delay_ms(double ms){ shim_delay_cycles((uint32_t)(ms * (F_CPU / 1000.0))); }
+static inline void _delay_us(double us){ shim_delay_cycles((uint32_t)(us * (F_CPU / 1000000.0))); }
+#else
+static inline void _delay_ms(double ms){ (void)ms; }
+static inline void _delay_us(double us){ (void)us; }
+#endif
+#endif
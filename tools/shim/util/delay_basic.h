@@ -0,0 +1,14 @@
+/* Boucles d'attente: avec SHIM_HOOKS, l'outil avance le temps simulé du nombre de
+   cycles de la boucle (3 ou 4 par tour, 0 vaut 256 ou 65536 tours) */
+#ifndef SHIM_UTIL_DELAY_BASIC_H
+#define SHIM_UTIL_DELAY_BASIC_H
+#include <stdint.h>
+#ifdef SHIM_HOOKS
+void shim_delay_cycles(uint32_t cycles);
+static inline void _delay_loop_1(uint8_t c){ shim_delay_cycles(3UL * (c ? c : 256)); }
+static inline void _delay_loop_2(uint16_t c){ shim_delay_cycles(4UL * (c ? c : 65536UL)); }
+#else
+static inline void _delay_loop_1(uint8_t c){ (void)c; }
+static inline void _delay_loop_2(uint16_t c){ (void)c; }
+#endif
+#endif
@@ -0,0 +1,754 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file mcu.c
+	\brief ATmega324A simulé pour le microprogramme de la grue compilé sur Linux
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <avr/io.h>
+#include "mcu.h"
+#include "fifo.h"
+#include "blackbox.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Coût d'entrée et de sortie d'une interruption (sauvegarde, RETI), en cycles */
+#define ISR_CYCLES			20
+
+/* RAM_MAGIC de blackbox.c: le tampon gardé est valide */
+#define BLACKBOX_RAM_MAGIC	0xB10C
+
+/* Coût d'un tour d'attente active sur un fifo plein, en cycles */
+#define ATTENTE_CYCLES		8
+
+#define RX_FILE_TAILLE		4096
+#define TX_LOG_TAILLE		2048
+
+#define JAMAIS				UINT64_MAX
+
+/* Vecteurs dans l'ordre de priorité du microcontrôleur */
+typedef enum{
+
+	VECTEUR_INT0 = 0,
+	VECTEUR_TIMER1_COMPA,
+	VECTEUR_TIMER1_COMPB,
+	VECTEUR_USART0_RX,
+	VECTEUR_USART0_UDRE,
+	VECTEUR_ADC,
+
+	VECTEUR_NB
+
+}vecteur_e;
+
+void INT0_vect(void);
+void TIMER1_COMPA_vect(void);
+void TIMER1_COMPB_vect(void);
+void USART0_RX_vect(void);
+void USART0_UDRE_vect(void);
+void ADC_vect(void);
+
+bool __real_fifo_is_full(fifo_t* fifo);
+
+/* Variables de blackbox.c gardées d'un reset à l'autre (.noinit), rendues globales sous
+ces noms par le Makefile */
+extern volatile uint16_t blackbox_noinit_magic;
+extern volatile uint8_t blackbox_noinit_head;
+extern volatile uint8_t blackbox_noinit_count;
+extern uint8_t blackbox_noinit_mcusr;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+volatile uint8_t avr_io[256] __attribute__((aligned(2)));
+
+static uint64_t maintenant;
+static uint64_t fin_run;
+static jmp_buf fin_jmp;
+static bool arrete;			/* mcu_run() terminé: le temps n'avance plus */
+
+static bool dans_isr;
+static bool reveil;			/* une interruption a été lancée depuis la mise en veille */
+static bool attente[VECTEUR_NB];
+
+static uint32_t tick_periode;
+static uint64_t tick_suivant;
+static void (*tick_cb)(void);
+static bool dans_tick;
+
+/* Compteur 1: compte au dernier traitement et sortie OC1A */
+static uint64_t t1_dernier;
+static uint8_t oc1a;
+static uint64_t oc1a_montee;
+static uint16_t servo_us;
+
+/* USART0 */
+static uint8_t rx_file[RX_FILE_TAILLE];
+static uint16_t rx_debut;
+static uint16_t rx_n;
+static uint64_t rx_suivant = JAMAIS;
+static uint8_t rx_donnee;
+static uint64_t tx_libre;
+static char tx_log[TX_LOG_TAILLE];
+static uint16_t tx_log_n;
+
+/* ADC */
+static uint16_t adc_valeur[8];
+static uint64_t adc_fin = JAMAIS;
+
+/* EEPROM */
+static uint8_t eeprom[E2END + 1];
+static uint64_t eeprom_fin = JAMAIS;
+
+/* Chien de garde */
+static int wdt_delai = -1;
+static uint64_t wdt_dernier;
+
+static mcu_stats_t stats;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void avancer(uint64_t cible);
+static uint64_t prochain_evenement(void);
+static void traiter(void);
+static void lancer(void);
+static void detecter_ecritures(void);
+static uint64_t t1_comparaison(uint16_t ocr);
+static bool t1_en_marche(void);
+static uint32_t duree_octet(void);
+static volatile uint8_t* pin_registre(char port);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void mcu_init(uint32_t periode, void (*tick)(void)){
+
+	memset((void*)avr_io, 0, sizeof(avr_io));
+	memset(attente, 0, sizeof(attente));
+	memset(&stats, 0, sizeof(stats));
+	memset(eeprom, 0xFF, sizeof(eeprom));
+	memset(adc_valeur, 0, sizeof(adc_valeur));
+
+	maintenant = 0;
+	arrete = FALSE;
+	dans_isr = FALSE;
+	reveil = FALSE;
+
+	tick_periode = periode;
+	tick_suivant = periode;
+	tick_cb = tick;
+	dans_tick = FALSE;
+
+	t1_dernier = 0;
+	oc1a = 0;
+	oc1a_montee = 0;
+	servo_us = 0;
+
+	rx_debut = 0;
+	rx_n = 0;
+	rx_suivant = JAMAIS;
+	tx_libre = 0;
+	tx_log_n = 0;
+
+	adc_fin = JAMAIS;
+	eeprom_fin = JAMAIS;
+	wdt_delai = -1;
+}
+
+
+void mcu_run(uint64_t fin, int (*entree)(void)){
+
+	fin_run = fin;
+
+	if(setjmp(fin_jmp) == 0){
+
+		entree();
+	}
+
+	arrete = TRUE;
+}
+
+
+uint64_t mcu_cycles(void){
+
+	return maintenant;
+}
+
+
+void mcu_reset(uint8_t mcusr){
+
+	// Ce que save_reset_cause() (.init3, pas exécutée sur l'hôte) et la boucle d'avant
+	// le reset auraient laissé
+	blackbox_noinit_magic = BLACKBOX_RAM_MAGIC;
+	blackbox_noinit_head = 0;
+	blackbox_noinit_count = BLACKBOX_NB_EVENTS;
+	blackbox_noinit_mcusr = mcusr;
+}
+
+
+void mcu_uart_send(uint8_t byte){
+
+	if(rx_n == RX_FILE_TAILLE){
+
+		stats.rx_overrun++;
+		return;
+	}
+
+	rx_file[(rx_debut + rx_n) % RX_FILE_TAILLE] = byte;
+	rx_n++;
+
+	if(rx_suivant == JAMAIS){
+
+		rx_suivant = maintenant + duree_octet();
+	}
+}
+
+
+void mcu_set_pin(char port, uint8_t bit, uint8_t niveau){
+
+	volatile uint8_t* pin = pin_registre(port);
+
+	*pin = niveau ? (*pin | (1 << bit)) : (*pin & ~(1 << bit));
+}
+
+
+void mcu_set_adc(uint8_t canal, uint16_t valeur){
+
+	adc_valeur[canal & 0x07] = (valeur > 1023) ? 1023 : valeur;
+}
+
+
+void mcu_int0(void){
+
+	attente[VECTEUR_INT0] = TRUE;
+}
+
+
+uint8_t mcu_pwm(uint8_t ocr, uint8_t tccr, uint8_t com){
+
+	return (avr_io[tccr] & (1 << com)) ? avr_io[ocr] : 0;
+}
+
+
+uint8_t mcu_get_port(char port, uint8_t bit){
+
+	return (pin_registre(port)[2] >> bit) & 1;
+}
+
+
+uint16_t mcu_servo_us(void){
+
+	return servo_us;
+}
+
+
+const mcu_stats_t* mcu_get_stats(void){
+
+	return &stats;
+}
+
+
+void mcu_print_tx(FILE* f){
+
+	fputc('"', f);
+
+	for(uint16_t i = 0; i < tx_log_n; i++){
+
+		uint8_t c = tx_log[i];
+
+		if((c == '"') || (c == '\\')){
+
+			fprintf(f, "\\%c", c);
+		}
+
+		else if((c >= 0x20) && (c < 0x7F)){
+
+			fputc(c, f);
+		}
+
+		else{
+
+			fprintf(f, "\\u%04x", c);
+		}
+	}
+
+	fputc('"', f);
+}
+
+/* ----------------------------------------------------------------------------
+Appelées par le microprogramme (tools/shim)
+---------------------------------------------------------------------------- */
+
+volatile uint8_t* shim_reg(uint8_t adresse){
+
+	detecter_ecritures();
+	avancer(maintenant + 1);
+
+	// Le compteur 1 suit le temps simulé
+	if((adresse == MCU_ADRESSE(TCNT1)) || (adresse == MCU_ADRESSE(TCNT1) + 1)){
+
+		uint16_t compte = (maintenant / MCU_CYCLES_PAR_US) & 0xFFFF;
+
+		avr_io[MCU_ADRESSE(TCNT1)] = compte & 0xFF;
+		avr_io[MCU_ADRESSE(TCNT1) + 1] = compte >> 8;
+	}
+
+	return &avr_io[adresse];
+}
+
+
+void shim_delay_cycles(uint32_t cycles){
+
+	detecter_ecritures();
+	avancer(maintenant + cycles);
+}
+
+
+void shim_sleep(void){
+
+	uint64_t debut = maintenant;
+
+	detecter_ecritures();
+
+	if(!(SREG & (1 << SREG_I))){
+
+		fprintf(stderr, "twin: veille avec les interruptions bloquées, le microcontrôleur ne se réveillerait jamais\n");
+		exit(3);
+	}
+
+	reveil = FALSE;
+
+	while(!reveil){
+
+		avancer(prochain_evenement());
+	}
+
+	stats.sleep_cycles += maintenant - debut;
+}
+
+
+void shim_wdt_enable(int delai){
+
+	wdt_delai = delai;
+	wdt_dernier = maintenant;
+}
+
+
+void shim_wdt_reset(void){
+
+	wdt_dernier = maintenant;
+}
+
+
+bool __wrap_fifo_is_full(fifo_t* fifo){
+
+	bool plein = __real_fifo_is_full(fifo);
+
+	// Attente active (exe.: uart_put_string()): le temps doit avancer pour vider le fifo
+	if(plein && !dans_isr){
+
+		avancer(maintenant + ATTENTE_CYCLES);
+	}
+
+	return plein;
+}
+
+
+uint8_t eeprom_read_byte(const uint8_t* p){
+
+	return eeprom[(uintptr_t)p & E2END];
+}
+
+
+uint16_t eeprom_read_word(const uint16_t* p){
+
+	uintptr_t a = (uintptr_t)p;
+
+	return eeprom[a & E2END] | (eeprom[(a + 1) & E2END] << 8);
+}
+
+
+void eeprom_read_block(void* dst, const void* src, size_t n){
+
+	for(size_t i = 0; i < n; i++){
+
+		((uint8_t*)dst)[i] = eeprom[((uintptr_t)src + i) & E2END];
+	}
+}
+
+
+void eeprom_write_byte(uint8_t* p, uint8_t v){
+
+	// Comme avr-libc: attendre la fin de l'écriture précédente
+	while(EECR & (1 << EEPE)){
+
+		avancer(eeprom_fin);
+	}
+
+	eeprom[(uintptr_t)p & E2END] = v;
+	EECR |= (1 << EEPE);
+	eeprom_fin = maintenant + 34 * MCU_CYCLES_PAR_MS / 10;
+}
+
+
+void eeprom_update_byte(uint8_t* p, uint8_t v){
+
+	if(eeprom_read_byte(p) != v){
+
+		eeprom_write_byte(p, v);
+	}
+}
+
+
+void eeprom_update_word(uint16_t* p, uint16_t v){
+
+	eeprom_update_byte((uint8_t*)p, v & 0xFF);
+	eeprom_update_byte((uint8_t*)p + 1, v >> 8);
+}
+
+
+void eeprom_update_block(const void* src, void* dst, size_t n){
+
+	for(size_t i = 0; i < n; i++){
+
+		eeprom_update_byte((uint8_t*)dst + i, ((const uint8_t*)src)[i]);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+/* Traite tous les événements jusqu'à cible, en lançant les interruptions permises */
+static void avancer(uint64_t cible){
+
+	if(arrete){
+
+		return;
+	}
+
+	if(cible > fin_run){
+
+		cible = fin_run;
+	}
+
+	for(;;){
+
+		uint64_t t = prochain_evenement();
+
+		if(t > cible){
+
+			break;
+		}
+
+		if(t > maintenant){
+
+			maintenant = t;
+		}
+
+		traiter();
+		lancer();
+	}
+
+	if(cible > maintenant){
+
+		maintenant = cible;
+	}
+
+	lancer();
+
+	if(maintenant >= fin_run){
+
+		longjmp(fin_jmp, 1);
+	}
+}
+
+
+static uint64_t prochain_evenement(void){
+
+	uint64_t t = tick_suivant;
+
+	if(t1_en_marche()){
+
+		uint64_t a = t1_comparaison(OCR1A) * MCU_CYCLES_PAR_US;
+		uint64_t b = t1_comparaison(OCR1B) * MCU_CYCLES_PAR_US;
+
+		t = (a < t) ? a : t;
+		t = (b < t) ? b : t;
+	}
+
+	t = (rx_suivant < t) ? rx_suivant : t;
+	t = (adc_fin < t) ? adc_fin : t;
+	t = (eeprom_fin < t) ? eeprom_fin : t;
+
+	// L'UDRE est un niveau: prêt dès que le transmetteur est libre
+	if((UCSR0B & (1 << UDRIE0)) && (tx_libre > maintenant) && (tx_libre < t)){
+
+		t = tx_libre;
+	}
+
+	return t;
+}
+
+
+/* Met en attente les interruptions des événements arrivés à échéance */
+static void traiter(void){
+
+	if(t1_en_marche()){
+
+		uint64_t compte = maintenant / MCU_CYCLES_PAR_US;
+		uint64_t a = t1_comparaison(OCR1A);
+		uint64_t b = t1_comparaison(OCR1B);
+
+		if(a <= compte){
+
+			attente[VECTEUR_TIMER1_COMPA] = TRUE;
+
+			// Sortie OC1A: bascule (COM1A1:0 = 01) ou mise à 0 (10)
+			uint8_t mode = (TCCR1A >> COM1A0) & 0x03;
+
+			if(mode == 0x01){
+
+				oc1a ^= 1;
+
+				if(oc1a){
+
+					oc1a_montee = maintenant;
+				}
+
+				else{
+
+					servo_us = (maintenant - oc1a_montee) / MCU_CYCLES_PAR_US;
+				}
+			}
+
+			else if(mode == 0x02){
+
+				oc1a = 0;
+			}
+		}
+
+		if(b <= compte){
+
+			attente[VECTEUR_TIMER1_COMPB] = TRUE;
+		}
+
+		t1_dernier = compte;
+	}
+
+	else{
+
+		t1_dernier = maintenant / MCU_CYCLES_PAR_US;
+	}
+
+	if(rx_suivant <= maintenant){
+
+		if(attente[VECTEUR_USART0_RX]){
+
+			stats.rx_overrun++;
+		}
+
+		rx_donnee = rx_file[rx_debut];
+		rx_debut = (rx_debut + 1) % RX_FILE_TAILLE;
+		rx_n--;
+		stats.rx_bytes++;
+
+		if(UCSR0B & (1 << RXEN0)){
+
+			attente[VECTEUR_USART0_RX] = TRUE;
+		}
+
+		rx_suivant = (rx_n > 0) ? maintenant + duree_octet() : JAMAIS;
+	}
+
+	if(adc_fin <= maintenant){
+
+		uint16_t v = adc_valeur[ADMUX & 0x07];
+
+		if(ADMUX & (1 << ADLAR)){
+
+			v <<= 6;
+		}
+
+		avr_io[MCU_ADRESSE(ADCL)] = v & 0xFF;
+		avr_io[MCU_ADRESSE(ADCH)] = v >> 8;
+		ADCSRA &= ~(1 << ADSC);
+		attente[VECTEUR_ADC] = TRUE;
+		adc_fin = JAMAIS;
+	}
+
+	if(eeprom_fin <= maintenant){
+
+		EECR &= ~(1 << EEPE);
+		eeprom_fin = JAMAIS;
+	}
+
+	if((wdt_delai >= 0) && (maintenant - wdt_dernier > ((15ULL << wdt_delai) * MCU_CYCLES_PAR_MS))){
+
+		stats.watchdog++;
+		wdt_dernier = maintenant;
+	}
+
+	// Le tick n'est jamais appelé de lui-même (une attente dans le tick avancerait le temps)
+	if((tick_suivant <= maintenant) && !dans_tick){
+
+		tick_suivant += tick_periode;
+		dans_tick = TRUE;
+		tick_cb();
+		dans_tick = FALSE;
+	}
+}
+
+
+/* Lance les interruptions en attente et permises, par ordre de priorité */
+static void lancer(void){
+
+	static void (* const vecteurs[VECTEUR_NB])(void) = {
+
+		INT0_vect, TIMER1_COMPA_vect, TIMER1_COMPB_vect,
+		USART0_RX_vect, USART0_UDRE_vect, ADC_vect
+	};
+
+	while(!dans_isr && (SREG & (1 << SREG_I))){
+
+		bool permis[VECTEUR_NB] = {
+
+			EIMSK & (1 << INT0),
+			TIMSK1 & (1 << OCIE1A),
+			TIMSK1 & (1 << OCIE1B),
+			UCSR0B & (1 << RXCIE0),
+			UCSR0B & (1 << UDRIE0),
+			ADCSRA & (1 << ADIE),
+		};
+
+		attente[VECTEUR_USART0_UDRE] = (tx_libre <= maintenant);
+
+		vecteur_e v = 0;
+
+		while((v < VECTEUR_NB) && !(attente[v] && permis[v])){
+
+			v++;
+		}
+
+		if(v == VECTEUR_NB){
+
+			return;
+		}
+
+		attente[v] = FALSE;
+
+		if(v == VECTEUR_USART0_RX){
+
+			UDR0 = rx_donnee;
+		}
+
+		dans_isr = TRUE;
+		SREG &= ~(1 << SREG_I);
+		maintenant += ISR_CYCLES;
+
+		vecteurs[v]();
+
+		SREG |= (1 << SREG_I);
+		dans_isr = FALSE;
+		reveil = TRUE;
+		stats.interrupts++;
+
+		if(v == VECTEUR_USART0_UDRE){
+
+			stats.tx_bytes++;
+			tx_libre = maintenant + duree_octet();
+
+			if(tx_log_n < TX_LOG_TAILLE){
+
+				tx_log[tx_log_n++] = UDR0;
+			}
+		}
+	}
+}
+
+
+/* Écritures du microprogramme vues au prochain accès: début d'une conversion */
+static void detecter_ecritures(void){
+
+	if((ADCSRA & (1 << ADSC)) && (adc_fin == JAMAIS)){
+
+		uint8_t division = 1 << (ADCSRA & 0x07);
+
+		adc_fin = maintenant + 13UL * ((division < 2) ? 2 : division);
+	}
+}
+
+
+/* Prochain compte du compteur 1 égal à ocr, après le dernier traitement */
+static uint64_t t1_comparaison(uint16_t ocr){
+
+	uint64_t ecart = (ocr - (uint16_t)t1_dernier) & 0xFFFF;
+
+	return t1_dernier + ((ecart == 0) ? 0x10000 : ecart);
+}
+
+
+/* Division par 8 seulement (pwm1_init()): 1 µs par pas à 8 MHz */
+static bool t1_en_marche(void){
+
+	return (TCCR1B & 0x07) != 0;
+}
+
+
+static uint32_t duree_octet(void){
+
+	uint32_t ubrr = UBRR0;
+
+	if(ubrr == 0){
+
+		ubrr = 51;	// 9600 bauds à 8 MHz, avant uart_init()
+	}
+
+	return 10UL * ((UCSR0A & (1 << U2X0)) ? 8 : 16) * (ubrr + 1);
+}
+
+
+static volatile uint8_t* pin_registre(char port){
+
+	switch(port){
+	case 'A':
+		return &PINA;
+
+	case 'B':
+		return &PINB;
+
+	case 'C':
+		return &PINC;
+
+	default:
+		return &PIND;
+	}
+}
@@ -0,0 +1,178 @@
+#ifndef MCU_H_INCLUDED
+#define MCU_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file mcu.h
+	\brief ATmega324A simulé pour le microprogramme de la grue compilé sur Linux
+
+	Le microprogramme est compilé avec -DSHIM_HOOKS (voir tools/shim): chaque accès
+	à un registre appelle shim_reg(), qui compte un cycle, traite les événements
+	arrivés à échéance et lance les interruptions permises. Le temps simulé avance
+	aussi dans les attentes (_delay_*), la veille (jusqu'à la prochaine interruption),
+	les conversions de l'ADC et les attentes actives sur un fifo plein.
+
+	Périphériques simulés:
+
+	- compteur 1 à 1 µs par pas: comparaisons A et B, bascule de OC1A (servomoteur);
+	- compteurs 0 et 2: seulement les rapports cycliques et les sorties MLI branchées;
+	- USART0: octets reçus au débit de UBRR0, octets envoyés capturés;
+	- ADC: 13 cycles d'horloge de l'ADC par conversion, valeur donnée par canal;
+	- INT0, EEPROM (3,4 ms par écriture) et chien de garde (délais dépassés comptés,
+	  sans redémarrer le microprogramme).
+
+	Les écritures dans TCNT1 sont ignorées: le compteur suit toujours le temps simulé.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define MCU_CYCLES_PAR_US	(F_CPU / 1000000UL)
+#define MCU_CYCLES_PAR_MS	(F_CPU / 1000UL)
+
+/* Adresse d'un registre de tools/shim/avr/io.h, pour mcu_pwm() */
+#define MCU_ADRESSE(reg)	((uint8_t)((volatile uint8_t*)&(reg) - avr_io))
+
+typedef struct{
+
+	uint32_t rx_bytes;		/* octets reçus par l'USART */
+	uint32_t rx_overrun;	/* octets perdus: le précédent n'était pas lu */
+	uint32_t tx_bytes;		/* octets envoyés par l'USART */
+	uint32_t interrupts;	/* interruptions lancées */
+	uint32_t watchdog;		/* délais du chien de garde dépassés */
+	uint64_t sleep_cycles;	/* cycles passés en veille */
+
+}mcu_stats_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Remet les registres, les périphériques et le temps à 0
+	\param[in]	periode Période de l'appel de tick, en cycles
+	\param[in]	tick Appelée à chaque période, hors de toute interruption du microprogramme
+    \return rien.
+*/
+void mcu_init(uint32_t periode, void (*tick)(void));
+
+/**
+    \brief Exécute le microprogramme jusqu'à un instant
+	\param[in]	fin L'instant de fin, en cycles
+	\param[in]	entree Le main() du microprogramme
+    \return rien.
+
+	Au retour, le temps simulé n'avance plus: les fonctions du microprogramme peuvent
+	être appelées pour lire ses résultats (exe.: boot_get_us()).
+*/
+void mcu_run(uint64_t fin, int (*entree)(void));
+
+/**
+    \brief Retourne le temps simulé
+    \return Le nombre de cycles depuis mcu_init()
+*/
+uint64_t mcu_cycles(void);
+
+/**
+    \brief Démarre après un reset du chien de garde ou du BOD, et non à la mise sous tension
+	\param[in]	mcusr La cause du reset, telle que lue dans MCUSR (exe.: 1 << WDRF)
+    \return rien.
+
+	À appeler avant mcu_run(). La RAM gardée d'un reset à l'autre contient alors une
+	boîte noire pleine (blackbox.h), que le microprogramme copie dans l'EEPROM, effacée
+	par mcu_init(): c'est la copie la plus longue.
+*/
+void mcu_reset(uint8_t mcusr);
+
+/**
+    \brief Ajoute un octet à la ligne RXD0; il est reçu une durée d'octet plus tard
+	\param[in]	byte L'octet
+    \return rien.
+*/
+void mcu_uart_send(uint8_t byte);
+
+/**
+    \brief Change le niveau d'une broche d'entrée (registre PINx)
+	\param[in]	port 'A' à 'D'
+	\param[in]	bit Le numéro de la broche
+	\param[in]	niveau 0 ou 1
+    \return rien.
+*/
+void mcu_set_pin(char port, uint8_t bit, uint8_t niveau);
+
+/**
+    \brief Donne la tension d'une entrée de l'ADC
+	\param[in]	canal 0 à 7
+	\param[in]	valeur Le résultat de conversion sur 10 bits
+    \return rien.
+*/
+void mcu_set_adc(uint8_t canal, uint16_t valeur);
+
+/**
+    \brief Front sur INT0: l'interruption est mise en attente
+    \return rien.
+*/
+void mcu_int0(void);
+
+/**
+    \brief Rapport cyclique d'une sortie MLI, 0 si elle est débranchée
+	\param[in]	ocr L'adresse du registre OCR (exe.: MCU_ADRESSE(OCR0A))
+	\param[in]	tccr L'adresse du registre TCCRxA qui branche la sortie (MCU_ADRESSE(TCCR0A))
+	\param[in]	com Le bit COMxx1 de la sortie
+    \return Le rapport cyclique, de 0 à 255
+*/
+uint8_t mcu_pwm(uint8_t ocr, uint8_t tccr, uint8_t com);
+
+/**
+    \brief Niveau d'une sortie (registre PORTx)
+	\param[in]	port 'A' à 'D'
+	\param[in]	bit Le numéro de la broche
+    \return 0 ou 1
+*/
+uint8_t mcu_get_port(char port, uint8_t bit);
+
+/**
+    \brief Largeur de la dernière impulsion complète sur OC1A
+    \return La largeur en µs, 0 avant la première impulsion
+*/
+uint16_t mcu_servo_us(void);
+
+/**
+    \brief Retourne les compteurs depuis mcu_init()
+    \return Les compteurs
+*/
+const mcu_stats_t* mcu_get_stats(void);
+
+/**
+    \brief Écrit les octets envoyés par l'USART, en chaîne JSON
+	\param[in]	f Le fichier de sortie
+    \return rien.
+*/
+void mcu_print_tx(FILE* f);
+
+#endif /* MCU_H_INCLUDED */
@@ -0,0 +1,483 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file plant.c
+	\brief Modèle physique de la grue branché sur les sorties du microcontrôleur simulé
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <math.h>
+#include <string.h>
+#include <avr/io.h>
+#include "plant.h"
+#include "mcu.h"
+#include "battery.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define DT					(PLANT_PAS_US * 1e-6)
+
+#define TENSION_NOMINALE	12.0	/* tension de vmax, en V */
+
+#define ENCODEUR_PAS		15.0	/* degrés entre deux fronts de INT0 (24 par tour) */
+
+/* Le chariot touche sa fin de course à moins de 2 mm du bout */
+#define FIN_COURSE_MM		2.0
+
+/* Repère de la flèche (homing.h): came de 10° qui commence au milieu du secteur 0 */
+#define REPERE_DEG			7.5
+#define REPERE_LARGEUR		10.0
+
+/* Charge: pendule sous le chariot, à une distance du mât de RAYON_MM + chariot */
+#define GRAVITE_MM			9810.0
+#define RAYON_MM			100.0
+#define BALANCEMENT_SEUIL	5.0		/* mm: au-dessous, la charge est considérée immobile */
+
+/* La pince bouge tant que sa largeur a changé depuis moins de 50 ms */
+#define PINCE_REPOS_CYCLES	(50 * MCU_CYCLES_PAR_MS)
+
+typedef struct{
+
+	double vmax;			/* vitesse à 12 V, unités/s */
+	double tau;				/* constante de temps entraînée (inertie), s */
+	double tau_libre;		/* constante de temps en roue libre, s */
+	double frottement;		/* frottement sec, fraction de vmax */
+	bool bornee;
+	double min;
+	double max;
+	uint8_t ocr;			/* adresses de la sortie MLI */
+	uint8_t tccr;
+	uint8_t com;
+	uint8_t dir_pin;		/* broche de direction sur le PORTB */
+
+}axe_config_t;
+
+
+typedef struct{
+
+	double vmax;			/* après les variations de la graine */
+	double frottement;
+	double position;
+	double vitesse;
+	int8_t signe;			/* signe de la dernière commande, 0 si débranchée */
+	bool en_butee;
+
+	double acceleration;	/* du dernier pas, unités/s² */
+
+	bool mesure;			/* dépassement en cours de mesure */
+	int8_t mesure_signe;
+	double mesure_depart;
+
+}axe_t;
+
+
+typedef struct{
+
+	double cable;			/* mm */
+	double amortissement;
+	double ecart[2];		/* position de la charge sous le chariot: radial, tangentiel (mm) */
+	double vitesse[2];		/* mm/s */
+
+}charge_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static const char* const noms[PLANT_NB] = { "fleche", "chariot", "glissiere" };
+
+static axe_config_t config[PLANT_NB];
+static axe_t axes[PLANT_NB];
+static charge_t charge;
+static plant_stats_t stats;
+
+static double vbat;
+static uint32_t aleatoire;
+static long secteur;
+static uint64_t pince_changement;
+static bool pince_bouge;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void step_axe(plant_axe_e i);
+static void step_charge(void);
+static double balancement(void);
+static void step_capteurs(void);
+static void step_pince(void);
+static double variation(double amplitude);
+static int8_t signe(double v);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+void plant_init(uint32_t graine){
+
+	const axe_config_t defaut[PLANT_NB] = {
+
+		{ 60.0, 0.15, 0.40, 0.15, FALSE, 0.0, 0.0,
+			MCU_ADRESSE(OCR0A), MCU_ADRESSE(TCCR0A), COM0A1, PB1 },
+		{ 120.0, 0.08, 0.25, 0.20, TRUE, 0.0, 400.0,
+			MCU_ADRESSE(OCR0B), MCU_ADRESSE(TCCR0A), COM0B1, PB2 },
+		{ 80.0, 0.10, 0.30, 0.25, TRUE, 0.0, 250.0,
+			MCU_ADRESSE(OCR2B), MCU_ADRESSE(TCCR2A), COM2B1, PB0 },
+	};
+
+	memcpy(config, defaut, sizeof(config));
+	memset(axes, 0, sizeof(axes));
+	memset(&stats, 0, sizeof(stats));
+	memset(&charge, 0, sizeof(charge));
+
+	// xorshift32: ne doit jamais valoir 0
+	aleatoire = graine * 2654435761u + 1;
+	aleatoire = (aleatoire == 0) ? 1 : aleatoire;
+
+	for(plant_axe_e i = 0; i < PLANT_NB; i++){
+
+		axes[i].vmax = config[i].vmax * (1.0 + variation(0.05));
+		axes[i].frottement = config[i].frottement * (1.0 + variation(0.10));
+		axes[i].position = (config[i].min + config[i].max) / 2;
+	}
+
+	charge.cable = PLANT_CABLE_MM;
+	charge.amortissement = PLANT_AMORTISSEMENT;
+
+	secteur = 0;
+	pince_changement = 0;
+	pince_bouge = FALSE;
+
+	// Fins de course et repère relâchés
+	mcu_set_pin('A', PA0, 1);
+	mcu_set_pin('A', PA1, 1);
+	mcu_set_pin('A', PA2, 1);
+	plant_set_battery(BATTERY_NOMINAL_MV);
+}
+
+
+void plant_step(void){
+
+	bool bouge = FALSE;
+
+	for(plant_axe_e i = 0; i < PLANT_NB; i++){
+
+		step_axe(i);
+		bouge |= (axes[i].vitesse != 0.0);
+	}
+
+	// Temps de cycle: du premier mouvement au dernier arrêt de tous les axes
+	if(bouge && (stats.premier_mouvement == 0)){
+
+		stats.premier_mouvement = mcu_cycles();
+	}
+
+	if(!bouge && stats.en_mouvement){
+
+		stats.dernier_arret = mcu_cycles();
+		stats.balancement_arrets += balancement();
+		stats.arrets++;
+	}
+
+	stats.en_mouvement = bouge;
+
+	step_charge();
+	step_capteurs();
+	step_pince();
+}
+
+
+void plant_set_battery(uint16_t mv){
+
+	vbat = mv / 1000.0;
+	mcu_set_adc(BATTERY_CHANNEL, (uint32_t)mv * 1024 / BATTERY_FULL_SCALE_MV);
+}
+
+
+void plant_set_cable(double mm){
+
+	charge.cable = mm;
+}
+
+
+void plant_set_position(plant_axe_e axe, double position){
+
+	if(config[axe].bornee){
+
+		position = fmax(config[axe].min, fmin(config[axe].max, position));
+	}
+
+	axes[axe].position = position;
+	axes[axe].vitesse = 0.0;
+	axes[axe].en_butee = config[axe].bornee &&
+		((position <= config[axe].min) || (position >= config[axe].max));
+
+	if(axe == PLANT_FLECHE){
+
+		secteur = floor(position / ENCODEUR_PAS);
+	}
+
+	step_capteurs();
+}
+
+
+const char* plant_axe_name(plant_axe_e axe){
+
+	return noms[axe];
+}
+
+
+const plant_stats_t* plant_get_stats(void){
+
+	for(plant_axe_e i = 0; i < PLANT_NB; i++){
+
+		stats.axe[i].position = axes[i].position;
+	}
+
+	stats.pince_us = mcu_servo_us();
+	stats.balancement_final = balancement();
+
+	return &stats;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void step_axe(plant_axe_e i){
+
+	const axe_config_t* c = &config[i];
+	axe_t* a = &axes[i];
+	plant_axe_stats_t* s = &stats.axe[i];
+
+	uint8_t duty = mcu_pwm(c->ocr, c->tccr, c->com);
+	int8_t sens = mcu_get_port('B', c->dir_pin) ? -1 : 1;
+	int8_t commande = (duty != 0) ? sens : 0;
+	double acceleration;
+
+	if(commande != 0){
+
+		double cible = commande * a->vmax * (vbat * duty / 255) / TENSION_NOMINALE;
+
+		acceleration = (cible - a->vitesse) / c->tau;
+	}
+
+	else{
+
+		acceleration = -a->vitesse / c->tau_libre;
+	}
+
+	// Frottement sec: retient l'axe arrêté, freine l'axe en mouvement
+	double frottement = a->frottement * a->vmax / c->tau;
+
+	if(a->vitesse == 0.0){
+
+		acceleration = (fabs(acceleration) <= frottement) ? 0.0 :
+			acceleration - signe(acceleration) * frottement;
+	}
+
+	else{
+
+		acceleration -= signe(a->vitesse) * frottement;
+	}
+
+	double vitesse = a->vitesse + acceleration * DT;
+
+	// Passage par 0: l'axe s'arrête, le frottement décide au pas suivant
+	if((a->vitesse != 0.0) && (signe(vitesse) != signe(a->vitesse))){
+
+		vitesse = 0.0;
+	}
+
+	// Dépassement: course après l'arrêt ou l'inversion de la commande
+	if(!a->mesure && (a->signe != 0) && (commande != a->signe) &&
+		(signe(a->vitesse) == a->signe)){
+
+		a->mesure = TRUE;
+		a->mesure_signe = a->signe;
+		a->mesure_depart = a->position;
+		s->stops++;
+	}
+
+	double depart = a->position;
+
+	a->acceleration = (vitesse - a->vitesse) / DT;
+	a->vitesse = vitesse;
+	a->position += vitesse * DT;
+	a->signe = commande;
+
+	bool butee = FALSE;
+
+	if(c->bornee && (a->position <= c->min)){
+
+		a->position = c->min;
+		a->vitesse = fmax(a->vitesse, 0.0);
+		butee = TRUE;
+	}
+
+	if(c->bornee && (a->position >= c->max)){
+
+		a->position = c->max;
+		a->vitesse = fmin(a->vitesse, 0.0);
+		butee = TRUE;
+	}
+
+	if(butee && !a->en_butee){
+
+		s->limit_hits++;
+	}
+
+	a->en_butee = butee;
+	s->travel += fabs(a->position - depart);
+
+	if(a->mesure && (signe(a->vitesse) != a->mesure_signe)){
+
+		double depassement = fabs(a->position - a->mesure_depart);
+
+		a->mesure = FALSE;
+		s->overshoot_sum += depassement;
+		s->overshoot_max = fmax(s->overshoot_max, depassement);
+	}
+}
+
+
+/*
+	Pendule amorti aux petits angles, poussé par l'accélération du point d'attache:
+
+		e'' = -w^2.e - 2.z.w.e' - a,   w = sqrt(g / L)
+
+	radial: accélération du chariot; tangentiel: accélération angulaire de la flèche
+	multipliée par la distance du chariot au mât.
+*/
+static void step_charge(void){
+
+	double w = sqrt(GRAVITE_MM / charge.cable);
+	double rayon = RAYON_MM + axes[PLANT_CHARIOT].position;
+	double attache[2] = {
+		axes[PLANT_CHARIOT].acceleration,
+		axes[PLANT_FLECHE].acceleration * M_PI / 180.0 * rayon
+	};
+
+	for(uint8_t i = 0; i < 2; i++){
+
+		double acceleration = -w * w * charge.ecart[i] -
+			2.0 * charge.amortissement * w * charge.vitesse[i] - attache[i];
+
+		// Euler semi-implicite: stable au pas de PLANT_PAS_US
+		charge.vitesse[i] += acceleration * DT;
+		charge.ecart[i] += charge.vitesse[i] * DT;
+	}
+
+	double amplitude = balancement();
+
+	stats.balancement_max = fmax(stats.balancement_max, amplitude);
+
+	if(amplitude >= BALANCEMENT_SEUIL){
+
+		stats.dernier_balancement = mcu_cycles();
+	}
+}
+
+
+/* Amplitude du balancement: écart maximal de l'oscillation en cours, en mm */
+static double balancement(void){
+
+	double w = sqrt(GRAVITE_MM / charge.cable);
+	double somme = 0.0;
+
+	for(uint8_t i = 0; i < 2; i++){
+
+		somme += charge.ecart[i] * charge.ecart[i] +
+			(charge.vitesse[i] / w) * (charge.vitesse[i] / w);
+	}
+
+	return sqrt(somme);
+}
+
+
+/* Fins de course du chariot, encodeur et repère de la flèche */
+static void step_capteurs(void){
+
+	const axe_t* chariot = &axes[PLANT_CHARIOT];
+	const axe_t* fleche = &axes[PLANT_FLECHE];
+
+	mcu_set_pin('A', PA0, chariot->position > config[PLANT_CHARIOT].min + FIN_COURSE_MM);
+	mcu_set_pin('A', PA1, chariot->position < config[PLANT_CHARIOT].max - FIN_COURSE_MM);
+
+	double tour = fmod(fleche->position, 360.0);
+
+	tour += (tour < 0.0) ? 360.0 : 0.0;
+	mcu_set_pin('A', PA2, (tour < REPERE_DEG) || (tour >= REPERE_DEG + REPERE_LARGEUR));
+
+	long s = floor(fleche->position / ENCODEUR_PAS);
+
+	// Un front montant sur PD2 par pas, PD3 donne le sens (1 = horaire)
+	if(s != secteur){
+
+		mcu_set_pin('D', PD3, s > secteur);
+		mcu_int0();
+		secteur += (s > secteur) ? 1 : -1;
+	}
+}
+
+
+static void step_pince(void){
+
+	uint16_t largeur = mcu_servo_us();
+	uint64_t maintenant = mcu_cycles();
+
+	if(largeur != stats.pince_us){
+
+		if(!pince_bouge && (stats.pince_us != 0)){
+
+			stats.pince_mouvements++;
+		}
+
+		stats.pince_us = largeur;
+		pince_changement = maintenant;
+		pince_bouge = TRUE;
+	}
+
+	else if(pince_bouge && (maintenant - pince_changement > PINCE_REPOS_CYCLES)){
+
+		pince_bouge = FALSE;
+	}
+}
+
+
+/* Tirage uniforme dans [-amplitude, amplitude] */
+static double variation(double amplitude){
+
+	aleatoire ^= aleatoire << 13;
+	aleatoire ^= aleatoire >> 17;
+	aleatoire ^= aleatoire << 5;
+
+	return amplitude * (2.0 * aleatoire / UINT32_MAX - 1.0);
+}
+
+
+static int8_t signe(double v){
+
+	return (v > 0.0) - (v < 0.0);
+}
@@ -0,0 +1,161 @@
+#ifndef PLANT_H_INCLUDED
+#define PLANT_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file plant.h
+	\brief Modèle physique de la grue branché sur les sorties du microcontrôleur simulé
+
+	Chaque axe est un moteur à courant continu du premier ordre, en unités de sortie:
+
+		Axe          Unité   Course                       Capteurs
+		Flèche       degré   sans butée                   encodeur: INT0 tous les 15°, sens sur PD3
+		                                                  repère PA2 de 7,5° à 17,5°, actif à 0
+		Chariot      mm      0 à 400                      fins de course PA0 (0) et PA1 (400), actives à 0
+		Glissière    mm      0 à 250                      butées mécaniques seulement
+
+	La tension appliquée est Vbat * rapport cyclique / 255 quand la sortie MLI est
+	branchée; la vitesse tend vers vmax * tension / 12 V avec la constante de temps de
+	l'axe (inertie). Sortie débranchée ou rapport cyclique nul: roue libre, avec une
+	constante de temps plus longue. Le frottement sec retient l'axe à l'arrêt tant que
+	la commande ne le dépasse pas. La broche de direction à 1 fait reculer l'axe.
+
+	La charge pend sous le chariot au bout d'un câble de PLANT_CABLE_MM: c'est un
+	pendule amorti, poussé par les accélérations du chariot (balancement radial) et de
+	la flèche (tangentiel). Son amplitude est mesurée à chaque arrêt de tous les axes;
+	elle est sous le seuil de 5 mm quand la charge est considérée immobile.
+
+	La pince suit la largeur d'impulsion de OC1A. La batterie donne l'entrée de l'ADC
+	de battery.h et la tension des moteurs.
+
+	La graine de plant_init() fait varier le frottement (±10 %) et vmax (±5 %) de chaque
+	axe: la même graine donne toujours la même grue.
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdint.h>
+#include "utils.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* Période du pas du modèle, en µs */
+#define PLANT_PAS_US	100
+
+/* Charge: longueur du câble (mm) et amortissement du balancement */
+#define PLANT_CABLE_MM		400.0
+#define PLANT_AMORTISSEMENT	0.02
+
+typedef enum{
+
+	PLANT_FLECHE = 0,
+	PLANT_CHARIOT,
+	PLANT_GLISSIERE,
+
+	PLANT_NB
+
+}plant_axe_e;
+
+
+typedef struct{
+
+	double position;		/* position finale */
+	uint32_t stops;			/* arrêts de la commande pendant un mouvement */
+	double overshoot_max;	/* plus grande course après un arrêt ou une inversion */
+	double overshoot_sum;
+	uint32_t limit_hits;	/* arrivées en fin de course ou en butée */
+	double travel;			/* distance parcourue */
+
+}plant_axe_stats_t;
+
+
+typedef struct{
+
+	plant_axe_stats_t axe[PLANT_NB];
+	uint64_t premier_mouvement;	/* cycles, 0 si aucun axe n'a bougé */
+	uint64_t dernier_arret;		/* cycles, fin du dernier mouvement */
+	bool en_mouvement;			/* un axe bouge encore */
+	uint16_t pince_us;			/* largeur d'impulsion de la pince */
+	uint32_t pince_mouvements;	/* changements de largeur de la pince */
+	double balancement_max;		/* amplitude du balancement de la charge, mm */
+	double balancement_arrets;	/* somme des amplitudes à l'arrêt de tous les axes */
+	uint32_t arrets;
+	double balancement_final;
+	uint64_t dernier_balancement;	/* cycles, dernier instant au-dessus du seuil */
+
+}plant_stats_t;
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Place la grue au repos: axes au milieu de leur course, batterie pleine
+	\param[in]	graine La graine des variations entre grues
+    \return rien.
+*/
+void plant_init(uint32_t graine);
+
+/**
+    \brief Avance le modèle de PLANT_PAS_US et met à jour les entrées du microcontrôleur
+    \return rien.
+*/
+void plant_step(void);
+
+/**
+    \brief Change la tension de la batterie
+	\param[in]	mv La tension en mV
+    \return rien.
+*/
+void plant_set_battery(uint16_t mv);
+
+/**
+    \brief Change la longueur du câble de la charge
+	\param[in]	mm La longueur du câble
+    \return rien.
+*/
+void plant_set_cable(double mm);
+
+/**
+    \brief Déplace un axe à l'arrêt, sans compter le mouvement
+	\param[in]	axe L'axe
+	\param[in]	position La position, bornée à la course de l'axe
+    \return rien.
+*/
+void plant_set_position(plant_axe_e axe, double position);
+
+/**
+    \brief Retourne le nom d'un axe (JSON)
+	\param[in]	axe L'axe
+    \return Le nom, exe.: "chariot"
+*/
+const char* plant_axe_name(plant_axe_e axe);
+
+/**
+    \brief Retourne les mesures depuis plant_init()
+    \return Les mesures
+*/
+const plant_stats_t* plant_get_stats(void);
+
+#endif /* PLANT_H_INCLUDED */
@@ -0,0 +1,478 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file scenario.c
+	\brief Scénario du jumeau numérique, même format que tools/bench/scenario.h
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <avr/io.h>
+
+#include "scenario.h"
+#include "mcu.h"
+#include "plant.h"
+#include "trame.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+#define LINE_SIZE		256
+#define MAX_BYTES		32
+
+typedef enum{
+
+	EVENT_FRAME = 0,
+	EVENT_UART,
+	EVENT_PIN,
+	EVENT_BATTERY,
+	EVENT_POSITION,
+	EVENT_CABLE,
+	EVENT_RESET,
+	EVENT_END
+
+}event_type_e;
+
+
+typedef struct{
+
+	uint32_t at_ms;
+	size_t seq;				/* ordre dans le fichier */
+	event_type_e type;
+	char port;
+	uint8_t pin;
+	uint32_t value;
+	double position;
+	uint8_t bytes[MAX_BYTES];
+	uint8_t nb_bytes;
+
+}event_t;
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static event_t* events = NULL;
+static size_t nb_events = 0;
+static size_t cap_events = 0;
+static size_t next_event = 0;
+static uint32_t end_ms = 0;
+static uint8_t frame_seq = 0;
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void add_event(const event_t* e){
+
+	if(nb_events == cap_events){
+
+		cap_events = cap_events ? cap_events * 2 : 64;
+		events = realloc(events, cap_events * sizeof(event_t));
+
+		if(events == NULL){
+
+			perror("realloc");
+			exit(1);
+		}
+	}
+
+	events[nb_events] = *e;
+	events[nb_events].seq = nb_events;
+	nb_events++;
+}
+
+
+static int compare_events(const void* a, const void* b){
+
+	const event_t* x = a;
+	const event_t* y = b;
+
+	// Même instant: l'ordre du fichier est gardé
+	if(x->at_ms != y->at_ms){
+
+		return (x->at_ms > y->at_ms) - (x->at_ms < y->at_ms);
+	}
+
+	return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+
+/* Lit les octets d'une commande frame ou uart, retourne le nombre lu ou -1 */
+static int parse_bytes(char* args, uint8_t* bytes){
+
+	int n = 0;
+	char* tok;
+
+	while((tok = strtok(args, " \t\r\n")) != NULL){
+
+		char* end;
+		unsigned long v = strtoul(tok, &end, 0);
+
+		args = NULL;
+
+		if((*end != '\0') || (v > 255) || (n == MAX_BYTES)){
+
+			return -1;
+		}
+
+		bytes[n++] = v;
+	}
+
+	return n;
+}
+
+
+static int parse_line(char* line, event_t* e, uint32_t* period_ms, uint32_t* count){
+
+	char* time = strtok(line, " \t\r\n");
+	char* cmd = strtok(NULL, " \t\r\n");
+	char* args = strtok(NULL, "");
+	char* end;
+
+	if((time == NULL) || (cmd == NULL)){
+
+		return -1;
+	}
+
+	memset(e, 0, sizeof(*e));
+	*period_ms = 0;
+	*count = 1;
+
+	e->at_ms = strtoul(time, &end, 10);
+
+	if(*end == '+'){
+
+		*period_ms = strtoul(end + 1, &end, 10);
+
+		if(*end != '*'){
+
+			return -1;
+		}
+
+		*count = strtoul(end + 1, &end, 10);
+	}
+
+	if(*end != '\0'){
+
+		return -1;
+	}
+
+	if(args == NULL){
+
+		args = "";
+	}
+
+	if(strcmp(cmd, "frame") == 0){
+
+		e->type = EVENT_FRAME;
+
+		if(parse_bytes(args, e->bytes) != TRAME_SEQ){
+
+			return -1;
+		}
+
+		// Une valeur de '\n' couperait la trame (la manette envoie 11 à la place)
+		for(uint8_t i = 0; i < TRAME_SEQ; i++){
+
+			if(e->bytes[i] == '\n'){
+
+				return -1;
+			}
+		}
+
+		e->nb_bytes = TRAME_SEQ;
+	}
+
+	else if(strcmp(cmd, "uart") == 0){
+
+		int n = parse_bytes(args, e->bytes);
+
+		if(n <= 0){
+
+			return -1;
+		}
+
+		e->type = EVENT_UART;
+		e->nb_bytes = n;
+	}
+
+	else if(strcmp(cmd, "pin") == 0){
+
+		char pin[8];
+		unsigned level;
+
+		if((sscanf(args, "%7s %u", pin, &level) != 2) || (strlen(pin) != 2) || (level > 1)){
+
+			return -1;
+		}
+
+		e->type = EVENT_PIN;
+		e->port = toupper((unsigned char)pin[0]);
+		e->pin = pin[1] - '0';
+		e->value = level;
+
+		if((e->port < 'A') || (e->port > 'D') || (e->pin > 7)){
+
+			return -1;
+		}
+	}
+
+	else if(strcmp(cmd, "battery") == 0){
+
+		unsigned mv;
+
+		if((sscanf(args, "%u", &mv) != 1) || (mv > UINT16_MAX)){
+
+			return -1;
+		}
+
+		e->type = EVENT_BATTERY;
+		e->value = mv;
+	}
+
+	else if(strcmp(cmd, "position") == 0){
+
+		char nom[16];
+
+		if(sscanf(args, "%15s %lf", nom, &e->position) != 2){
+
+			return -1;
+		}
+
+		e->type = EVENT_POSITION;
+		e->value = PLANT_NB;
+
+		for(plant_axe_e i = 0; i < PLANT_NB; i++){
+
+			if(strcmp(nom, plant_axe_name(i)) == 0){
+
+				e->value = i;
+			}
+		}
+
+		if(e->value == PLANT_NB){
+
+			return -1;
+		}
+	}
+
+	else if(strcmp(cmd, "cable") == 0){
+
+		if((sscanf(args, "%lf", &e->position) != 1) || (e->position <= 0.0)){
+
+			return -1;
+		}
+
+		e->type = EVENT_CABLE;
+	}
+
+	else if(strcmp(cmd, "reset") == 0){
+
+		char cause[8];
+
+		// Le reset précède le démarrage du microprogramme
+		if((e->at_ms != 0) || (*period_ms != 0) || (sscanf(args, "%7s", cause) != 1)){
+
+			return -1;
+		}
+
+		if(strcmp(cause, "wdt") == 0){
+
+			e->value = 1 << WDRF;
+		}
+
+		else if(strcmp(cause, "bor") == 0){
+
+			e->value = 1 << BORF;
+		}
+
+		else{
+
+			return -1;
+		}
+
+		e->type = EVENT_RESET;
+	}
+
+	else if(strcmp(cmd, "end") == 0){
+
+		e->type = EVENT_END;
+	}
+
+	else{
+
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void run_event(const event_t* e){
+
+	switch(e->type){
+
+	case EVENT_FRAME:
+
+		for(uint8_t i = 0; i < e->nb_bytes; i++){
+
+			mcu_uart_send(e->bytes[i]);
+		}
+
+		// Numéro de séquence et temps de la manette, sur 7 bits par octet
+		mcu_uart_send(TRAME_CODE_7(frame_seq));
+		mcu_uart_send(TRAME_CODE_7(e->at_ms));
+		mcu_uart_send(TRAME_CODE_7(e->at_ms >> 7));
+		mcu_uart_send('\n');
+		frame_seq = (frame_seq + 1) & TRAME_SEQ_MASQUE;
+		break;
+
+	case EVENT_UART:
+
+		for(uint8_t i = 0; i < e->nb_bytes; i++){
+
+			mcu_uart_send(e->bytes[i]);
+		}
+		break;
+
+	case EVENT_PIN:
+
+		mcu_set_pin(e->port, e->pin, e->value);
+		break;
+
+	case EVENT_BATTERY:
+
+		plant_set_battery(e->value);
+		break;
+
+	case EVENT_POSITION:
+
+		plant_set_position(e->value, e->position);
+		break;
+
+	case EVENT_CABLE:
+
+		plant_set_cable(e->position);
+		break;
+
+	case EVENT_RESET:
+
+		mcu_reset(e->value);
+		break;
+
+	case EVENT_END:
+		break;
+	}
+}
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int scenario_load(const char* path){
+
+	FILE* file = fopen(path, "r");
+	char line[LINE_SIZE];
+	unsigned line_no = 0;
+
+	if(file == NULL){
+
+		perror(path);
+		return -1;
+	}
+
+	nb_events = 0;
+	next_event = 0;
+	end_ms = 0;
+	frame_seq = 0;
+
+	while(fgets(line, sizeof(line), file) != NULL){
+
+		char* p = line;
+		event_t e;
+		uint32_t period_ms;
+		uint32_t count;
+
+		line_no++;
+
+		// Un # commence un commentaire jusqu'à la fin de la ligne
+		if(strchr(p, '#') != NULL){
+
+			*strchr(p, '#') = '\0';
+		}
+
+		while(isspace((unsigned char)*p)){
+
+			p++;
+		}
+
+		if(*p == '\0'){
+
+			continue;
+		}
+
+		if(parse_line(p, &e, &period_ms, &count) != 0){
+
+			fprintf(stderr, "%s:%u: ligne invalide\n", path, line_no);
+			fclose(file);
+			return -1;
+		}
+
+		if(e.type == EVENT_END){
+
+			end_ms = e.at_ms;
+		}
+
+		for(uint32_t i = 0; i < count; i++){
+
+			add_event(&e);
+			e.at_ms += period_ms;
+		}
+	}
+
+	fclose(file);
+
+	qsort(events, nb_events, sizeof(event_t), compare_events);
+
+	return 0;
+}
+
+
+uint32_t scenario_end_ms(void){
+
+	return end_ms;
+}
+
+
+void scenario_run(uint32_t now_ms){
+
+	while((next_event < nb_events) && (events[next_event].at_ms <= now_ms)){
+
+		run_event(&events[next_event]);
+		next_event++;
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef SCENARIO_H_INCLUDED
+#define SCENARIO_H_INCLUDED
+
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file scenario.h
+	\brief Scénario du jumeau numérique, même format que tools/bench/scenario.h
+
+	Une ligne par événement. Un # commence un commentaire et les lignes vides sont
+	ignorées:
+
+		<temps> <commande> <arguments...>
+
+	Le temps est en ms depuis le démarrage. La forme début+période*nombre répète
+	l'événement: 200+100*20 le place à 200, 300, ..., 2100 ms.
+
+	Commandes:
+
+		frame y x g p a		trame de la manette sur UART_0; le jumeau ajoute le numéro
+							de séquence et le temps de la manette (trame.h)
+		uart o1 o2 ...		octets bruts sur UART_0 (décimal ou 0x..)
+		pin <port><bit> n	niveau d'une broche d'entrée, exe.: pin A3 1
+		battery mV			tension de la batterie des moteurs
+		position <axe> v	place un axe (fleche, chariot, glissiere) à l'arrêt
+		cable mm			longueur du câble de la charge (PLANT_CABLE_MM au départ)
+		reset wdt|bor		au temps 0 seulement: démarrage après un reset du chien de
+							garde ou du BOD, boîte noire pleine (mcu_reset())
+		end					fin de la simulation
+
+	Exe.: voir scenarios/automation.txt
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+Prototypes
+---------------------------------------------------------------------------- */
+
+/**
+    \brief Lit un fichier de scénario
+	\param[in]	path Le fichier à lire
+    \return 0, ou -1 en cas d'erreur (le message indique la ligne fautive)
+*/
+int scenario_load(const char* path);
+
+/**
+    \brief Retourne l'instant de la commande end
+    \return L'instant en ms, 0 si le scénario n'a pas de commande end
+*/
+uint32_t scenario_end_ms(void);
+
+/**
+    \brief Exécute les événements arrivés à échéance
+	\param[in]	now_ms Le temps simulé, en ms
+    \return rien.
+*/
+void scenario_run(uint32_t now_ms);
+
+#endif /* SCENARIO_H_INCLUDED */
@@ -0,0 +1,383 @@
+/*
+	 __ ___  __
+	|_   |  (_
+	|__  |  __)
+
+	MIT License
+
+	Copyright (c) 2018	École de technologie supérieure
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify and/or merge copies of the Software, and to permit persons
+	to whom the Software is furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+*/
+/**
+	\file twin.c
+	\brief Jumeau numérique de la grue: le microprogramme, un ATmega324A simulé et la mécanique
+
+	Le microprogramme de la grue est compilé sans changement pour Linux (main() devient
+	grue_main()) et exécuté sur le microcontrôleur de mcu.h, branché sur le modèle
+	physique de plant.h. Chaque scénario est rejoué dans un processus à part, qui
+	repart donc de la mise sous tension avec des variables statiques neuves.
+
+	Le temps simulé avance -x fois plus vite que le temps réel (100 par défaut); -x 0
+	retire l'attente et donne la vitesse maximale. Le résultat ne dépend que du scénario
+	et de la graine (-s): la vitesse change seulement le temps réel passé.
+
+	Pour chaque scénario, le résultat JSON donne:
+
+	- cycle_ms: du premier mouvement d'un axe à l'arrêt du dernier (settled à false si
+	  un axe bouge encore à la fin);
+	- par axe: position finale, distance parcourue, arrêts de la commande pendant un
+	  mouvement, dépassement (course après l'arrêt ou l'inversion) maximal et moyen,
+	  arrivées en fin de course ou en butée;
+	- le balancement de la charge: amplitude maximale, moyenne à l'arrêt de tous les
+	  axes, finale, et temps après le dernier arrêt pour passer sous 5 mm (settle_ms);
+	- la pince, le chien de garde, l'USART (octets envoyés en texte) et la veille;
+	- le démarrage (boot.h): réception des commandes prête, première commande valide,
+	  première MLI d'un moteur et LCD prêt, en ms (null si pas atteint).
+
+	Avec -d, le code de retour est 1 si la première commande valide ou la première MLI
+	d'un scénario dépasse DEMARRAGE_COMMANDE_MAX_MS ou DEMARRAGE_MLI_MAX_MS (make boot).
+
+	Usage: twin [-d] [-s graine] [-x vitesse] [-t durée_ms] scénario...
+*/
+
+/* ----------------------------------------------------------------------------
+Includes
+---------------------------------------------------------------------------- */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcu.h"
+#include "plant.h"
+#include "scenario.h"
+#include "boot.h"
+#include "stack.h"
+
+/* ----------------------------------------------------------------------------
+Defines et typedef
+---------------------------------------------------------------------------- */
+
+/* L'attente du temps réel est faite toutes les 10 ms simulées */
+#define ATTENTE_MS		10
+
+/* Limites de -d: une trame de 9,4 ms reçue dès la mise sous tension, les moteurs
+commandés dès la boucle principale */
+#define DEMARRAGE_COMMANDE_MAX_MS	15
+#define DEMARRAGE_MLI_MAX_MS		5
+
+int grue_main(void);
+
+/* ----------------------------------------------------------------------------
+Static variables
+---------------------------------------------------------------------------- */
+
+static unsigned vitesse = 100;
+static bool demarrage = FALSE;
+static struct timespec debut;
+static uint32_t prochaine_attente_ms;
+
+/* ----------------------------------------------------------------------------
+Static prototypes
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog);
+static int run(const char* chemin, uint32_t graine, uint32_t duree_ms);
+static void tick(void);
+static double ecoule_ms(void);
+static void print_result(const char* chemin, uint32_t graine);
+static void print_boot_ms(const char* nom, boot_step_e etape, const char* fin);
+static bool boot_ok(const char* chemin);
+
+/* ----------------------------------------------------------------------------
+Function definition
+---------------------------------------------------------------------------- */
+
+int main(int argc, char** argv){
+
+	uint32_t graine = 1;
+	uint32_t duree_ms = 10000;
+	int opt;
+	int erreurs = 0;
+
+	while((opt = getopt(argc, argv, "ds:x:t:")) != -1){
+
+		switch(opt){
+		case 'd':
+			demarrage = TRUE;
+			break;
+
+		case 's':
+			graine = strtoul(optarg, NULL, 0);
+			break;
+
+		case 'x':
+			vitesse = strtoul(optarg, NULL, 0);
+			break;
+
+		case 't':
+			duree_ms = strtoul(optarg, NULL, 0);
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if((optind == argc) || (duree_ms == 0)){
+
+		usage(argv[0]);
+	}
+
+	printf("[\n");
+
+	for(int i = optind; i < argc; i++){
+
+		if(i > optind){
+
+			printf(",\n");
+		}
+
+		int resultat = run(argv[i], graine, duree_ms);
+
+		if(resultat < 0){
+
+			printf("  {\"scenario\": \"%s\", \"error\": true}", argv[i]);
+		}
+
+		if(resultat != 0){
+
+			erreurs++;
+		}
+	}
+
+	printf("\n]\n");
+
+	return (erreurs != 0) ? 1 : 0;
+}
+
+
+/* Sans pile mesurable sur Linux: la commande ?M n'est pas reconnue (voir stack.h) */
+bool stack_command(const char* ligne, uint8_t longueur){
+
+	(void)ligne;
+	(void)longueur;
+
+	return FALSE;
+}
+
+/* ----------------------------------------------------------------------------
+Static function definition
+---------------------------------------------------------------------------- */
+
+static void usage(const char* prog){
+
+	fprintf(stderr, "usage: %s [-d] [-s graine] [-x vitesse] [-t durée_ms] scénario...\n", prog);
+	exit(2);
+}
+
+
+/* Rejoue un scénario dans un processus fils, retourne 0 si son résultat a été écrit, 1 si
+ses temps de démarrage dépassent leur limite (-d), -1 sinon */
+static int run(const char* chemin, uint32_t graine, uint32_t duree_ms){
+
+	int statut;
+
+	fflush(stdout);
+
+	pid_t pid = fork();
+
+	if(pid < 0){
+
+		perror("fork");
+		return -1;
+	}
+
+	if(pid == 0){
+
+		if(scenario_load(chemin) != 0){
+
+			_exit(2);
+		}
+
+		if(scenario_end_ms() != 0){
+
+			duree_ms = scenario_end_ms();
+		}
+
+		mcu_init(PLANT_PAS_US * MCU_CYCLES_PAR_US, tick);
+		plant_init(graine);
+		scenario_run(0);
+
+		clock_gettime(CLOCK_MONOTONIC, &debut);
+		prochaine_attente_ms = ATTENTE_MS;
+
+		mcu_run((uint64_t)duree_ms * MCU_CYCLES_PAR_MS, grue_main);
+
+		print_result(chemin, graine);
+		fflush(stdout);
+		_exit((!demarrage || boot_ok(chemin)) ? 0 : 1);
+	}
+
+	if(waitpid(pid, &statut, 0) < 0){
+
+		perror("waitpid");
+		return -1;
+	}
+
+	if(!WIFEXITED(statut) || (WEXITSTATUS(statut) > 1)){
+
+		return -1;
+	}
+
+	return WEXITSTATUS(statut);
+}
+
+
+/* Pas du modèle, événements du scénario et attente du temps réel */
+static void tick(void){
+
+	uint32_t maintenant_ms = mcu_cycles() / MCU_CYCLES_PAR_MS;
+
+	plant_step();
+	scenario_run(maintenant_ms);
+
+	if((vitesse != 0) && (maintenant_ms >= prochaine_attente_ms)){
+
+		// Instant réel visé: debut + temps simulé / vitesse
+		uint64_t ns = (uint64_t)maintenant_ms * 1000000ULL / vitesse;
+		struct timespec cible = debut;
+
+		cible.tv_sec += ns / 1000000000ULL;
+		cible.tv_nsec += ns % 1000000000ULL;
+
+		if(cible.tv_nsec >= 1000000000L){
+
+			cible.tv_sec++;
+			cible.tv_nsec -= 1000000000L;
+		}
+
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &cible, NULL);
+		prochaine_attente_ms = maintenant_ms + ATTENTE_MS;
+	}
+}
+
+
+static double ecoule_ms(void){
+
+	struct timespec fin;
+
+	clock_gettime(CLOCK_MONOTONIC, &fin);
+
+	return (fin.tv_sec - debut.tv_sec) * 1e3 + (fin.tv_nsec - debut.tv_nsec) / 1e6;
+}
+
+
+static void print_result(const char* chemin, uint32_t graine){
+
+	const plant_stats_t* p = plant_get_stats();
+	const mcu_stats_t* m = mcu_get_stats();
+	uint64_t cycles = mcu_cycles();
+	double sim_ms = (double)cycles / MCU_CYCLES_PAR_MS;
+	double wall_ms = ecoule_ms();
+	double cycle_ms = 0.0;
+
+	if(p->premier_mouvement != 0){
+
+		uint64_t fin = p->en_mouvement ? cycles : p->dernier_arret;
+
+		cycle_ms = (double)(fin - p->premier_mouvement) / MCU_CYCLES_PAR_MS;
+	}
+
+	printf("  {\n");
+	printf("    \"scenario\": \"%s\",\n", chemin);
+	printf("    \"seed\": %u,\n", graine);
+	printf("    \"sim_ms\": %.0f,\n", sim_ms);
+	printf("    \"wall_ms\": %.1f,\n", wall_ms);
+	printf("    \"speedup\": %.1f,\n", (wall_ms > 0.0) ? sim_ms / wall_ms : 0.0);
+	printf("    \"cycle_ms\": %.1f,\n", cycle_ms);
+	printf("    \"settled\": %s,\n", p->en_mouvement ? "false" : "true");
+	printf("    \"axes\": {\n");
+
+	for(plant_axe_e i = 0; i < PLANT_NB; i++){
+
+		const plant_axe_stats_t* a = &p->axe[i];
+
+		printf("      \"%s\": {\"position\": %.1f, \"travel\": %.1f, \"stops\": %u, "
+			"\"overshoot_max\": %.2f, \"overshoot_mean\": %.2f, \"limit_hits\": %u}%s\n",
+			plant_axe_name(i), a->position, a->travel, a->stops, a->overshoot_max,
+			(a->stops != 0) ? a->overshoot_sum / a->stops : 0.0, a->limit_hits,
+			(i + 1 < PLANT_NB) ? "," : "");
+	}
+
+	printf("    },\n");
+	printf("    \"sway\": {\"max_mm\": %.1f, \"at_stop_mm\": %.1f, \"final_mm\": %.1f, "
+		"\"settle_ms\": %.1f},\n", p->balancement_max,
+		(p->arrets != 0) ? p->balancement_arrets / p->arrets : 0.0, p->balancement_final,
+		(p->dernier_balancement > p->dernier_arret) ?
+		(double)(p->dernier_balancement - p->dernier_arret) / MCU_CYCLES_PAR_MS : 0.0);
+	printf("    \"gripper\": {\"width_us\": %u, \"moves\": %u},\n", p->pince_us, p->pince_mouvements);
+	printf("    \"boot\": {");
+	print_boot_ms("uart_ms", BOOT_UART, ", ");
+	print_boot_ms("command_ms", BOOT_COMMANDE, ", ");
+	print_boot_ms("pwm_ms", BOOT_MLI, ", ");
+	print_boot_ms("lcd_ms", BOOT_LCD, "},\n");
+	printf("    \"watchdog_timeouts\": %u,\n", m->watchdog);
+	printf("    \"interrupts\": %u,\n", m->interrupts);
+	printf("    \"sleep_pct\": %.1f,\n", (cycles != 0) ? 100.0 * m->sleep_cycles / cycles : 0.0);
+	printf("    \"uart\": {\"rx\": %u, \"tx\": %u, \"overrun\": %u, \"text\": ",
+		m->rx_bytes, m->tx_bytes, m->rx_overrun);
+	mcu_print_tx(stdout);
+	printf("}\n");
+	printf("  }");
+}
+
+
+static void print_boot_ms(const char* nom, boot_step_e etape, const char* fin){
+
+	uint32_t instant = boot_get_us(etape);
+
+	if(instant == BOOT_JAMAIS){
+
+		printf("\"%s\": null%s", nom, fin);
+	}
+
+	else{
+
+		printf("\"%s\": %.2f%s", nom, instant / 1000.0, fin);
+	}
+}
+
+
+/* Première commande valide et première MLI sous leur limite (-d) */
+static bool boot_ok(const char* chemin){
+
+	uint32_t commande = boot_get_us(BOOT_COMMANDE);
+	uint32_t mli = boot_get_us(BOOT_MLI);
+	bool ok = TRUE;
+
+	if((commande == BOOT_JAMAIS) || (commande > DEMARRAGE_COMMANDE_MAX_MS * 1000UL)){
+
+		fprintf(stderr, "%s: première commande valide après %d ms\n", chemin, DEMARRAGE_COMMANDE_MAX_MS);
+		ok = FALSE;
+	}
+
+	if((mli == BOOT_JAMAIS) || (mli > DEMARRAGE_MLI_MAX_MS * 1000UL)){
+
+		fprintf(stderr, "%s: première MLI après %d ms\n", chemin, DEMARRAGE_MLI_MAX_MS);
+		ok = FALSE;
+	}
+
+	return ok;
+}